@@ -0,0 +1,12 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+/**
+ * Counts calls to the global operator new (which std containers go through as
+ * well), so the debug overlay can show heap allocations per fixed step. The
+ * replacement operators live in AllocationCounter.cpp and just forward to
+ * malloc/free.
+ */
+unsigned long long getAllocationCount();
+
+#endif // ALLOCATION_COUNTER_H
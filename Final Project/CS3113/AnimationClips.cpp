@@ -0,0 +1,117 @@
+#include "AnimationClips.h"
+#include <algorithm>
+#include <deque>
+
+struct ClipRange
+{
+    int first; // into gFrames
+    int count;
+};
+
+struct WalkSet
+{
+    std::map<Direction, std::vector<int>> atlas;
+    int clips[DOWN + 1];
+};
+
+struct AttackSet
+{
+    std::map<EntityState, std::vector<int>> atlas;
+    int clips[ATTACK + 1];
+};
+
+// Every clip's frames back to back. Sets live in deques so the atlas
+// references handed out by walkAtlas/attackAtlas survive later interns.
+static std::vector<int>       gFrames;
+static std::vector<ClipRange> gClips;
+static std::deque<WalkSet>    gWalkSets;
+static std::deque<AttackSet>  gAttackSets;
+
+static const std::map<Direction, std::vector<int>>   gNoWalkAtlas;
+static const std::map<EntityState, std::vector<int>> gNoAttackAtlas;
+
+/**
+ * @brief Registers a run of frame numbers, reusing an identical clip if there
+ * is one, so directions that share frames also share a clip ID.
+ */
+static int internClip(const std::vector<int> &frames)
+{
+    if (frames.empty()) return AnimationClips::NO_CLIP;
+
+    for (size_t i = 0; i < gClips.size(); i++)
+    {
+        const ClipRange &clip = gClips[i];
+        if (clip.count == (int) frames.size() &&
+            std::equal(frames.begin(), frames.end(), gFrames.begin() + clip.first))
+            return (int) i;
+    }
+
+    gClips.push_back({ (int) gFrames.size(), (int) frames.size() });
+    gFrames.insert(gFrames.end(), frames.begin(), frames.end());
+    return (int) gClips.size() - 1;
+}
+
+int AnimationClips::internWalkSet(const std::map<Direction, std::vector<int>> &atlas)
+{
+    if (atlas.empty()) return NO_CLIP;
+
+    for (size_t i = 0; i < gWalkSets.size(); i++)
+        if (gWalkSets[i].atlas == atlas) return (int) i;
+
+    WalkSet set;
+    set.atlas = atlas;
+    for (int &clip : set.clips) clip = NO_CLIP;
+    for (auto &entry : atlas) set.clips[entry.first] = internClip(entry.second);
+
+    gWalkSets.push_back(set);
+    return (int) gWalkSets.size() - 1;
+}
+
+int AnimationClips::internAttackSet(const std::map<EntityState, std::vector<int>> &atlas)
+{
+    if (atlas.empty()) return NO_CLIP;
+
+    for (size_t i = 0; i < gAttackSets.size(); i++)
+        if (gAttackSets[i].atlas == atlas) return (int) i;
+
+    AttackSet set;
+    set.atlas = atlas;
+    for (int &clip : set.clips) clip = NO_CLIP;
+    for (auto &entry : atlas) set.clips[entry.first] = internClip(entry.second);
+
+    gAttackSets.push_back(set);
+    return (int) gAttackSets.size() - 1;
+}
+
+int AnimationClips::walkClip(int walkSet, Direction direction)
+{
+    return walkSet == NO_CLIP ? NO_CLIP : gWalkSets[walkSet].clips[direction];
+}
+
+int AnimationClips::attackClip(int attackSet, EntityState state)
+{
+    return attackSet == NO_CLIP ? NO_CLIP : gAttackSets[attackSet].clips[state];
+}
+
+const std::map<Direction, std::vector<int>> &AnimationClips::walkAtlas(int walkSet)
+{
+    return walkSet == NO_CLIP ? gNoWalkAtlas : gWalkSets[walkSet].atlas;
+}
+
+const std::map<EntityState, std::vector<int>> &AnimationClips::attackAtlas(int attackSet)
+{
+    return attackSet == NO_CLIP ? gNoAttackAtlas : gAttackSets[attackSet].atlas;
+}
+
+const int *AnimationClips::frames(int clip)
+{
+    return clip == NO_CLIP ? nullptr : gFrames.data() + gClips[clip].first;
+}
+
+int AnimationClips::frameCount(int clip)
+{
+    return clip == NO_CLIP ? 0 : gClips[clip].count;
+}
+
+int AnimationClips::getClipCount() { return (int) gClips.size(); }
+int AnimationClips::getSetCount()  { return (int) (gWalkSets.size() + gAttackSets.size()); }
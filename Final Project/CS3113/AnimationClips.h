@@ -0,0 +1,46 @@
+#include <map>
+#include <vector>
+
+#ifndef ANIMATION_CLIPS_H
+#define ANIMATION_CLIPS_H
+
+enum Direction    { LEFT, UP, RIGHT, DOWN      }; // For walking
+enum EntityState  { WALK, WAIT, ATTACK              };
+
+/**
+ * Process-wide, append-only registry of animation clips (runs of atlas frame
+ * numbers). A level's walk or attack atlas is interned once into a set of
+ * clips, one per direction or state, and entities keep only the set and clip
+ * IDs: switching animation is an integer store rather than a vector copy, and
+ * a thousand enemies sharing one sheet share one copy of its frames.
+ *
+ * Interning an atlas equal to one already registered returns the existing ID,
+ * and nothing is ever removed, so an ID stays valid for the whole run and can
+ * be cached in a function-local static.
+ */
+class AnimationClips
+{
+public:
+    static constexpr int NO_CLIP = -1; // also "no set"
+
+    // Empty atlases intern to NO_CLIP
+    static int internWalkSet(const std::map<Direction, std::vector<int>> &atlas);
+    static int internAttackSet(const std::map<EntityState, std::vector<int>> &atlas);
+
+    // The set's clip for that key, or NO_CLIP if the atlas had none
+    static int walkClip(int walkSet, Direction direction);
+    static int attackClip(int attackSet, EntityState state);
+
+    // The atlas a set was interned from (empty for NO_CLIP)
+    static const std::map<Direction, std::vector<int>>   &walkAtlas(int walkSet);
+    static const std::map<EntityState, std::vector<int>> &attackAtlas(int attackSet);
+
+    // Frame numbers of a clip; the pointer is only good until the next intern
+    static const int *frames(int clip);
+    static int frameCount(int clip);
+
+    static int getClipCount();
+    static int getSetCount();
+};
+
+#endif // ANIMATION_CLIPS_H
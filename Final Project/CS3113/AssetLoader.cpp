@@ -0,0 +1,322 @@
+#include "AssetLoader.h"
+#include "TextureCache.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+enum AssetKind  { IMAGE_ASSET, WAVE_ASSET };
+enum AssetState { QUEUED, DECODING, READY };
+
+struct PendingAsset
+{
+    AssetKind  kind;
+    AssetState state;
+    Image      image;
+    Wave       wave;
+};
+
+// Keyed by path; map nodes never move, so the queues and the workers can
+// hold pointers to entries while other paths come and go
+typedef std::map<std::string, PendingAsset>::value_type AssetEntry;
+
+static std::map<std::string, PendingAsset> gAssets;
+static std::deque<AssetEntry*>             gQueue;       // waiting for a worker
+static std::deque<AssetEntry*>             gReadyImages; // waiting for upload
+
+// Guards everything above; workers only touch an entry's image or wave
+// after taking it off gQueue, and hand it back under the lock
+static std::mutex              gMutex;
+static std::condition_variable gWorkQueued;
+static std::condition_variable gAssetDecoded;
+static std::vector<std::thread> gWorkers;
+static bool gStopping = false;
+
+// Textures of the manifest last prefetched (uploaded here, or resident
+// already), each with one reference of the loader's own: the scene switch
+// that prefetches (into a title scene) purges before the level that uses them
+// acquires them. Main thread only
+static std::map<std::string, Texture2D> gHeldTextures;
+
+static int    gDecodingCount = 0;
+static int    gUploadedCount = 0;
+static size_t gWaveBytes     = 0;
+
+static void decode(AssetEntry *entry, Image *image, Wave *wave)
+{
+    if (entry->second.kind == IMAGE_ASSET) *image = loadImage(entry->first.c_str());
+    else                                   *wave  = loadWave(entry->first.c_str());
+}
+
+// Stores what decode() produced; called with the lock held
+static void finish(AssetEntry *entry, Image image, Wave wave)
+{
+    PendingAsset &asset = entry->second;
+    asset.state = READY;
+    gDecodingCount--;
+
+    if (asset.kind == IMAGE_ASSET)
+    {
+        asset.image = image;
+        gReadyImages.push_back(entry);
+    }
+    else
+    {
+        asset.wave = wave;
+        gWaveBytes += (size_t) wave.frameCount * wave.channels * wave.sampleSize / 8;
+    }
+
+    gAssetDecoded.notify_all();
+}
+
+static void work()
+{
+    std::unique_lock<std::mutex> lock(gMutex);
+
+    for (;;)
+    {
+        gWorkQueued.wait(lock, [] { return gStopping || !gQueue.empty(); });
+        if (gStopping) return;
+
+        AssetEntry *entry = gQueue.front();
+        gQueue.pop_front();
+        entry->second.state = DECODING;
+        gDecodingCount++;
+
+        lock.unlock();
+        Image image = { 0 };
+        Wave  wave  = { 0 };
+        decode(entry, &image, &wave);
+        lock.lock();
+
+        finish(entry, image, wave);
+    }
+}
+
+/**
+ * Looks the path up and makes sure it is decoded: still queued means it is
+ * decoded right here rather than behind the rest of the queue, and a worker
+ * already on it is waited for. Returns nullptr if the path was never queued
+ * as that kind of asset.
+ */
+static AssetEntry *await(const char *path, AssetKind kind,
+    std::unique_lock<std::mutex> &lock)
+{
+    auto found = gAssets.find(path);
+    if (found == gAssets.end() || found->second.kind != kind) return nullptr;
+
+    AssetEntry *entry = &*found;
+    if (entry->second.state == QUEUED)
+    {
+        gQueue.erase(std::find(gQueue.begin(), gQueue.end(), entry));
+        entry->second.state = DECODING;
+        gDecodingCount++;
+
+        lock.unlock();
+        Image image = { 0 };
+        Wave  wave  = { 0 };
+        decode(entry, &image, &wave);
+        lock.lock();
+
+        finish(entry, image, wave);
+    }
+
+    gAssetDecoded.wait(lock, [entry] { return entry->second.state == READY; });
+    return entry;
+}
+
+static void hold(const std::string &path)
+{
+    if (gHeldTextures.count(path)) return;
+
+    Texture2D texture = TextureCache::acquire(path.c_str()); // resident: no load
+    if (texture.id != 0) gHeldTextures[path] = texture;
+}
+
+static void releaseHeld(const std::vector<std::string> &keep)
+{
+    for (auto held = gHeldTextures.begin(); held != gHeldTextures.end();)
+    {
+        if (std::find(keep.begin(), keep.end(), held->first) != keep.end())
+        {
+            ++held;
+            continue;
+        }
+
+        TextureCache::release(held->second);
+        held = gHeldTextures.erase(held);
+    }
+}
+
+void AssetLoader::start(int workerCount)
+{
+    if (!gWorkers.empty()) return;
+
+    if (workerCount <= 0)
+    {
+        workerCount = (int) std::thread::hardware_concurrency() - 1;
+        workerCount = workerCount < 1 ? 1 : (workerCount > 4 ? 4 : workerCount);
+    }
+
+    gStopping = false;
+    for (int i = 0; i < workerCount; i++) gWorkers.push_back(std::thread(work));
+}
+
+void AssetLoader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        gStopping = true;
+    }
+    gWorkQueued.notify_all();
+
+    for (std::thread &worker : gWorkers) worker.join();
+    gWorkers.clear();
+
+    for (auto &asset : gAssets)
+    {
+        if (asset.second.state != READY) continue;
+        if (asset.second.kind == IMAGE_ASSET) UnloadImage(asset.second.image);
+        else                                  UnloadWave(asset.second.wave);
+    }
+
+    releaseHeld(std::vector<std::string>());
+    gAssets.clear();
+    gQueue.clear();
+    gReadyImages.clear();
+    gDecodingCount = 0;
+    gWaveBytes     = 0;
+}
+
+void AssetLoader::prefetch(const AssetManifest &manifest)
+{
+    if (gWorkers.empty()) return;
+
+    // nothing would use them: no GL context to upload to, no audio device
+    bool wantTextures = IsWindowReady();
+    bool wantSounds   = IsAudioDeviceReady();
+
+    // the atlas pages, and only the sheets the atlas does not pack
+    std::vector<std::string> images;
+    if (wantTextures) images = SpriteAtlas::imagePaths(manifest.atlas, manifest.sheets);
+
+    // only one manifest is held for at a time; what is resident already is
+    // held as it is, so the next purge cannot drop it either
+    releaseHeld(images);
+    for (const std::string &path : images)
+        if (TextureCache::isCached(path.c_str())) hold(path);
+
+    std::lock_guard<std::mutex> lock(gMutex);
+
+    for (const std::string &path : images)
+    {
+        if (TextureCache::isCached(path.c_str()) || gAssets.count(path)) continue;
+
+        AssetEntry *entry = &*gAssets.insert(std::make_pair(path,
+            PendingAsset { IMAGE_ASSET, QUEUED, { 0 }, { 0 } })).first;
+        gQueue.push_back(entry);
+    }
+
+    for (const char *path : manifest.sounds)
+    {
+        if (!wantSounds || gAssets.count(path)) continue;
+
+        AssetEntry *entry = &*gAssets.insert(std::make_pair(std::string(path),
+            PendingAsset { WAVE_ASSET, QUEUED, { 0 }, { 0 } })).first;
+        gQueue.push_back(entry);
+    }
+
+    gWorkQueued.notify_all();
+}
+
+void AssetLoader::upload(double budgetSeconds)
+{
+    double start = GetTime();
+
+    for (int uploaded = 0; uploaded == 0 || GetTime() - start < budgetSeconds; uploaded++)
+    {
+        std::string path;
+        Image image;
+        {
+            std::lock_guard<std::mutex> lock(gMutex);
+            if (gReadyImages.empty()) return;
+
+            AssetEntry *entry = gReadyImages.front();
+            gReadyImages.pop_front();
+            path  = entry->first;
+            image = entry->second.image;
+            gAssets.erase(path);
+        }
+
+        // a scene may have needed it first and loaded it itself
+        if (image.data != nullptr && !TextureCache::isCached(path.c_str()))
+        {
+            TextureCache::insert(path.c_str(), LoadTextureFromImage(image));
+            hold(path);
+            gUploadedCount++;
+        }
+        UnloadImage(image);
+    }
+}
+
+void AssetLoader::release(const AssetManifest &manifest)
+{
+    if (gHeldTextures.empty()) return;
+
+    std::vector<std::string> images = SpriteAtlas::imagePaths(manifest.atlas, manifest.sheets);
+    for (const std::string &path : images)
+    {
+        auto held = gHeldTextures.find(path);
+        if (held == gHeldTextures.end()) continue;
+
+        TextureCache::release(held->second);
+        gHeldTextures.erase(held);
+    }
+}
+
+bool AssetLoader::takeImage(const char *path, Image *image)
+{
+    if (gWorkers.empty()) return false;
+
+    std::unique_lock<std::mutex> lock(gMutex);
+    AssetEntry *entry = await(path, IMAGE_ASSET, lock);
+    if (entry == nullptr) return false;
+
+    *image = entry->second.image;
+    gReadyImages.erase(std::find(gReadyImages.begin(), gReadyImages.end(), entry));
+    gAssets.erase(gAssets.find(entry->first));
+    return true;
+}
+
+bool AssetLoader::findWave(const char *path, Wave *wave)
+{
+    if (gWorkers.empty()) return false;
+
+    std::unique_lock<std::mutex> lock(gMutex);
+    AssetEntry *entry = await(path, WAVE_ASSET, lock);
+    if (entry == nullptr) return false;
+
+    *wave = entry->second.wave;
+    return true;
+}
+
+int AssetLoader::getPendingCount()
+{
+    std::lock_guard<std::mutex> lock(gMutex);
+    return (int) gQueue.size() + gDecodingCount;
+}
+
+int AssetLoader::getReadyCount()
+{
+    std::lock_guard<std::mutex> lock(gMutex);
+    return (int) gReadyImages.size();
+}
+
+int    AssetLoader::getUploadedCount() { return gUploadedCount; }
+
+size_t AssetLoader::getWaveBytes()
+{
+    std::lock_guard<std::mutex> lock(gMutex);
+    return gWaveBytes;
+}
@@ -0,0 +1,69 @@
+#include "cs3113.h"
+#include "SpriteAtlas.h"
+
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+/**
+ * What a scene needs resident before it can run without touching the disk:
+ * every sheet it may spawn (with the grid it is cut on) and every sound it
+ * loads. Its music is listed for the asset packer's working-set report only;
+ * streams are never prefetched. `atlas` names the frame table `make atlas`
+ * packs the sheets into; when it exists its pages stand in for the sheets.
+ */
+struct AssetManifest
+{
+    std::vector<SpriteSheet> sheets;
+    std::vector<const char*> sounds;
+    std::vector<const char*> music;
+    const char *atlas;
+};
+
+/**
+ * Background asset loading. `prefetch` queues a manifest's PNGs and WAVs for
+ * worker threads to decode into CPU memory; only the GPU upload of decoded
+ * images happens on the main thread, a few per frame within the budget given
+ * to `upload`, after which the texture sits in TextureCache. The loader
+ * keeps a reference to each texture of the manifest it last prefetched
+ * (including those resident already), so the purge of the scene switch in
+ * between (a title scene prefetches for the level after it) keeps them; the
+ * level drops that reference with `release` once it holds its own.
+ *
+ * TextureCache and loadSound ask here before going to disk: a prefetched
+ * asset is handed over as soon as it is decoded (waiting for it if a worker
+ * is still on it), so a scene switch that catches the loader mid-way only
+ * pays for what is left. Without `start` (benchmarks, headless runs) nothing
+ * is queued and everything loads synchronously as before.
+ */
+class AssetLoader
+{
+public:
+    // Spawns the workers; 0 picks one per spare hardware thread, at most 4
+    static void start(int workerCount = 0);
+    // Joins the workers and frees whatever was decoded but never used
+    static void stop();
+
+    // Queues every asset of the manifest that is not resident or queued yet
+    static void prefetch(const AssetManifest &manifest);
+    // Main thread, once per frame: uploads decoded images to the GPU until
+    // the budget is spent (at least one, so the queue always drains)
+    static void upload(double budgetSeconds);
+
+    // Drops the loader's references to the manifest's textures; called by a
+    // scene once it has acquired them (Scene::preloadManifest)
+    static void release(const AssetManifest &manifest);
+
+    // Hands over the decoded image if the path was prefetched; the caller
+    // owns (and unloads) it. False if it was never queued
+    static bool takeImage(const char *path, Image *image);
+    // The decoded wave if the path was prefetched. It stays owned by the
+    // loader, so every LoadSoundFromWave of it skips the decode
+    static bool findWave(const char *path, Wave *wave);
+
+    static int    getPendingCount();  // queued or decoding
+    static int    getReadyCount();    // decoded images waiting for upload
+    static int    getUploadedCount(); // uploaded by `upload` so far
+    static size_t getWaveBytes();     // decoded waves held
+};
+
+#endif // ASSET_LOADER_H
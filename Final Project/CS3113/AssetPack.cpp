@@ -0,0 +1,221 @@
+#include "AssetPack.h"
+#include <cstdio>
+#include <cstring>
+
+static const char     MAGIC[4]   = { 'A', 'P', 'A', 'K' };
+static const uint32_t VERSION    = 1;
+static const size_t   DATA_ALIGN = 64;
+
+// The format is little-endian and so is every platform this game builds for
+// (x86 and ARM), so records are read and written as-is.
+struct PackHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t entryCount;
+    uint64_t stringsOffset;
+    uint64_t stringsBytes;
+};
+
+struct PackSlot
+{
+    uint64_t pathHash;
+    uint64_t offset;
+    uint64_t bytes;
+    uint32_t pathOffset;
+    uint32_t pathBytes; // 0: empty slot
+};
+
+static_assert(sizeof(PackHeader) == 32 && sizeof(PackSlot) == 32,
+    "archive records must have no padding");
+
+static size_t alignData(size_t offset)
+{
+    return (offset + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+}
+
+uint64_t AssetPack::hashPath(const char *path, size_t length)
+{
+    uint64_t hash = 1469598103934665603ULL;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char) path[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static bool writePadding(FILE *archive, size_t bytes)
+{
+    static const char zeros[DATA_ALIGN] = { 0 };
+    return bytes == 0 || fwrite(zeros, 1, bytes, archive) == bytes;
+}
+
+bool AssetPack::write(const char *archivePath, const std::vector<std::string> &filePaths)
+{
+    uint32_t slotCount = 16; // at most half full, so probes stay short
+    while (slotCount < filePaths.size() * 2) slotCount <<= 1;
+
+    std::vector<PackSlot> slots(slotCount);
+    memset(slots.data(), 0, slots.size() * sizeof(PackSlot));
+    std::vector<size_t> slotOfFile;
+    std::string strings;
+
+    // The directory goes first, so every file's size is needed up front
+    for (const std::string &path : filePaths)
+    {
+        FILE *file = path.empty() ? nullptr : fopen(path.c_str(), "rb");
+        if (file == nullptr) return false;
+        fseek(file, 0, SEEK_END);
+        long bytes = ftell(file);
+        fclose(file);
+        if (bytes < 0) return false;
+
+        uint64_t hash = hashPath(path.c_str(), path.size());
+        size_t slot = hash & (slotCount - 1);
+        while (slots[slot].pathBytes != 0)
+        {
+            if (slots[slot].pathHash == hash && slots[slot].pathBytes == path.size() &&
+                strings.compare(slots[slot].pathOffset, path.size(), path) == 0)
+                return false; // listed twice
+
+            slot = (slot + 1) & (slotCount - 1);
+        }
+
+        slots[slot].pathHash   = hash;
+        slots[slot].bytes      = (uint64_t) bytes;
+        slots[slot].pathOffset = (uint32_t) strings.size();
+        slots[slot].pathBytes  = (uint32_t) path.size();
+        strings += path;
+        slotOfFile.push_back(slot);
+    }
+
+    PackHeader header;
+    memcpy(header.magic, MAGIC, 4);
+    header.version       = VERSION;
+    header.slotCount     = slotCount;
+    header.entryCount    = (uint32_t) filePaths.size();
+    header.stringsOffset = sizeof(PackHeader) + slots.size() * sizeof(PackSlot);
+    header.stringsBytes  = strings.size();
+
+    size_t offset = alignData(header.stringsOffset + header.stringsBytes);
+    for (size_t slot : slotOfFile)
+    {
+        slots[slot].offset = offset;
+        offset = alignData(offset + slots[slot].bytes);
+    }
+
+    FILE *archive = fopen(archivePath, "wb");
+    if (archive == nullptr) return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, archive) == 1 &&
+              fwrite(slots.data(), sizeof(PackSlot), slots.size(), archive) == slots.size() &&
+              fwrite(strings.data(), 1, strings.size(), archive) == strings.size();
+
+    size_t written = header.stringsOffset + header.stringsBytes;
+    std::vector<char> buffer(1 << 16);
+
+    for (size_t i = 0; i < filePaths.size() && ok; i++)
+    {
+        const PackSlot &slot = slots[slotOfFile[i]];
+        ok = writePadding(archive, slot.offset - written);
+
+        FILE *file = fopen(filePaths[i].c_str(), "rb");
+        uint64_t copied = 0;
+        size_t count;
+        while (ok && file != nullptr && (count = fread(buffer.data(), 1, buffer.size(), file)) > 0)
+        {
+            ok = fwrite(buffer.data(), 1, count, archive) == count;
+            copied += count;
+        }
+        if (file != nullptr) fclose(file);
+
+        ok = ok && copied == slot.bytes; // changed since it was measured
+        written = slot.offset + slot.bytes;
+    }
+
+    ok = ok && writePadding(archive, alignData(written) - written);
+    if (fclose(archive) != 0) ok = false;
+    if (!ok) remove(archivePath);
+    return ok;
+}
+
+AssetPack::~AssetPack() { close(); }
+
+bool AssetPack::open(const char *archivePath)
+{
+    close();
+
+    if (!mMapping.open(archivePath)) return false;
+    const unsigned char *data = mMapping.getData();
+    size_t size = mMapping.getSize();
+
+    PackHeader header;
+    bool valid = size >= sizeof(PackHeader);
+    if (valid) memcpy(&header, data, sizeof(header));
+
+    valid = valid && memcmp(header.magic, MAGIC, 4) == 0 && header.version == VERSION &&
+            header.slotCount > 0 && (header.slotCount & (header.slotCount - 1)) == 0 &&
+            header.stringsOffset == sizeof(PackHeader) + (uint64_t) header.slotCount * sizeof(PackSlot) &&
+            header.stringsOffset + header.stringsBytes <= size;
+
+    // every path and payload must lie inside the file, so reads never fault
+    const PackSlot *slots = (const PackSlot *) (data + sizeof(PackHeader));
+    uint32_t entries = 0;
+    for (uint32_t i = 0; valid && i < header.slotCount; i++)
+    {
+        if (slots[i].pathBytes == 0) continue;
+
+        entries++;
+        valid = (uint64_t) slots[i].pathOffset + slots[i].pathBytes <= header.stringsBytes &&
+                slots[i].offset >= header.stringsOffset + header.stringsBytes &&
+                slots[i].offset <= size && slots[i].bytes <= size - slots[i].offset;
+    }
+
+    if (!valid || entries != header.entryCount || entries == header.slotCount)
+    {
+        close();
+        return false;
+    }
+
+    mSlots      = (const unsigned char *) slots;
+    mStrings    = (const char *) (data + header.stringsOffset);
+    mSlotCount  = header.slotCount;
+    mEntryCount = header.entryCount;
+    return true;
+}
+
+void AssetPack::close()
+{
+    mMapping.close();
+    mSlots = nullptr;
+    mStrings = nullptr;
+    mSlotCount = mEntryCount = 0;
+}
+
+bool AssetPack::find(const char *path, const unsigned char **data, size_t *size) const
+{
+    if (!mMapping.isOpen() || path == nullptr) return false;
+
+    size_t   length = strlen(path);
+    uint64_t hash   = hashPath(path, length);
+    const PackSlot *slots = (const PackSlot *) mSlots;
+
+    // open() made sure at least one slot is empty, so this terminates
+    for (uint32_t i = hash & (mSlotCount - 1);; i = (i + 1) & (mSlotCount - 1))
+    {
+        const PackSlot &slot = slots[i];
+        if (slot.pathBytes == 0) return false;
+
+        if (slot.pathHash == hash && slot.pathBytes == length &&
+            memcmp(mStrings + slot.pathOffset, path, length) == 0)
+        {
+            *data = mMapping.getData() + slot.offset;
+            *size = (size_t) slot.bytes;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+/**
+ * Read-only view of an asset archive (".pak"): every file under assets/ in
+ * one memory-mapped file, found by path through a hashed directory. Opening
+ * the game's assets is then one open() instead of one per sheet and sound,
+ * and a lookup hands out a pointer straight into the mapping, which raylib's
+ * Load*FromMemory functions decode without another copy.
+ *
+ * Layout (all integers little-endian):
+ *
+ *     header     "APAK", version, slot count, entry count  (4 x uint32)
+ *                strings offset, strings bytes             (2 x uint64)
+ *     slots      open-addressed hash table, slot count a power of two:
+ *                path hash, data offset, data bytes        (3 x uint64)
+ *                path offset, path bytes                   (2 x uint32)
+ *                (path bytes 0 for an empty slot)
+ *     strings    the paths, unterminated
+ *     data       the files, each starting on a 64-byte boundary
+ *
+ * Paths are stored exactly as the game asks for them ("assets/hero/...").
+ * `make pack` writes the archive with tools/AssetPacker.cpp.
+ */
+class AssetPack
+{
+private:
+    MappedFile           mMapping; // whole file, read-only
+    const unsigned char *mSlots = nullptr;
+    const char          *mStrings = nullptr;
+    uint32_t             mSlotCount  = 0;
+    uint32_t             mEntryCount = 0;
+
+public:
+    // Writes every file in `filePaths` (stored under the same path) into one
+    // archive. Fails on I/O errors or duplicate paths
+    static bool write(const char *archivePath, const std::vector<std::string> &filePaths);
+    // 64-bit FNV-1a, the directory's hash
+    static uint64_t hashPath(const char *path, size_t length);
+
+    AssetPack() = default;
+    ~AssetPack();
+    AssetPack(const AssetPack &) = delete;
+    AssetPack &operator=(const AssetPack &) = delete;
+
+    // Maps the archive and validates its header and directory
+    bool open(const char *archivePath);
+    void close();
+    bool isOpen() const { return mMapping.isOpen(); }
+
+    // Points `data` at the file's bytes inside the mapping; valid until
+    // close(). Safe to call from any thread while the archive is open
+    bool find(const char *path, const unsigned char **data, size_t *size) const;
+
+    int    getEntryCount() const { return (int) mEntryCount;  }
+    size_t getFileBytes()  const { return mMapping.getSize(); }
+};
+
+#endif // ASSET_PACK_H
@@ -0,0 +1,136 @@
+#include "EnemyIndex.h"
+#include <algorithm>
+
+void EnemyIndex::build(EntityView entities)
+{
+    mPoints.clear();
+
+    for (Entity *entity : entities)
+    {
+        if (entity == nullptr || entity->getEntityType() != NPC) continue;
+        if (entity->isDead()) continue;
+
+        Vector2 position = entity->getPosition();
+        Point point = { position.x, position.y, entity };
+        mPoints.push_back(point);
+    }
+
+    buildRange(0, (int) mPoints.size(), 0);
+    mBuilt = true;
+}
+
+void EnemyIndex::buildRange(int begin, int end, int axis)
+{
+    if (end - begin <= 1) return;
+
+    int middle = begin + (end - begin) / 2;
+
+    // partial sort: the median lands in the middle, smaller on the left
+    std::nth_element(mPoints.begin() + begin, mPoints.begin() + middle,
+        mPoints.begin() + end, [axis](const Point &a, const Point &b)
+        {
+            return axis == 0 ? a.x < b.x : a.y < b.y;
+        });
+
+    buildRange(begin, middle, axis ^ 1);
+    buildRange(middle + 1, end, axis ^ 1);
+}
+
+void EnemyIndex::searchNearest(int begin, int end, int axis, Vector2 position,
+    float &bestDistanceSquared, Entity *&best) const
+{
+    if (begin >= end) return;
+
+    int middle = begin + (end - begin) / 2;
+    const Point &node = mPoints[middle];
+
+    float dx = position.x - node.x;
+    float dy = position.y - node.y;
+    float distanceSquared = dx * dx + dy * dy;
+
+    if (distanceSquared < bestDistanceSquared && !node.entity->isDead())
+    {
+        bestDistanceSquared = distanceSquared;
+        best = node.entity;
+    }
+
+    float split = axis == 0 ? dx : dy;
+
+    // visit our side of the split first; the other side only matters if
+    // the splitting line is closer than the best hit so far
+    if (split < 0.0f)
+    {
+        searchNearest(begin, middle, axis ^ 1, position, bestDistanceSquared, best);
+        if (split * split < bestDistanceSquared)
+            searchNearest(middle + 1, end, axis ^ 1, position, bestDistanceSquared, best);
+    }
+    else
+    {
+        searchNearest(middle + 1, end, axis ^ 1, position, bestDistanceSquared, best);
+        if (split * split < bestDistanceSquared)
+            searchNearest(begin, middle, axis ^ 1, position, bestDistanceSquared, best);
+    }
+}
+
+void EnemyIndex::searchNearest(int begin, int end, int axis, Vector2 position,
+    size_t count, float maxDistanceSquared)
+{
+    if (begin >= end) return;
+
+    int middle = begin + (end - begin) / 2;
+    const Point &node = mPoints[middle];
+
+    float dx = position.x - node.x;
+    float dy = position.y - node.y;
+    float distanceSquared = dx * dx + dy * dy;
+
+    // mHeap is a max-heap on distance holding the best `count` so far
+    float radius = mHeap.size() < count ? maxDistanceSquared : mHeap.front().first;
+
+    if (distanceSquared < radius && !node.entity->isDead())
+    {
+        if (mHeap.size() == count)
+        {
+            std::pop_heap(mHeap.begin(), mHeap.end());
+            mHeap.pop_back();
+        }
+        mHeap.push_back(Candidate(distanceSquared, node.entity));
+        std::push_heap(mHeap.begin(), mHeap.end());
+    }
+
+    float split = axis == 0 ? dx : dy;
+    int nearBegin = split < 0.0f ? begin      : middle + 1;
+    int nearEnd   = split < 0.0f ? middle     : end;
+    int farBegin  = split < 0.0f ? middle + 1 : begin;
+    int farEnd    = split < 0.0f ? end        : middle;
+
+    searchNearest(nearBegin, nearEnd, axis ^ 1, position, count, maxDistanceSquared);
+
+    radius = mHeap.size() < count ? maxDistanceSquared : mHeap.front().first;
+    if (split * split < radius)
+        searchNearest(farBegin, farEnd, axis ^ 1, position, count, maxDistanceSquared);
+}
+
+Entity *EnemyIndex::nearest(Vector2 position, float maxDistance) const
+{
+    Entity *best = nullptr;
+    float bestDistanceSquared = maxDistance * maxDistance;
+
+    searchNearest(0, (int) mPoints.size(), 0, position, bestDistanceSquared, best);
+    return best;
+}
+
+void EnemyIndex::nearest(Vector2 position, int count, float maxDistance,
+    std::vector<Entity*> &out)
+{
+    out.clear();
+    if (count <= 0) return;
+
+    mHeap.clear();
+    searchNearest(0, (int) mPoints.size(), 0, position, (size_t) count,
+        maxDistance * maxDistance);
+
+    // sort_heap leaves the max-heap in ascending order
+    std::sort_heap(mHeap.begin(), mHeap.end());
+    for (const Candidate &candidate : mHeap) out.push_back(candidate.second);
+}
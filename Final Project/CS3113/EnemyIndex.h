@@ -0,0 +1,51 @@
+#include "Entity.h"
+
+#ifndef ENEMY_INDEX_H
+#define ENEMY_INDEX_H
+
+/**
+ * 2-d tree over the positions of live enemies (NPCs that are not dead), for
+ * "closest enemy" targeting. Built in O(n log n) from the collidable list and
+ * answers nearest-1 and nearest-k in roughly O(log n) per result.
+ *
+ * The tree stores entity pointers, so it is only valid until an entity is
+ * deleted; scenes call `invalidate()` at the start of each update and after
+ * every sweep that frees enemies, and the next query rebuilds it. Enemies that
+ * die after the build are skipped at query time.
+ */
+class EnemyIndex
+{
+private:
+    struct Point
+    {
+        float   x, y;
+        Entity *entity;
+    };
+
+    typedef std::pair<float, Entity*> Candidate; // squared distance, enemy
+
+    std::vector<Point>     mPoints; // implicit tree: each range's middle is its node
+    std::vector<Candidate> mHeap;   // scratch for nearest-k
+    bool mBuilt = false;
+
+    void buildRange(int begin, int end, int axis);
+    void searchNearest(int begin, int end, int axis, Vector2 position,
+        float &bestDistanceSquared, Entity *&best) const;
+    void searchNearest(int begin, int end, int axis, Vector2 position,
+        size_t count, float maxDistanceSquared);
+
+public:
+    void build(EntityView entities);
+    void invalidate() { mBuilt = false; mPoints.clear(); }
+
+    // Closest live enemy strictly within maxDistance, or nullptr.
+    Entity *nearest(Vector2 position, float maxDistance) const;
+    // Up to `count` live enemies strictly within maxDistance, closest first.
+    void nearest(Vector2 position, int count, float maxDistance,
+        std::vector<Entity*> &out);
+
+    bool isBuilt() const { return mBuilt;               }
+    int  getSize() const { return (int) mPoints.size(); }
+};
+
+#endif // ENEMY_INDEX_H
@@ -1,43 +1,138 @@
 #include "Entity.h"
+#include "SpriteBatch.h"
 #include <cmath>
 
-Entity::Entity() : mPosition {0.0f, 0.0f}, mMovement {0.0f, 0.0f}, 
-                   mVelocity {0.0f, 0.0f}, mAcceleration {0.0f, 0.0f},
+Entity::Entity() : mAcceleration {0.0f, 0.0f},
                    mScale {DEFAULT_SIZE, DEFAULT_SIZE},
                    mColliderDimensions {DEFAULT_SIZE, DEFAULT_SIZE}, 
-                   mTexture {NULL}, mTextureType {SINGLE}, mAngle {0.0f},
+                   mTextureType {SINGLE}, mAngle {0.0f},
                    mSpriteSheetDimensions {}, mDirection {RIGHT}, 
-                   mWalkAnimations {{}}, mAnimationIndices {}, mFrameSpeed {0},
                    mEntityType {NONE},mIsCollidingBottom(false),
                    mAIType{WANDERER}, mAIState{IDLE}, mOwner(NULL){ }
 
 Entity::Entity(Vector2 position, Vector2 scale, const char *textureFilepath, 
-    EntityType entityType) : mPosition {position}, mVelocity {0.0f, 0.0f}, 
-    mAcceleration {0.0f, 0.0f}, mScale {scale}, mMovement {0.0f, 0.0f}, 
-    mColliderDimensions {scale}, mTexture {LoadTexture(textureFilepath)}, 
-    mTextureType {SINGLE}, mDirection {RIGHT}, mWalkAnimations {{}}, 
-    mAnimationIndices {}, mFrameSpeed {0}, mSpeed {DEFAULT_SPEED}, 
+    EntityType entityType) : 
+    mAcceleration {0.0f, 0.0f}, mScale {scale}, 
+    mColliderDimensions {scale}, mTextureType {SINGLE}, mDirection {RIGHT}, 
     mAngle {0.0f}, mEntityType {entityType}, mOriginalPos(position),
-    mIsCollidingBottom(false),mAIType{WANDERER}, mAIState{IDLE}, mOwner(NULL) { }
+    mIsCollidingBottom(false),mAIType{WANDERER}, mAIState{IDLE}, mOwner(NULL) 
+{
+    findSheet(textureFilepath);
+    this->position() = position;
+    speed() = DEFAULT_SPEED;
+}
 
 Entity::Entity(Vector2 position, Vector2 scale, const char *textureFilepath, 
         TextureType textureType, Vector2 spriteSheetDimensions, std::map<Direction, 
         std::vector<int>> animationAtlas, EntityType entityType) : 
-        mPosition {position}, mVelocity {0.0f, 0.0f}, 
-        mAcceleration {0.0f, 0.0f}, mMovement { 0.0f, 0.0f }, mScale {scale},
-        mColliderDimensions {scale}, mTexture {LoadTexture(textureFilepath)}, 
-        mTextureType {ATLAS}, mSpriteSheetDimensions {spriteSheetDimensions},
-        mWalkAnimations {animationAtlas}, mDirection {RIGHT},
-        mAnimationIndices {animationAtlas.at(RIGHT)}, 
-        mFrameSpeed {DEFAULT_FRAME_SPEED}, mAngle { 0.0f }, 
-        mSpeed { DEFAULT_SPEED }, mEntityType {entityType}, mOriginalPos(position),
-        mIsCollidingBottom(false), mAIType{WANDERER}, mAIState{IDLE}, mOwner(NULL){ }
-
-Entity::~Entity() { UnloadTexture(mTexture); };
-
-void Entity::checkCollisionY(std::vector<Entity*> collidableEntities)
+        Entity(position, scale, textureFilepath, textureType, spriteSheetDimensions,
+            AnimationClips::internWalkSet(animationAtlas), entityType) { }
+
+Entity::Entity(Vector2 position, Vector2 scale, const char *textureFilepath, 
+        TextureType textureType, Vector2 spriteSheetDimensions, int walkSet, 
+        EntityType entityType) : 
+        mAcceleration {0.0f, 0.0f}, mScale {scale},
+        mColliderDimensions {scale}, mTextureType {ATLAS}, 
+        mSpriteSheetDimensions {spriteSheetDimensions},
+        mWalkSet {walkSet}, mDirection {RIGHT},
+        mAngle { 0.0f }, 
+        mEntityType {entityType}, mOriginalPos(position),
+        mIsCollidingBottom(false), mAIType{WANDERER}, mAIState{IDLE}, mOwner(NULL)
+{
+    findSheet(textureFilepath);
+    this->position() = position;
+    speed()      = DEFAULT_SPEED;
+    frameSpeed() = DEFAULT_FRAME_SPEED;
+    setClip(AnimationClips::walkClip(mWalkSet, RIGHT));
+}
+
+Entity::~Entity() 
+{ 
+    EntityStore::release(mSlot);
+}
+
+// The sheet the texture type and grid cut the file into; SpriteAtlas holds
+// its texture, so there is nothing to release when it changes
+void Entity::findSheet(const char *textureFilepath)
+{
+    if (mTextureType == SINGLE) mSheet = SpriteAtlas::findSheet(textureFilepath, 1, 1);
+    else mSheet = SpriteAtlas::findSheet(textureFilepath,
+        (int) mSpriteSheetDimensions.x, (int) mSpriteSheetDimensions.y);
+}
+
+void Entity::setTexture(const char *textureFilepath)
+{
+    findSheet(textureFilepath);
+}
+
+void Entity::respawn(Vector2 position, Vector2 scale, const char *textureFilepath, 
+    TextureType textureType, Vector2 spriteSheetDimensions, 
+    int walkSet, EntityType entityType)
+{
+    // same values as the atlas constructor and the member initialisers
+    this->position()       = position;
+    mOriginalPos           = position;
+    movement()             = { 0.0f, 0.0f };
+    velocity()             = { 0.0f, 0.0f };
+    mAcceleration          = { 0.0f, 0.0f };
+    mScale                 = scale;
+    mColliderDimensions    = scale;
+    mTextureType           = textureType;
+    mSpriteSheetDimensions = spriteSheetDimensions;
+    findSheet(textureFilepath);
+    mDirection             = RIGHT;
+    frameSpeed()           = DEFAULT_FRAME_SPEED;
+    speed()                = DEFAULT_SPEED;
+    mAngle                 = 0.0f;
+    mEntityType            = entityType;
+    mAIType                = WANDERER;
+    mAIState               = IDLE;
+    mOwner                 = nullptr;
+
+    mWalkSet   = walkSet;
+    mAttackSet = AnimationClips::NO_CLIP;
+    setClip(AnimationClips::walkClip(mWalkSet, RIGHT));
+
+    mEntityID.clear();
+    mAttackType        = MAGIC; // unused role, so stale ARROW/PROJECTILE can't leak
+    mAttackRadius      = 0.0f;
+    mCheckCollision    = true;
+    mEntityState       = WALK;
+    mAttackTimer       = 0.0f;
+    mAttackCooldown    = 2.5f;
+    mAttackInterval    = 2.0f;
+    mTarget            = nullptr;
+    mEffectType        = NONE_EFFECT;
+    lifetime()         = -1.0f;
+    movePhase          = 0;
+    frameIndex()       = 0;
+    animationTime()    = 0.0f;
+    mIsJumping         = false;
+    mJumpingPower      = 0.0f;
+    ignoreMapCollision = false;
+    mIsEffect          = false;
+    flags()            = EntityStore::IN_USE | EntityStore::ACTIVE | EntityStore::FRESH;
+    resetColliderFlags();
+
+    mMaxHP              = 100;
+    mCurrentHP          = 100;
+    mInvincible         = false;
+    mInvincibleTimer    = 0.0f;
+    mInvincibleDuration = 0.3f;
+    mSpawnInvincible    = 1.0f;
+    mAttackActive       = false;
+    mExpAwarded         = false;
+    mPierceRemaining    = 0;
+
+    moveTarget   = { 0.0f, 0.0f };
+    moveSpeed    = 0.0f;
+    isMoving     = false;
+    mHomingSpeed = 200.0f;
+}
+
+void Entity::checkCollisionY(EntityView collidableEntities)
 {
-    for (int i = 0; i < collidableEntities.size(); i++)
+    for (size_t i = 0; i < collidableEntities.size(); i++)
     {
         // STEP 1: For every entity that our player can collide with...
         Entity *collidableEntity = collidableEntities[i];
@@ -60,28 +155,28 @@ void Entity::checkCollisionY(std::vector<Entity*> collidableEntities)
             // STEP 2: Calculate the distance between its centre and our centre
             //         and use that to calculate the amount of overlap between
             //         both bodies.
-            float yDistance = fabs(mPosition.y - collidableEntity->mPosition.y);
+            float yDistance = fabs(position().y - collidableEntity->position().y);
             float yOverlap  = fabs(yDistance - (mColliderDimensions.y / 2.0f) - 
                               (collidableEntity->mColliderDimensions.y / 2.0f));
             
             // STEP 3: "Unclip" ourselves from the other entity, and zero our
             //         vertical velocity.
-            if (mVelocity.y > 0) 
+            if (velocity().y > 0) 
             {
-                mPosition.y -= yOverlap;
-                mVelocity.y  = 0;
+                position().y -= yOverlap;
+                velocity().y  = 0;
                 mIsCollidingBottom = true;
-            } else if (mVelocity.y < 0) 
+            } else if (velocity().y < 0) 
             {
-                mPosition.y += yOverlap;
-                mVelocity.y  = 0;
+                position().y += yOverlap;
+                velocity().y  = 0;
                 mIsCollidingTop = true;
             }
         }
     }
 }
 
-void Entity::checkCollisionX(std::vector<Entity*> collidableEntities)
+void Entity::checkCollisionX(EntityView collidableEntities)
 {
     for (size_t i = 0; i < collidableEntities.size(); i++)
     {
@@ -107,24 +202,24 @@ void Entity::checkCollisionX(std::vector<Entity*> collidableEntities)
             // collision detections. So the solution I found is only resolve X
             // collisions if there's significant Y overlap, preventing the 
             // platform we're standing on from acting like a wall.
-            float yDistance = fabs(mPosition.y - collidableEntity->mPosition.y);
+            float yDistance = fabs(position().y - collidableEntity->position().y);
             float yOverlap  = fabs(yDistance - (mColliderDimensions.y / 2.0f) - (collidableEntity->mColliderDimensions.y / 2.0f));
 
             // Skip if barely touching vertically (standing on platform)
             if (yOverlap < Y_COLLISION_THRESHOLD) continue;
 
-            float xDistance = fabs(mPosition.x - collidableEntity->mPosition.x);
+            float xDistance = fabs(position().x - collidableEntity->position().x);
             float xOverlap  = fabs(xDistance - (mColliderDimensions.x / 2.0f) - (collidableEntity->mColliderDimensions.x / 2.0f));
 
-            if (mVelocity.x > 0) {
-                mPosition.x     -= xOverlap;
-                mVelocity.x      = 0;
+            if (velocity().x > 0) {
+                position().x     -= xOverlap;
+                velocity().x      = 0;
 
                 // Collision!
                 mIsCollidingRight = true;
-            } else if (mVelocity.x < 0) {
-                mPosition.x    += xOverlap;
-                mVelocity.x     = 0;
+            } else if (velocity().x < 0) {
+                position().x    += xOverlap;
+                velocity().x     = 0;
  
                 // Collision!
                 mIsCollidingLeft = true;
@@ -137,75 +232,104 @@ void Entity::checkCollisionY(Map *map)
 {
     if (map == nullptr) return;
 
-    Vector2 topCentreProbe    = { mPosition.x, mPosition.y - (mColliderDimensions.y / 2.0f) };
-    Vector2 topLeftProbe      = { mPosition.x - (mColliderDimensions.x / 2.0f), mPosition.y - (mColliderDimensions.y / 2.0f) };
-    Vector2 topRightProbe     = { mPosition.x + (mColliderDimensions.x / 2.0f), mPosition.y - (mColliderDimensions.y / 2.0f) };
-
-    Vector2 bottomCentreProbe = { mPosition.x, mPosition.y + (mColliderDimensions.y / 2.0f) };
-    Vector2 bottomLeftProbe   = { mPosition.x - (mColliderDimensions.x / 2.0f), mPosition.y + (mColliderDimensions.y / 2.0f) };
-    Vector2 bottomRightProbe  = { mPosition.x + (mColliderDimensions.x / 2.0f), mPosition.y + (mColliderDimensions.y / 2.0f) };
+    // only the edge we are moving towards can stop us, so only probe that one
+    int edge = velocity().y < 0.0f ? Map::EDGE_TOP
+             : velocity().y > 0.0f ? Map::EDGE_BOTTOM : 0;
+    if (edge == 0) return;
 
-    float xOverlap = 0.0f;
-    float yOverlap = 0.0f;
+    Map::BoxContacts contacts = map->probeBox(position(), mColliderDimensions, edge);
 
     // COLLISION ABOVE (jumping upward)
-    if ((map->isSolidTileAt(topCentreProbe, &xOverlap, &yOverlap) ||
-         map->isSolidTileAt(topLeftProbe, &xOverlap, &yOverlap)   ||
-         map->isSolidTileAt(topRightProbe, &xOverlap, &yOverlap)) && mVelocity.y < 0.0f)
+    if (contacts.top.solid)
     {
-        mPosition.y += yOverlap;   // push down
-        mVelocity.y  = 0.0f;
+        position().y += contacts.top.yOverlap;   // push down
+        velocity().y  = 0.0f;
         mIsCollidingTop = true;
     }
 
     // COLLISION BELOW (falling downward)
-    if ((map->isSolidTileAt(bottomCentreProbe, &xOverlap, &yOverlap) ||
-         map->isSolidTileAt(bottomLeftProbe, &xOverlap, &yOverlap)   ||
-         map->isSolidTileAt(bottomRightProbe, &xOverlap, &yOverlap)) && mVelocity.y > 0.0f)
+    if (contacts.bottom.solid)
     {
-        mPosition.y -= yOverlap;   // push up
-        mVelocity.y  = 0.0f;
+        position().y -= contacts.bottom.yOverlap;   // push up
+        velocity().y  = 0.0f;
         mIsCollidingBottom = true;
     } 
 }
 
+// A step longer than half a tile can carry the collider past a wall between
+// two probe checks, so such a step is cut short where the swept collider first
+// touches a solid tile; the probe check that follows then settles it there.
+Vector2 Entity::clipToMap(Map *map, Vector2 step) const
+{
+    if (map == nullptr) return step;
+
+    float halfTile = map->getTileSize() / 2.0f;
+    if (fabsf(step.x) < halfTile && fabsf(step.y) < halfTile) return step;
+
+    Map::RayHit hit;
+    if (!map->sweepBox(position(), mColliderDimensions, step, &hit)) return step;
+
+    return { step.x * hit.fraction, step.y * hit.fraction };
+}
+
 void Entity::checkCollisionX(Map *map)
 {
     if (map == nullptr) return;
 
-    Vector2 leftCentreProbe   = { mPosition.x - (mColliderDimensions.x / 2.0f), mPosition.y };
+    int edge = velocity().x > 0.0f ? Map::EDGE_RIGHT
+             : velocity().x < 0.0f ? Map::EDGE_LEFT : 0;
+    if (edge == 0) return;
 
-    Vector2 rightCentreProbe  = { mPosition.x + (mColliderDimensions.x / 2.0f), mPosition.y };
-
-    float xOverlap = 0.0f;
-    float yOverlap = 0.0f;
+    Map::BoxContacts contacts = map->probeBox(position(), mColliderDimensions, edge);
 
     // COLLISION ON RIGHT (moving right)
-    if (map->isSolidTileAt(rightCentreProbe, &xOverlap, &yOverlap) 
-         && mVelocity.x > 0.0f && yOverlap >= 0.5f)
+    if (contacts.right.solid && contacts.right.yOverlap >= 0.5f)
     {
-        mPosition.x -= xOverlap * 1.01f;   // push left
-        mVelocity.x  = 0.0f;
+        position().x -= contacts.right.xOverlap * 1.01f;   // push left
+        velocity().x  = 0.0f;
         mIsCollidingRight = true;
     }
 
     // COLLISION ON LEFT (moving left)
-    if (map->isSolidTileAt(leftCentreProbe, &xOverlap, &yOverlap) 
-         && mVelocity.x < 0.0f && yOverlap >= 0.5f)
+    if (contacts.left.solid && contacts.left.yOverlap >= 0.5f)
     {
-        mPosition.x += xOverlap * 1.01;   // push right
-        mVelocity.x  = 0.0f;
+        position().x += contacts.left.xOverlap * 1.01;   // push right
+        velocity().x  = 0.0f;
         mIsCollidingLeft = true;
     }
 }
 
+bool Entity::sweepHits(Entity *other, float deltaTime) const
+{
+    if (isColliding(other)) return true;
+    if (!other->isActive() || other == this) return false;
+
+    Vector2 step = { velocity().x * deltaTime, velocity().y * deltaTime };
+    if (step.x == 0.0f && step.y == 0.0f) return false;
+
+    // our centre against `other` grown by our half size
+    Vector2 otherPosition = other->getPosition();
+    Vector2 combined = {
+        mColliderDimensions.x + other->getColliderDimensions().x,
+        mColliderDimensions.y + other->getColliderDimensions().y
+    };
+    Rectangle grown = {
+        otherPosition.x - combined.x / 2.0f, otherPosition.y - combined.y / 2.0f,
+        combined.x, combined.y
+    };
+
+    float entry, exit;
+    return intersectSegmentBox({ position().x - step.x, position().y - step.y },
+        step, grown, &entry, &exit) && entry > 0.0f;
+}
+
 bool Entity::isColliding(Entity *other) const 
 {
     if (!other->isActive() || other == this) return false;
 
-    float xDistance = fabs(mPosition.x - other->getPosition().x) - 
+    float xDistance = fabs(position().x - other->getPosition().x) - 
         ((mColliderDimensions.x + other->getColliderDimensions().x) / 2.0f);
-    float yDistance = fabs(mPosition.y - other->getPosition().y) - 
+    float yDistance = fabs(position().y - other->getPosition().y) - 
         ((mColliderDimensions.y + other->getColliderDimensions().y) / 2.0f);
 
     if (xDistance < 0.0f && yDistance < 0.0f) return true;
@@ -219,23 +343,23 @@ void Entity::animate(float deltaTime)
     // ✔ Special handling for EFFECT entities to play attack animations
     if (mEntityType == EFFECT || mIsEffect)
     {
-        if (!mAttackAnimations.empty() && mEntityState == ATTACK)
+        if (mAttackSet != AnimationClips::NO_CLIP && mEntityState == ATTACK)
         {
-            mAnimationIndices = mAttackAnimations.at(ATTACK);
+            setClip(AnimationClips::attackClip(mAttackSet, ATTACK));
         }
-        else if (!mWalkAnimations.empty())
+        else if (mWalkSet != AnimationClips::NO_CLIP)
         {
             // If no attack animation but has walk animation, use walk animation
-            mAnimationIndices = mWalkAnimations.at(mDirection);
+            setClip(AnimationClips::walkClip(mWalkSet, mDirection));
         }
         // If neither exists, keep current animation indices
         
         // DEBUG: Output for EFFECT entities with lifetime
         static int debugCounter = 0;
-        if (mLifetime > 0.0f && debugCounter++ % 60 == 0)
+        if (lifetime() > 0.0f && debugCounter++ % 60 == 0)
         {
             // printf("[DEBUG] EFFECT animate: frame=%d, indices_size=%zu, walkAnim_size=%zu\n",
-            //        mCurrentFrameIndex, mAnimationIndices.size(), mWalkAnimations.size());
+            //        frameIndex(), frameCount(), mClip);
         }
     }
 
@@ -243,31 +367,31 @@ void Entity::animate(float deltaTime)
         switch (mEntityState)
         {
             case WALK:
-                mAnimationIndices = mWalkAnimations.at(mDirection);
+                setClip(AnimationClips::walkClip(mWalkSet, mDirection));
                 break;
             case ATTACK:
-                if (!mAttackAnimations.empty())
-                    mAnimationIndices = mAttackAnimations.at(mEntityState);
+                if (mAttackSet != AnimationClips::NO_CLIP)
+                    setClip(AnimationClips::attackClip(mAttackSet, mEntityState));
                 break;
             default:
-                mAnimationIndices = mWalkAnimations.at(mDirection);
+                setClip(AnimationClips::walkClip(mWalkSet, mDirection));
                 break;
         }
     }
 
-    if (mAnimationIndices.empty()) return;
+    if (frameCount() == 0) return;
 
-    mAnimationTime += deltaTime;
-    // mFrameSpeed is seconds per frame (e.g. 0.1 = 10fps)
-    if (mAnimationTime >= mFrameSpeed)
+    animationTime() += deltaTime;
+    // frameSpeed() is seconds per frame (e.g. 0.1 = 10fps)
+    if (animationTime() >= frameSpeed())
     {
-        mAnimationTime = 0.0f;
+        animationTime() = 0.0f;
 
-        mCurrentFrameIndex++;
-        mCurrentFrameIndex %= mAnimationIndices.size();
+        frameIndex()++;
+        frameIndex() %= frameCount();
         
         // If in ATTACK state and animation finished, return to WALK
-        if (mEntityState == ATTACK && mCurrentFrameIndex == 0)
+        if (mEntityState == ATTACK && frameIndex() == 0)
         {
             mEntityState = WALK;
         }
@@ -276,28 +400,28 @@ void Entity::animate(float deltaTime)
 
 void Entity::forceAnimationStart()
 {
-    if (!mAttackAnimations.empty())
+    if (mAttackSet != AnimationClips::NO_CLIP)
     {
-        mAnimationIndices = mAttackAnimations.at(ATTACK);
-        mCurrentFrameIndex = 0;
-        mAnimationTime = 0;
+        setClip(AnimationClips::attackClip(mAttackSet, ATTACK));
+        frameIndex() = 0;
+        animationTime() = 0;
     }
 }
 
 
-void Entity::AIWander() { 
+void Entity::AIWander(Random &random) { 
     // 确保mOriginalPos已初始化（如果为0，使用当前位置）
     if (mOriginalPos.x == 0.0f && mOriginalPos.y == 0.0f) {
-        mOriginalPos = mPosition;
+        mOriginalPos = position();
     }
     
     // 固定移动范围：100像素半径
     const float WANDER_RADIUS = 100.0f;
-    float distFromOrigin = Vector2Distance(mPosition, mOriginalPos);
+    float distFromOrigin = Vector2Distance(position(), mOriginalPos);
     
     // 如果超出范围，返回原始位置方向
     if (distFromOrigin > WANDER_RADIUS) {
-        Vector2 dirToOrigin = {mOriginalPos.x - mPosition.x, mOriginalPos.y - mPosition.y};
+        Vector2 dirToOrigin = {mOriginalPos.x - position().x, mOriginalPos.y - position().y};
         float len = sqrtf(dirToOrigin.x * dirToOrigin.x + dirToOrigin.y * dirToOrigin.y);
         if (len > 0.001f) {
             dirToOrigin.x /= len;
@@ -321,18 +445,18 @@ void Entity::AIWander() {
     
     // 基于当前位置的伪随机数，每帧稳定但不同位置会有不同结果
     // 使用位置的小数部分来生成稳定的随机数
-    int posHash = (int)(mPosition.x * 0.1f) + (int)(mPosition.y * 0.1f);
+    int posHash = (int)(position().x * 0.1f) + (int)(position().y * 0.1f);
     int dirChoice = (abs(posHash + seed) / 5) % 4;
     
     // 如果当前没有移动或移动很小，随机选择一个方向
-    float moveLen = sqrtf(mMovement.x * mMovement.x + mMovement.y * mMovement.y);
+    float moveLen = sqrtf(movement().x * movement().x + movement().y * movement().y);
     if (moveLen < 0.1f) {
-        dirChoice = GetRandomValue(0, 3);
+        dirChoice = random.range(0, 3);
     }
     
     // 每帧有5%概率改变方向，让移动更自然但不会太频繁
-    if (GetRandomValue(0, 100) < 5) {
-        dirChoice = GetRandomValue(0, 3);
+    if (random.range(0, 100) < 5) {
+        dirChoice = random.range(0, 3);
     }
     
     switch(dirChoice) {
@@ -345,8 +469,8 @@ void Entity::AIWander() {
 
  
 void Entity::AIFlyer() { 
-    if (mPosition.y >= mOriginalPos.y + 165.0f) mDirection = UP;
-    else if (mPosition.y <= mOriginalPos.y) mDirection = DOWN;
+    if (position().y >= mOriginalPos.y + 165.0f) mDirection = UP;
+    else if (position().y <= mOriginalPos.y) mDirection = DOWN;
     if(mDirection == UP) moveUp();
     else if (mDirection == DOWN) moveDown();
  }
@@ -358,14 +482,14 @@ void Entity::AIFollow(Entity* target)
     // 玩家当前位置
     Vector2 playerPos = target->getPosition();
 
-    float dx = playerPos.x - mPosition.x;
-    float dy = playerPos.y - mPosition.y;
+    float dx = playerPos.x - position().x;
+    float dy = playerPos.y - position().y;
 
     // 距离非常近时，停止移动，避免抖动
     float dist2 = dx * dx + dy * dy;
     if (dist2 < 1.0f) {
-        mMovement.x = 0.0f;
-        mMovement.y = 0.0f;
+        movement().x = 0.0f;
+        movement().y = 0.0f;
         return;
     }
 
@@ -374,8 +498,8 @@ void Entity::AIFollow(Entity* target)
     float ny = dy / dist;
 
     // 让 follower 永远朝玩家移动，不管多远
-    mMovement.x = nx;
-    mMovement.y = ny;
+    movement().x = nx;
+    movement().y = ny;
 
     // 更新朝向，用于选择动画方向（谁绝对值大就按谁）
     if (std::fabs(nx) >= std::fabs(ny)) {
@@ -391,12 +515,12 @@ void Entity::AIFollow(Entity* target)
 }
 
 
-void Entity::AIActivate(Entity *target)
+void Entity::AIActivate(Entity *target, Random &random)
 {
     switch (mAIType)
     {
     case WANDERER:
-        AIWander();
+        AIWander(random);
         break;
 
     case FOLLOWER:
@@ -414,7 +538,7 @@ void Entity::AIActivate(Entity *target)
 
 void Entity::takeDamage(int amount)
 {
-    if (mEntityStatus == INACTIVE) return;
+    if (!isActive()) return;
 
     
     if (mEntityType == PLAYER)
@@ -431,7 +555,7 @@ void Entity::takeDamage(int amount)
 
         if (mCurrentHP <= 0)
         {
-            mEntityStatus = INACTIVE;
+            deactivate();
         }
 
         return;
@@ -443,7 +567,7 @@ void Entity::takeDamage(int amount)
 
     if (mCurrentHP <= 0)
     {
-        mEntityStatus = INACTIVE;
+        deactivate();
     }
 }
 
@@ -451,14 +575,15 @@ void Entity::takeDamage(int amount)
 void Entity::attack()
 {
     mEntityState = ATTACK;
+    setBulkIntegrated(false); // integrate() only knows how to loop WALK frames
 
     if (mIsEffect)
     {
-        if (!mAttackAnimations.empty())
+        if (mAttackSet != AnimationClips::NO_CLIP)
         {
-            mAnimationIndices = mAttackAnimations[ATTACK];
-            mCurrentFrameIndex = 0;
-            mAnimationTime = 0;
+            setClip(AnimationClips::attackClip(mAttackSet, ATTACK));
+            frameIndex() = 0;
+            animationTime() = 0;
         }
     }
 }
@@ -480,29 +605,32 @@ void Entity::setAttackInterval(float interval)
 
 void Entity::setLifetime(float seconds)
 {
-    mLifetime = seconds;
+    lifetime() = seconds;
 }
 
 float Entity::getLifetime() const
 {
-    return mLifetime;
+    return lifetime();
 }
 
 bool Entity::hasLifetime() const
 {
-    return (mLifetime > 0.0f);
+    return (lifetime() > 0.0f);
 }
 
 
 
 void Entity::update(float deltaTime, Entity *player, Map *map, 
-    std::vector<Entity*> collidableEntities)
+    EntityView collidableEntities, Random *random)
 {
+    // advanced by EntityStore::integrate along with the other bulk effects
+    if (isBulkIntegrated()) return;
+
     // --- Lifetime handling: decrement and deactivate when expired ---
-    if (mLifetime > 0.0f)
+    if (lifetime() > 0.0f)
     {
-        mLifetime -= deltaTime;
-        if (mLifetime <= 0.0f)
+        lifetime() -= deltaTime;
+        if (lifetime() <= 0.0f)
         {
             this->deactivate();
             return;
@@ -524,41 +652,43 @@ void Entity::update(float deltaTime, Entity *player, Map *map,
         
         // 更新位置（对于有movement的effect，如飞弹）
         // 需要先计算velocity，然后更新位置
-        if (mLifetime > 0.0f || GetLength(mMovement) > 0.0f)
+        if (lifetime() > 0.0f || GetLength(movement()) > 0.0f)
         {
             // 计算velocity（基于movement和speed）
-            mVelocity.x = mMovement.x * mSpeed;
-            mVelocity.y = mMovement.y * mSpeed;
+            velocity().x = movement().x * speed();
+            velocity().y = movement().y * speed();
             
             // 更新位置
-            mPosition.x += mVelocity.x * deltaTime;
-            mPosition.y += mVelocity.y * deltaTime;
+            position().x += velocity().x * deltaTime;
+            position().y += velocity().y * deltaTime;
         }
         return;
     }
 
     // std::cout << "colliding bottom " << mIsCollidingBottom << std::endl;
-    if (mEntityStatus == INACTIVE) return;
+    if (!isActive()) return;
     
-    // if ( mIsCollidingBottom && mVelocity.y != 0) printf("bugbug\n");
-    if (mEntityType == NPC) AIActivate(player);
+    // if ( mIsCollidingBottom && velocity().y != 0) printf("bugbug\n");
+    // Entities updated outside a scene (benchmarks) share one fixed stream
+    static Random standaloneRandom;
+    if (mEntityType == NPC) AIActivate(player, random ? *random : standaloneRandom);
 
     resetColliderFlags();
 
-    mVelocity.x = mMovement.x * mSpeed;
-    mVelocity.y = mMovement.y * mSpeed;
+    velocity().x = movement().x * speed();
+    velocity().y = movement().y * speed();
     
-    mVelocity.x += mAcceleration.x * deltaTime;
-    if (mAIType != FLYER) mVelocity.y += mAcceleration.y * deltaTime;
+    velocity().x += mAcceleration.x * deltaTime;
+    if (mAIType != FLYER) velocity().y += mAcceleration.y * deltaTime;
     else {
         if (mDirection == UP)
-            mVelocity = {0, (float)(-mSpeed)};
+            velocity() = {0, (float)(-speed())};
         if (mDirection == DOWN)
-            mVelocity = {0, (float)(mSpeed)};
+            velocity() = {0, (float)(speed())};
     }
 
-    if (mTextureType == ATLAS && mVelocity.x != 0) {
-        if (mVelocity.x < 0) {
+    if (mTextureType == ATLAS && velocity().x != 0) {
+        if (velocity().x < 0) {
             setDirection(LEFT);
         } else {
             setDirection(RIGHT);
@@ -577,7 +707,7 @@ void Entity::update(float deltaTime, Entity *player, Map *map,
         mIsJumping = false;
         
         // STEP 2: The player now acquires an upward velocity
-        mVelocity.y -= mJumpingPower;
+        velocity().y -= mJumpingPower;
     }
 
     // let character stay in ATTACK state for 0.5s
@@ -591,17 +721,23 @@ void Entity::update(float deltaTime, Entity *player, Map *map,
         }
     }
     
-    mPosition.y += mVelocity.y * deltaTime;
+    bool collidesWithMap = mEntityType == BLOCK || mEntityType == PLATFORM;
+
+    Vector2 step = { 0.0f, velocity().y * deltaTime };
+    if (collidesWithMap) step = clipToMap(map, step);
+    position().y += step.y;
     checkCollisionY(collidableEntities);
 
-    if (mEntityType == BLOCK || mEntityType == PLATFORM) {
+    if (collidesWithMap) {
         checkCollisionY(map);
     }
 
-    mPosition.x += mVelocity.x * deltaTime;
+    step = { velocity().x * deltaTime, 0.0f };
+    if (collidesWithMap) step = clipToMap(map, step);
+    position().x += step.x;
     checkCollisionX(collidableEntities);
 
-    if (mEntityType == BLOCK || mEntityType == PLATFORM) {
+    if (collidesWithMap) {
         checkCollisionX(map);
     }
 
@@ -609,7 +745,7 @@ void Entity::update(float deltaTime, Entity *player, Map *map,
     // Animate
     if (mTextureType == ATLAS) {
         // 对于NPC类型，即使没有移动也要播放动画（Idle动画）
-        if (mEntityType == NPC || !(GetLength(mMovement) == 0))
+        if (mEntityType == NPC || !(GetLength(movement()) == 0))
             animate(deltaTime);
     }
 
@@ -617,8 +753,8 @@ void Entity::update(float deltaTime, Entity *player, Map *map,
     if (moveSpeed > 0.0f)
     {
         Vector2 direction = {
-            moveTarget.x - mPosition.x,
-            moveTarget.y - mPosition.y
+            moveTarget.x - position().x,
+            moveTarget.y - position().y
         };
 
         float distance = sqrt(direction.x*direction.x + direction.y*direction.y);
@@ -626,15 +762,15 @@ void Entity::update(float deltaTime, Entity *player, Map *map,
         if (distance < 1.0f)
         {
             moveSpeed = 0.0f;
-            mVelocity = {0,0};
+            velocity() = {0,0};
         }
         else
         {
             direction.x /= distance;
             direction.y /= distance;
 
-            mPosition.x += direction.x * moveSpeed * deltaTime;
-            mPosition.y += direction.y * moveSpeed * deltaTime;
+            position().x += direction.x * moveSpeed * deltaTime;
+            position().y += direction.y * moveSpeed * deltaTime;
         }
     }
     // Handle invincibility frames
@@ -653,8 +789,8 @@ void Entity::update(float deltaTime, Entity *player, Map *map,
     if (mEntityType == NPC && mAIType == WANDERER && player != nullptr)
     {
         Vector2 playerPos = player->getPosition();
-        float dx = playerPos.x - mPosition.x;
-        float dy = playerPos.y - mPosition.y;
+        float dx = playerPos.x - position().x;
+        float dy = playerPos.y - position().y;
         float dist2 = dx * dx + dy * dy;
         const float ACTIVATION_DISTANCE = 120.0f * 120.0f; // 120像素的平方，避免开方运算
         
@@ -696,8 +832,8 @@ void Entity::update(float deltaTime, Entity *player, Map *map,
             }
 
             // ensure velocity follows movement & speed (so existing physics code continues to work)
-            mVelocity.x = mMovement.x * mSpeed;
-            mVelocity.y = mMovement.y * mSpeed;
+            velocity().x = movement().x * speed();
+            velocity().y = movement().y * speed();
         }
         // 如果玩家距离远，AIWander()已经设置了移动方向，这里不需要覆盖
     }
@@ -705,6 +841,20 @@ void Entity::update(float deltaTime, Entity *player, Map *map,
 
 }
 
+// The frame to draw: the whole image for SINGLE, the clip's current frame
+// for ATLAS (frame numbers past the end of the grid show the last frame, and
+// an entity without a clip draws nothing)
+const SpriteFrame &Entity::currentFrame()
+{
+    if (mTextureType == SINGLE) return SpriteAtlas::frame(mSheet, 0);
+    if (frameCount() == 0) return SpriteAtlas::frame(SpriteAtlas::NO_SHEET, 0);
+
+    if (frameIndex() >= frameCount())
+        frameIndex() = 0;
+
+    return SpriteAtlas::frame(mSheet, AnimationClips::frames(mClip)[frameIndex()]);
+}
+
 void Entity::render()
 {
     // DEBUG: Check if laser is being skipped due to INACTIVE
@@ -718,64 +868,31 @@ void Entity::render()
         }
     }
     
-    if(mEntityStatus == INACTIVE) return;
+    if(!isActive()) return;
     
     // DEBUG: Output specifically for Heaven Laser (scale.x > 100 indicates laser beam)
     if (mEntityType == EFFECT && mIsEffect && mScale.x > 100.0f)
     {
         static int laserRenderCount = 0;
         // printf("[DEBUG] LASER RENDER #%d: pos(%.1f,%.1f) scale(%.1f,%.1f) frame=%d angle=%.1f\n",
-        //        laserRenderCount++, mPosition.x, mPosition.y, mScale.x, mScale.y, 
-        //        mCurrentFrameIndex, mAngle);
+        //        laserRenderCount++, position().x, position().y, mScale.x, mScale.y, 
+        //        frameIndex(), mAngle);
     }
 
-    Rectangle textureArea;
-
-    switch (mTextureType)
-    {
-        case SINGLE:
-            // Whole texture (UV coordinates)
-            textureArea = {
-                // top-left corner
-                0.0f, 0.0f,
-
-                // bottom-right corner (of texture)
-                static_cast<float>(mTexture.width),
-                static_cast<float>(mTexture.height)
-            };
-            break;
-        case ATLAS:
-        {
-            if (mAnimationIndices.size() == 0) break;
-
-            if (mCurrentFrameIndex >= mAnimationIndices.size())
-                mCurrentFrameIndex = 0;
-
-            int frameNumber = mAnimationIndices[mCurrentFrameIndex];
-
-            int maxFrame = mSpriteSheetDimensions.x * mSpriteSheetDimensions.y;
-            if (frameNumber >= maxFrame)
-                frameNumber = maxFrame - 1;
-
-            textureArea = getUVRectangle(
-                &mTexture,
-                frameNumber,
-                mSpriteSheetDimensions.x,
-                mSpriteSheetDimensions.y
-            );
-            break;
-        }
-    }
+    // Source rectangle on whichever atlas page (or loose sheet) holds it
+    const SpriteFrame &frame = currentFrame();
+    Rectangle textureArea = frame.source;
 
     // Flip texture horizontally when facing left
     if (mDirection == LEFT && textureArea.width > 0) {
         textureArea.width = -textureArea.width;
     }
 
-    // Destination rectangle – centred on gPosition
+    // Destination rectangle – centred on gPosition, between the last two ticks
+    Vector2 drawPosition = getRenderPosition();
     Rectangle destinationArea = {
-        mPosition.x,
-        mPosition.y,
+        drawPosition.x,
+        drawPosition.y,
         static_cast<float>(mScale.x),
         static_cast<float>(mScale.y)
     };
@@ -790,19 +907,18 @@ void Entity::render()
     {
         float hpRatio = (float)mCurrentHP / mMaxHP;
 
-        DrawRectangle(
-            mPosition.x - 15,
-            mPosition.y - mScale.y/2 - 10,
-            30 * hpRatio,
-            4,
-            RED
+        // batched like the sprites, so it is not painted over by them
+        SpriteBatch::drawRectangle(
+            { drawPosition.x - 15, drawPosition.y - mScale.y/2 - 10,
+              30 * hpRatio, 4.0f },
+            RED, LAYER_OVERLAY
         );
     }
 
 
     // Render the texture on screen
-    DrawTexturePro(
-        mTexture, 
+    SpriteBatch::draw(
+        frame.texture, 
         textureArea, destinationArea, originOffset,
         mAngle, WHITE
     );
@@ -810,50 +926,41 @@ void Entity::render()
     // displayCollider();
 }
 
-void Entity::renderWithTint(Color tint)
+bool Entity::isVisibleIn(Rectangle area) const
 {
-    if(mEntityStatus == INACTIVE) return;
-
-    Rectangle textureArea;
-
-    switch (mTextureType)
+    // a rotated sprite stays inside the circle through its corners
+    float halfWidth  = mScale.x / 2.0f;
+    float halfHeight = mScale.y / 2.0f;
+    if (mAngle != 0.0f)
     {
-        case SINGLE:
-            textureArea = {
-                0.0f, 0.0f,
-                static_cast<float>(mTexture.width),
-                static_cast<float>(mTexture.height)
-            };
-            break;
-        case ATLAS:
-        {
-            if (mAnimationIndices.size() == 0) break;
-
-            if (mCurrentFrameIndex >= mAnimationIndices.size())
-                mCurrentFrameIndex = 0;
-
-            int frameNumber = mAnimationIndices[mCurrentFrameIndex];
-            int maxFrame = mSpriteSheetDimensions.x * mSpriteSheetDimensions.y;
-            if (frameNumber >= maxFrame)
-                frameNumber = maxFrame - 1;
-
-            textureArea = getUVRectangle(
-                &mTexture,
-                frameNumber,
-                mSpriteSheetDimensions.x,
-                mSpriteSheetDimensions.y
-            );
-            break;
-        }
+        halfWidth  = sqrtf(halfWidth * halfWidth + halfHeight * halfHeight);
+        halfHeight = halfWidth;
     }
 
+    Vector2 drawPosition = getRenderPosition();
+    Rectangle bounds = {
+        drawPosition.x - halfWidth, drawPosition.y - halfHeight,
+        halfWidth * 2.0f, halfHeight * 2.0f
+    };
+
+    return rectanglesOverlap(bounds, area);
+}
+
+void Entity::renderWithTint(Color tint)
+{
+    if(!isActive()) return;
+
+    const SpriteFrame &frame = currentFrame();
+    Rectangle textureArea = frame.source;
+
     if (mDirection == LEFT && textureArea.width > 0) {
         textureArea.width = -textureArea.width;
     }
 
+    Vector2 drawPosition = getRenderPosition();
     Rectangle destinationArea = {
-        mPosition.x,
-        mPosition.y,
+        drawPosition.x,
+        drawPosition.y,
         static_cast<float>(mScale.x),
         static_cast<float>(mScale.y)
     };
@@ -864,8 +971,8 @@ void Entity::renderWithTint(Color tint)
     };
 
     // Render with custom tint
-    DrawTexturePro(
-        mTexture, 
+    SpriteBatch::draw(
+        frame.texture, 
         textureArea, destinationArea, originOffset,
         mAngle, tint
     );
@@ -875,8 +982,8 @@ void Entity::displayCollider()
 {
     // draw the collision box
     // Rectangle colliderBox = {
-    //     mPosition.x - mColliderDimensions.x / 2.0f,  
-    //     mPosition.y - mColliderDimensions.y / 2.0f,  
+    //     position().x - mColliderDimensions.x / 2.0f,  
+    //     position().y - mColliderDimensions.y / 2.0f,  
     //     mColliderDimensions.x,                        
     //     mColliderDimensions.y                        
     // };
@@ -2,23 +2,79 @@
 #define ENTITY_H
 
 #include "Map.h"
+#include "EntityStore.h"
+#include "AnimationClips.h" // Direction, EntityState
+#include "Random.h"
+#include "SpriteAtlas.h"
 
-enum Direction    { LEFT, UP, RIGHT, DOWN      }; // For walking
 enum EntityStatus { ACTIVE, INACTIVE                   };
 enum EntityType   { PLAYER, BLOCK, PLATFORM, NPC, EFFECT, TRIGGER, NONE };
-enum EntityState  { WALK, WAIT, ATTACK              };
 enum AIType       { WANDERER, FOLLOWER, FLYER, BULLET        };
 enum AIState      { WALKING, IDLE, FOLLOWING           };
 enum AutoAttackType { AURA, PROJECTILE, MELEE, SHIELD, BOW, ARROW, MAGIC      };
 enum EffectType    { NONE_EFFECT, CENTER, RANGE, TRACE          };
 
+class Entity;
+
+/**
+ * Non-owning, read-only view over a contiguous run of entity pointers (what
+ * std::span<Entity* const> would be, for C++11). Two words wide, so it is
+ * passed by value; it must not outlive the vector it was taken from, and it is
+ * invalidated if that vector reallocates.
+ */
+class EntityView
+{
+private:
+    Entity *const *mData;
+    size_t mSize;
+
+public:
+    EntityView() : mData {nullptr}, mSize {0} {}
+    EntityView(Entity *const *data, size_t size) : mData {data}, mSize {size} {}
+    EntityView(const std::vector<Entity*> &entities) 
+        : mData {entities.data()}, mSize {entities.size()} {}
+
+    Entity *const *begin() const { return mData;         }
+    Entity *const *end()   const { return mData + mSize; }
+    Entity *operator[](size_t index) const { return mData[index]; }
+    size_t size()  const { return mSize;      }
+    bool   empty() const { return mSize == 0; }
+};
+
+/**
+ * Weak reference to an entity in a scene's EntityRegistry: a slot index plus
+ * the generation that slot had when the entity was added. Removing the entity
+ * moves the slot's generation on, so an old handle resolves to nullptr instead
+ * of a dangling pointer. A default-constructed handle never resolves.
+ */
+struct EntityHandle
+{
+    int          index;
+    unsigned int generation;
+
+    EntityHandle() : index {-1}, generation {0} {}
+    EntityHandle(int index, unsigned int generation) 
+        : index {index}, generation {generation} {}
+
+    bool isNull() const { return index < 0; }
+
+    bool operator==(const EntityHandle &other) const 
+        { return index == other.index && generation == other.generation; }
+    bool operator!=(const EntityHandle &other) const 
+        { return !(*this == other); }
+    bool operator<(const EntityHandle &other) const // for std::map / std::set keys
+        { return index != other.index ? index < other.index 
+                                      : generation < other.generation; }
+};
+
 class Entity
 {
 private:
-    Vector2 mPosition;
+    // Slot in EntityStore holding position, movement, velocity, speed,
+    // lifetime, animation timer/frame and the active flag
+    int mSlot = EntityStore::allocate();
+
     Vector2 mOriginalPos;
-    Vector2 mMovement;
-    Vector2 mVelocity;
     Vector2 mAcceleration;
     std::string mEntityID = "";
     bool mCheckCollision = true;
@@ -30,32 +86,30 @@ private:
     float mAttackRadius;
     Entity* mTarget = nullptr;
     EffectType mEffectType = NONE_EFFECT;
-    float mLifetime = -1.0f; // in seconds, -1 means infinite
     Entity* mOwner; // who spawned this entity (for projectiles/effects)
 
     Vector2 mScale;
     Vector2 mColliderDimensions;
     
-    Texture2D mTexture;
+    // SpriteAtlas sheet of the texture cut on mSpriteSheetDimensions (1 x 1
+    // for SINGLE); frames are drawn by number from it, never from a texture
+    // of the entity's own
+    int mSheet = SpriteAtlas::NO_SHEET;
     TextureType mTextureType;
     Vector2 mSpriteSheetDimensions;
     
-    std::map<Direction, std::vector<int>> mWalkAnimations;
-    std::map<EntityState, std::vector<int>> mAttackAnimations;
-    std::vector<int> mAnimationIndices;
+    // AnimationClips IDs; the frame cursor is frameIndex() in the store
+    int mWalkSet   = AnimationClips::NO_CLIP;
+    int mAttackSet = AnimationClips::NO_CLIP;
+    int mClip      = AnimationClips::NO_CLIP;
     Direction mDirection;
-    float mFrameSpeed;
     int movePhase = 0;
 
-    int mCurrentFrameIndex = 0;
-    float mAnimationTime = 0.0f;
-
     bool mIsJumping = false;
     float mJumpingPower = 0.0f;
     
     static constexpr float ATTACK_DURATION = 0.5f;
 
-    int mSpeed;
     float mAngle;
 
     bool mIsCollidingTop    = false;
@@ -67,8 +121,8 @@ private:
 
 
     Entity* mCollidedObject = nullptr;
+    EntityHandle mHandle; // set while the entity is in an EntityRegistry
 
-    EntityStatus mEntityStatus = ACTIVE;
     EntityType   mEntityType;
 
     AIType  mAIType;
@@ -76,11 +130,14 @@ private:
 
     bool isColliding(Entity *other) const;
 
-    void checkCollisionY(std::vector<Entity*> collidableEntities);
+    void checkCollisionY(EntityView collidableEntities);
     void checkCollisionY(Map *map);
 
-    void checkCollisionX(std::vector<Entity*> collidableEntities);
+    void checkCollisionX(EntityView collidableEntities);
     void checkCollisionX(Map *map);
+    Vector2 clipToMap(Map *map, Vector2 step) const;
+    const SpriteFrame &currentFrame();
+    void findSheet(const char *textureFilepath);
     
     void resetColliderFlags() 
     {
@@ -91,9 +148,28 @@ private:
         mCollidedObject = nullptr;
     }
 
+    Vector2 &position()      const { return EntityStore::positions[mSlot];      }
+    Vector2 &movement()      const { return EntityStore::movements[mSlot];      }
+    Vector2 &velocity()      const { return EntityStore::velocities[mSlot];     }
+    int     &speed()         const { return EntityStore::speeds[mSlot];         }
+    float   &lifetime()      const { return EntityStore::lifetimes[mSlot];      }
+    float   &animationTime() const { return EntityStore::animationTimes[mSlot]; }
+    float   &frameSpeed()    const { return EntityStore::frameSpeeds[mSlot];    }
+    int     &frameIndex()    const { return EntityStore::frameIndices[mSlot];   }
+    int     &frameCount()    const { return EntityStore::frameCounts[mSlot];    }
+    unsigned char &flags()   const { return EntityStore::flags[mSlot];          }
+
+    // Every change of clip goes through here so the store's frame count
+    // stays in step for EntityStore::integrate
+    void setClip(int clip)
+    {
+        mClip = clip;
+        frameCount() = AnimationClips::frameCount(clip);
+    }
+
     void animate(float deltaTime);
-    void AIActivate(Entity *target);
-    void AIWander();
+    void AIActivate(Entity *target, Random &random);
+    void AIWander(Random &random);
     void AIFlyer();
     void AIFollow(Entity *target);
 
@@ -106,6 +182,10 @@ private:
     float mSpawnInvincible = 1.0f;
     bool mAttackActive = false;
 
+    // Per-entity bookkeeping the levels used to keep in side containers
+    bool mExpAwarded = false;  // NPC: kill EXP already paid out
+    int  mPierceRemaining = 0; // arrow: hits left before it is spent
+
     
 
 
@@ -122,52 +202,78 @@ public:
         TextureType textureType, Vector2 spriteSheetDimensions, 
         std::map<Direction, std::vector<int>> animationAtlas, 
         EntityType entityType);
+    // Same, with a walk set already interned in AnimationClips
+    Entity(Vector2 position, Vector2 scale, const char *textureFilepath, 
+        TextureType textureType, Vector2 spriteSheetDimensions, 
+        int walkSet, EntityType entityType);
     ~Entity();
 
+    // the store slot is owned one-to-one
+    Entity(const Entity &) = delete;
+    Entity &operator=(const Entity &) = delete;
+
+    // Puts a (pooled) entity back into the state the atlas constructor would
+    // leave it in, reusing its containers instead of reallocating them.
+    void respawn(Vector2 position, Vector2 scale, const char *textureFilepath, 
+        TextureType textureType, Vector2 spriteSheetDimensions, 
+        int walkSet, EntityType entityType);
+
+    // random: the scene's AI stream (nullptr: a shared fixed-seed one)
     void update(float deltaTime, Entity *player, Map *map, 
-        std::vector<Entity*> collidableEntities);
+        EntityView collidableEntities, Random *random = nullptr);
     void render();
     void renderWithTint(Color tint);
-    void normaliseMovement() { Normalise(&mMovement); }
+    // Whether the sprite's scaled (and rotated) bounds touch the area
+    bool isVisibleIn(Rectangle area) const;
+    void normaliseMovement() { Normalise(&movement()); }
 
     void jump()       { mIsJumping = true;  }
     void attack();
-    void activate()   { mEntityStatus  = ACTIVE;   }
-    void deactivate() { mEntityStatus  = INACTIVE; }
+    void activate()   { flags() |=  EntityStore::ACTIVE; }
+    void deactivate() { flags() &= ~EntityStore::ACTIVE; }
     void displayCollider();
     void forceAnimationStart();
 
 
-    bool isActive() { return mEntityStatus == ACTIVE ? true : false; }
+    bool isActive() const { return (flags() & EntityStore::ACTIVE) != 0; }
+
+    // Hands the entity's lifetime, frame timer and motion to
+    // EntityStore::integrate; Entity::update then leaves it alone. Only for
+    // animated effects that stay in the WALK state.
+    void setBulkIntegrated(bool bulk)
+        { if (bulk) flags() |= EntityStore::BULK; else flags() &= ~EntityStore::BULK; }
+    bool isBulkIntegrated() const { return (flags() & EntityStore::BULK) != 0; }
 
-    void moveUp()    { mMovement.y = -1; mDirection = UP;    }
-    void moveDown()  { mMovement.y =  1; mDirection = DOWN;  }
-    void moveLeft()  { mMovement.x = -1; mDirection = LEFT;  }
-    void moveRight() { mMovement.x =  1; mDirection = RIGHT; }
+    void moveUp()    { movement().y = -1; mDirection = UP;    }
+    void moveDown()  { movement().y =  1; mDirection = DOWN;  }
+    void moveLeft()  { movement().x = -1; mDirection = LEFT;  }
+    void moveRight() { movement().x =  1; mDirection = RIGHT; }
     void moveTo(Vector2 target, float speed);
 
-    void resetMovement() { mMovement = { 0.0f, 0.0f }; }
+    void resetMovement() { movement() = { 0.0f, 0.0f }; }
     Vector2 moveTarget = {0,0};
     float moveSpeed = 0.0f;
     bool isMoving = false;
     float mHomingSpeed = 200.0f;
 
 
-    Vector2     getPosition()              const { return mPosition;              }
-    Vector2     getMovement()              const { return mMovement;              }
-    Vector2     getVelocity()              const { return mVelocity;              }
+    Vector2     getPosition()              const { return position();             }
+    // Where render() draws it: between the last two ticks (EntityStore::blend)
+    Vector2     getRenderPosition()        const { return EntityStore::renderPosition(mSlot); }
+    Vector2     getMovement()              const { return movement();             }
+    Vector2     getVelocity()              const { return velocity();             }
     Vector2     getAcceleration()          const { return mAcceleration;          }
     Vector2     getScale()                 const { return mScale;                 }
     Vector2     getColliderDimensions()    const { return mColliderDimensions;    }
     Vector2     getSpriteSheetDimensions() const { return mSpriteSheetDimensions; }
-    Texture2D   getTexture()               const { return mTexture;               }
+    int         getSheet()                 const { return mSheet;                 }
     TextureType getTextureType()           const { return mTextureType;           }
-    size_t      getAnimationIndicesSize()  const { return mAnimationIndices.size(); }
+    size_t      getAnimationIndicesSize()  const { return frameCount();           }
     Direction   getDirection()             const { return mDirection;             }
-    int         getFrameSpeed()            const { return mFrameSpeed;            }
+    int         getFrameSpeed()            const { return frameSpeed();           }
     float       getJumpingPower()          const { return mJumpingPower;          }
     bool        isJumping()                const { return mIsJumping;             }
-    int         getSpeed()                 const { return mSpeed;                 }
+    int         getSpeed()                 const { return speed();                }
     float       getAngle()                 const { return mAngle;                 }
     EntityType  getEntityType()            const { return mEntityType;            }
     AIType      getAIType()                const { return mAIType;                }
@@ -177,6 +283,7 @@ public:
     bool        getCheckCollision()        const { return mCheckCollision;        }
     EntityState getEntityState()           const { return mEntityState;           }
     bool        getIsEffect()              const { return mIsEffect;              }
+    EntityHandle getHandle()               const { return mHandle;                }
 
     void setTarget(Entity* target) { mTarget = target; }
     Entity* getTarget() const { return mTarget; }
@@ -188,30 +295,31 @@ public:
     bool isCollidingLeft()    const { return mIsCollidingLeft;    }
     bool isCollidingRight() const { return mIsCollidingRight; }
 
-    std::map<Direction, std::vector<int>> getWalkAnimations() const { return mWalkAnimations; }
-    std::map<EntityState, std::vector<int>> getAttackAnimations() const { return mAttackAnimations; }
+    const std::map<Direction, std::vector<int>> &getWalkAnimations() const 
+        { return AnimationClips::walkAtlas(mWalkSet); }
+    const std::map<EntityState, std::vector<int>> &getAttackAnimations() const 
+        { return AnimationClips::attackAtlas(mAttackSet); }
 
     void setPosition(Vector2 newPosition)
-        { mPosition = newPosition; 
+        { position() = newPosition; 
             mOriginalPos = newPosition;            }
     void setOriginalPos(Vector2 newOriginalPos)
         { mOriginalPos = newOriginalPos;          }
     void setMovement(Vector2 newMovement)
-        { mMovement = newMovement;                 }
+        { movement() = newMovement;                }
     void setAcceleration(Vector2 newAcceleration)
         { mAcceleration = newAcceleration;         }
     void setScale(Vector2 newScale)
         { mScale = newScale;                       }
-    void setTexture(const char *textureFilepath)
-        { mTexture = LoadTexture(textureFilepath); }
+    void setTexture(const char *textureFilepath);
     void setColliderDimensions(Vector2 newDimensions) 
         { mColliderDimensions = newDimensions;     }
     void setSpriteSheetDimensions(Vector2 newDimensions) 
-        { mSpriteSheetDimensions = newDimensions;  }
+        { mSpriteSheetDimensions = newDimensions; findSheet(SpriteAtlas::getPath(mSheet)); }
     void setSpeed(int newSpeed)
-        { mSpeed  = newSpeed;                      }
+        { speed()  = newSpeed;                     }
     void setFrameSpeed(float newSpeed)
-        { mFrameSpeed = newSpeed;                  }
+        { frameSpeed() = newSpeed;                 }
     void setJumpingPower(float newJumpingPower)
         { mJumpingPower = newJumpingPower;         }
     void setAngle(float newAngle) 
@@ -225,9 +333,9 @@ public:
         if (mTextureType == ATLAS) {
             // Update animation indices based on current state
             if (mEntityState == WALK)
-                mAnimationIndices = mWalkAnimations.at(mDirection);
-            else if (mEntityState == ATTACK && !mAttackAnimations.empty())
-                mAnimationIndices = mAttackAnimations.at(mEntityState);
+                setClip(AnimationClips::walkClip(mWalkSet, mDirection));
+            else if (mEntityState == ATTACK && mAttackSet != AnimationClips::NO_CLIP)
+                setClip(AnimationClips::attackClip(mAttackSet, mEntityState));
         }
     }
     void setAIState(AIState newState)
@@ -240,12 +348,14 @@ public:
     void setEntityState(EntityState state)  
         { 
             mEntityState = state;
-            mCurrentFrameIndex = 0;  // Reset animation when state changes
+            frameIndex() = 0;  // Reset animation when state changes
         }
-    void setWalkAnimations(std::map<Direction, std::vector<int>> animations)
-        { mWalkAnimations = animations;            }
-    void setAttackAnimations(std::map<EntityState, std::vector<int>> animations)
-        { mAttackAnimations = animations;          } 
+    void setWalkAnimations(const std::map<Direction, std::vector<int>> &animations)
+        { mWalkSet = AnimationClips::internWalkSet(animations);     }
+    void setWalkAnimations(int walkSet)
+        { mWalkSet = walkSet;                      }
+    void setAttackAnimations(const std::map<EntityState, std::vector<int>> &animations)
+        { mAttackSet = AnimationClips::internAttackSet(animations); }
     
     void resize(Vector2 newSize)
     {
@@ -257,7 +367,8 @@ public:
         };
     }
     void setIsEffect(bool effect) { mIsEffect = effect; }
-    int getCurrentFrameIndex() const { return mCurrentFrameIndex; }
+    void setHandle(EntityHandle handle) { mHandle = handle; }
+    int getCurrentFrameIndex() const { return frameIndex(); }
 
     void setAttackType(AutoAttackType type) { mAttackType = type; }
     void setAttackRadius(float r) { mAttackRadius = r; }
@@ -295,6 +406,16 @@ public:
         if (mCurrentHP > mMaxHP) mCurrentHP = mMaxHP;
     }
     bool overlaps(Entity* other) const { return isColliding(other); }
+    // overlaps(), or passed clean through `other` during the last step
+    // (velocity x deltaTime back from here), which a fast projectile can do
+    // between two overlap tests. Overlapping only where the step started
+    // does not count: that was the previous step's hit.
+    bool sweepHits(Entity* other, float deltaTime) const;
+
+    bool isExpAwarded()   const { return mExpAwarded; }
+    void markExpAwarded()       { mExpAwarded = true; }
+    int  getPierceRemaining() const { return mPierceRemaining; }
+    void setPierceRemaining(int count) { mPierceRemaining = count; }
 
         // -------- find owner --------
     void  setOwner(Entity* owner) { mOwner = owner; }
@@ -0,0 +1,57 @@
+#include "EntityPool.h"
+
+EntityPool::~EntityPool() { free(); }
+
+void EntityPool::allocate(int capacity)
+{
+    free();
+
+    mSlots    = new Entity[capacity];
+    mCapacity = capacity;
+
+    // hand out low slots first, so a quiet scene stays in a few cache lines
+    mFreeSlots.reserve(capacity);
+    for (int i = capacity - 1; i >= 0; i--) mFreeSlots.push_back(i);
+    mSlotInUse.assign(capacity, 0);
+
+    for (int i = 0; i < capacity; i++) mSlots[i].deactivate();
+}
+
+void EntityPool::free()
+{
+    delete[] mSlots;
+    mSlots    = nullptr;
+    mCapacity = 0;
+    mFreeSlots.clear();
+    mSlotInUse.clear();
+    mPeakInUse = 0;
+    mExhaustedCount = 0;
+}
+
+Entity *EntityPool::acquire()
+{
+    if (mFreeSlots.empty())
+    {
+        mExhaustedCount++;
+        return nullptr;
+    }
+
+    int slot = mFreeSlots.back();
+    mFreeSlots.pop_back();
+    mSlotInUse[slot] = 1;
+
+    if (getInUse() > mPeakInUse) mPeakInUse = getInUse();
+    return &mSlots[slot];
+}
+
+void EntityPool::release(Entity *entity)
+{
+    if (!owns(entity)) return;
+
+    int slot = (int) (entity - mSlots);
+    if (!mSlotInUse[slot]) return;
+
+    mSlotInUse[slot] = 0;
+    entity->deactivate();
+    mFreeSlots.push_back(slot);
+}
@@ -0,0 +1,52 @@
+#include "Entity.h"
+
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+/**
+ * Fixed block of entities handed out through a free list, for short-lived
+ * effects (bullets, arrows, laser beams). `acquire()` pops a slot and
+ * `release()` pushes it back, both O(1) and neither touches the heap once the
+ * block exists, so steady-state firing costs no allocations. Callers give a
+ * slot its state with `Entity::respawn`.
+ *
+ * The block is allocated by `allocate()` and freed by `free()`, so scenes
+ * without effects never pay for it. Slots must never be `delete`d.
+ */
+class EntityPool
+{
+private:
+    Entity *mSlots = nullptr;
+    int     mCapacity = 0;
+    std::vector<int> mFreeSlots; // stack of unused slot indices
+    std::vector<unsigned char> mSlotInUse; // guards against double release
+
+    int mPeakInUse = 0;
+    int mExhaustedCount = 0; // acquires that found the pool empty
+
+public:
+    EntityPool() = default;
+    ~EntityPool();
+
+    EntityPool(const EntityPool &) = delete;
+    EntityPool &operator=(const EntityPool &) = delete;
+
+    void allocate(int capacity);
+    void free();
+
+    // nullptr when every slot is in use
+    Entity *acquire();
+    void release(Entity *entity);
+
+    bool owns(const Entity *entity) const
+    {
+        return entity >= mSlots && entity < mSlots + mCapacity;
+    }
+
+    int getCapacity()       const { return mCapacity;                           }
+    int getInUse()          const { return mCapacity - (int) mFreeSlots.size(); }
+    int getPeakInUse()      const { return mPeakInUse;                          }
+    int getExhaustedCount() const { return mExhaustedCount;                     }
+};
+
+#endif // ENTITY_POOL_H
@@ -0,0 +1,80 @@
+#include "EntityRegistry.h"
+
+EntityHandle EntityRegistry::add(Entity *entity)
+{
+    int slot;
+    if (!mFreeSlots.empty())
+    {
+        slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    else
+    {
+        slot = (int) mSlots.size();
+        Slot fresh = { -1, 0 };
+        mSlots.push_back(fresh);
+    }
+
+    mSlots[slot].denseIndex = (int) mEntities->size();
+    mEntities->push_back(entity);
+
+    EntityHandle handle(slot, mSlots[slot].generation);
+    entity->setHandle(handle);
+    return handle;
+}
+
+Entity *EntityRegistry::get(EntityHandle handle) const
+{
+    if (handle.index < 0 || handle.index >= (int) mSlots.size()) return nullptr;
+
+    const Slot &slot = mSlots[handle.index];
+    if (slot.generation != handle.generation || slot.denseIndex < 0) return nullptr;
+
+    return (*mEntities)[slot.denseIndex];
+}
+
+bool EntityRegistry::remove(Entity *entity)
+{
+    if (entity == nullptr || get(entity->getHandle()) != entity) return false;
+
+    // retire the handle now; the slot itself is freed by flush()
+    mSlots[entity->getHandle().index].generation++;
+    entity->deactivate();
+    mPendingRemoval.push_back(entity);
+    return true;
+}
+
+void EntityRegistry::flush(std::vector<Entity*> &removed)
+{
+    for (Entity *entity : mPendingRemoval)
+    {
+        int slot  = entity->getHandle().index;
+        int index = mSlots[slot].denseIndex;
+
+        // move the last entry into the hole and tell its slot where it went
+        Entity *last = mEntities->back();
+        (*mEntities)[index] = last;
+        if (last != nullptr && last->getHandle().index >= 0)
+            mSlots[last->getHandle().index].denseIndex = index;
+        mEntities->pop_back();
+
+        mSlots[slot].denseIndex = -1;
+        mFreeSlots.push_back(slot);
+        entity->setHandle(EntityHandle());
+        removed.push_back(entity);
+    }
+    mPendingRemoval.clear();
+}
+
+void EntityRegistry::clear()
+{
+    for (size_t slot = 0; slot < mSlots.size(); ++slot)
+    {
+        if (mSlots[slot].denseIndex < 0) continue;
+
+        mSlots[slot].denseIndex = -1;
+        mSlots[slot].generation++;
+        mFreeSlots.push_back((int) slot);
+    }
+    mPendingRemoval.clear();
+}
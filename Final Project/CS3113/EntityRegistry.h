@@ -0,0 +1,57 @@
+#include "Entity.h"
+
+#ifndef ENTITY_REGISTRY_H
+#define ENTITY_REGISTRY_H
+
+/**
+ * Slot table behind a scene's entity list. The list stays a plain vector of
+ * pointers (GameState::collidableEntities), so every loop over it is left
+ * alone; the registry remembers where in that vector each entity sits and
+ * hands out EntityHandles that can be checked for staleness in O(1).
+ *
+ * Removal is deferred. `remove()` deactivates the entity and retires its
+ * handle straight away, but the pointer stays in the list until `flush()`,
+ * which the scene runs once at the end of the tick and which takes each
+ * removed entity out by swapping the last entry into its place. Nothing
+ * iterating the list mid-tick sees it move, and no removal is O(n). The list
+ * is therefore unordered.
+ *
+ * Once a scene registers entities, additions and removals must all go through
+ * the registry; a raw push_back or erase would desync the slot table.
+ */
+class EntityRegistry
+{
+private:
+    struct Slot
+    {
+        int          denseIndex; // position in the list, -1 when free
+        unsigned int generation; // bumped whenever the slot's entity is removed
+    };
+
+    std::vector<Entity*> *mEntities = nullptr;
+    std::vector<Slot>    mSlots;
+    std::vector<int>     mFreeSlots;      // stack of reusable slot indices
+    std::vector<Entity*> mPendingRemoval; // removed this tick, still in the list
+
+public:
+    void bind(std::vector<Entity*> *entities) { mEntities = entities; }
+
+    // Appends the entity to the list and returns its handle
+    EntityHandle add(Entity *entity);
+    // The entity, or nullptr once it has been removed
+    Entity *get(EntityHandle handle) const;
+    // Deactivates the entity and queues it for flush(); false if it is not
+    // registered or was already removed
+    bool remove(Entity *entity);
+    // Swap-and-pops every queued entity out of the list and hands them back
+    // (in `removed`) for the caller to free
+    void flush(std::vector<Entity*> &removed);
+    // Forgets every entity without touching the list; handles given out so
+    // far stay stale, they never come back to life on a reused slot
+    void clear();
+
+    int getLiveCount()    const { return (int) (mSlots.size() - mFreeSlots.size()); }
+    int getPendingCount() const { return (int) mPendingRemoval.size(); }
+};
+
+#endif // ENTITY_REGISTRY_H
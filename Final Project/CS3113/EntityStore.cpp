@@ -0,0 +1,396 @@
+#include "EntityStore.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ENTITY_STORE_X86
+#include <immintrin.h>
+#endif
+
+std::vector<Vector2>       EntityStore::positions;
+std::vector<Vector2>       EntityStore::previousPositions;
+std::vector<Vector2>       EntityStore::movements;
+std::vector<Vector2>       EntityStore::velocities;
+std::vector<int>           EntityStore::speeds;
+std::vector<float>         EntityStore::lifetimes;
+std::vector<float>         EntityStore::animationTimes;
+std::vector<float>         EntityStore::frameSpeeds;
+std::vector<int>           EntityStore::frameIndices;
+std::vector<int>           EntityStore::frameCounts;
+std::vector<unsigned char> EntityStore::flags;
+std::vector<unsigned int>  EntityStore::expiredMask;
+float                      EntityStore::blend = 1.0f;
+
+static std::vector<int> gFreeSlots;
+static int gKernel       = -1; // EntityStore::Kernel once chosen
+static int gExpiredCount = 0;
+
+int EntityStore::allocate()
+{
+    int slot;
+    if (!gFreeSlots.empty())
+    {
+        slot = gFreeSlots.back();
+        gFreeSlots.pop_back();
+    }
+    else
+    {
+        slot = (int) flags.size();
+        positions.push_back({ 0.0f, 0.0f });
+        previousPositions.push_back({ 0.0f, 0.0f });
+        movements.push_back({ 0.0f, 0.0f });
+        velocities.push_back({ 0.0f, 0.0f });
+        speeds.push_back(0);
+        lifetimes.push_back(-1.0f);
+        animationTimes.push_back(0.0f);
+        frameSpeeds.push_back(0.0f);
+        frameIndices.push_back(0);
+        frameCounts.push_back(0);
+        flags.push_back(0);
+    }
+
+    positions[slot]      = { 0.0f, 0.0f };
+    previousPositions[slot] = { 0.0f, 0.0f };
+    movements[slot]      = { 0.0f, 0.0f };
+    velocities[slot]     = { 0.0f, 0.0f };
+    speeds[slot]         = 0;
+    lifetimes[slot]      = -1.0f;
+    animationTimes[slot] = 0.0f;
+    frameSpeeds[slot]    = 0.0f;
+    frameIndices[slot]   = 0;
+    frameCounts[slot]    = 0;
+    flags[slot]          = IN_USE | ACTIVE | FRESH;
+
+    return slot;
+}
+
+void EntityStore::release(int slot)
+{
+    if (slot < 0 || slot >= (int) flags.size() || !(flags[slot] & IN_USE)) return;
+
+    flags[slot] = 0;
+    gFreeSlots.push_back(slot);
+}
+
+static const unsigned char BULK_ACTIVE = 
+    EntityStore::IN_USE | EntityStore::ACTIVE | EntityStore::BULK;
+
+static void markExpired(int slot)
+{
+    EntityStore::flags[slot] &= ~EntityStore::ACTIVE;
+    EntityStore::expiredMask[slot >> 5] |= 1u << (slot & 31);
+    gExpiredCount++;
+}
+
+/**
+ * The reference implementation, one slot at a time. The SIMD kernels use it
+ * for the slots left over after their last full step.
+ */
+static void integrateScalar(int first, int count, float deltaTime)
+{
+    for (int i = first; i < count; i++)
+    {
+        if ((EntityStore::flags[i] & BULK_ACTIVE) != BULK_ACTIVE) continue;
+
+        float &lifetime = EntityStore::lifetimes[i];
+        if (lifetime > 0.0f)
+        {
+            lifetime -= deltaTime;
+            if (lifetime <= 0.0f)
+            {
+                markExpired(i);
+                continue;
+            }
+        }
+
+        int frameCount = EntityStore::frameCounts[i];
+        if (frameCount > 0)
+        {
+            float &animationTime = EntityStore::animationTimes[i];
+            animationTime += deltaTime;
+            if (animationTime >= EntityStore::frameSpeeds[i])
+            {
+                animationTime = 0.0f;
+                int next = EntityStore::frameIndices[i] + 1;
+                EntityStore::frameIndices[i] = next < frameCount ? next : 0;
+            }
+        }
+
+        Vector2 movement = EntityStore::movements[i];
+        if (lifetime > 0.0f || movement.x != 0.0f || movement.y != 0.0f)
+        {
+            Vector2 &velocity = EntityStore::velocities[i];
+            Vector2 &position = EntityStore::positions[i];
+
+            velocity.x = movement.x * EntityStore::speeds[i];
+            velocity.y = movement.y * EntityStore::speeds[i];
+
+            position.x += velocity.x * deltaTime;
+            position.y += velocity.y * deltaTime;
+        }
+    }
+}
+
+#ifdef ENTITY_STORE_X86
+
+/*
+ * Both kernels follow integrateScalar lane for lane. Every per-slot array is
+ * loaded as one vector per step; positions, movements and velocities hold an
+ * x/y pair per slot, so the per-slot masks and speeds are widened to pairs
+ * before they are applied to those.
+ */
+
+__attribute__((target("sse2")))
+static inline __m128 select128(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+__attribute__((target("sse2")))
+static void integrateSSE2(int count, float deltaTime)
+{
+    const __m128  dt      = _mm_set1_ps(deltaTime);
+    const __m128  zero    = _mm_setzero_ps();
+    const __m128i zeroInt = _mm_setzero_si128();
+    const __m128i oneInt  = _mm_set1_epi32(1);
+    const __m128i wanted  = _mm_set1_epi32(BULK_ACTIVE);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        int packedFlags;
+        memcpy(&packedFlags, &EntityStore::flags[i], sizeof(packedFlags));
+        __m128i laneFlags = _mm_cvtsi32_si128(packedFlags);
+        laneFlags = _mm_unpacklo_epi8(laneFlags, zeroInt);
+        laneFlags = _mm_unpacklo_epi16(laneFlags, zeroInt);
+        __m128 active = _mm_castsi128_ps(
+            _mm_cmpeq_epi32(_mm_and_si128(laneFlags, wanted), wanted));
+        if (_mm_movemask_ps(active) == 0) continue;
+
+        // lifetime
+        float  *lifetimes = &EntityStore::lifetimes[i];
+        __m128 lifetime   = _mm_loadu_ps(lifetimes);
+        __m128 counting   = _mm_and_ps(active, _mm_cmpgt_ps(lifetime, zero));
+        lifetime = select128(counting, _mm_sub_ps(lifetime, dt), lifetime);
+        _mm_storeu_ps(lifetimes, lifetime);
+
+        __m128 expired = _mm_and_ps(counting, _mm_cmple_ps(lifetime, zero));
+        __m128 alive   = _mm_andnot_ps(expired, active);
+
+        // animation frame
+        __m128i frameCount = _mm_loadu_si128((const __m128i *) &EntityStore::frameCounts[i]);
+        __m128i frameIndex = _mm_loadu_si128((const __m128i *) &EntityStore::frameIndices[i]);
+        __m128  animated   = _mm_and_ps(alive, 
+            _mm_castsi128_ps(_mm_cmpgt_epi32(frameCount, zeroInt)));
+
+        float  *animationTimes = &EntityStore::animationTimes[i];
+        __m128 animationTime   = _mm_loadu_ps(animationTimes);
+        __m128 advanced        = _mm_add_ps(animationTime, dt);
+        __m128 stepped         = _mm_and_ps(animated, 
+            _mm_cmpge_ps(advanced, _mm_loadu_ps(&EntityStore::frameSpeeds[i])));
+        advanced = _mm_andnot_ps(stepped, advanced); // 0 on a frame step
+        _mm_storeu_ps(animationTimes, select128(animated, advanced, animationTime));
+
+        __m128i next = _mm_add_epi32(frameIndex, oneInt);
+        next = _mm_and_si128(next, _mm_cmplt_epi32(next, frameCount)); // wrap to 0
+        __m128i steppedInt = _mm_castps_si128(stepped);
+        frameIndex = _mm_or_si128(_mm_and_si128(steppedInt, next), 
+            _mm_andnot_si128(steppedInt, frameIndex));
+        _mm_storeu_si128((__m128i *) &EntityStore::frameIndices[i], frameIndex);
+
+        // motion, two slots per register
+        float *movements  = &EntityStore::movements[i].x;
+        float *velocities = &EntityStore::velocities[i].x;
+        float *positions  = &EntityStore::positions[i].x;
+
+        __m128 speed   = _mm_cvtepi32_ps(
+            _mm_loadu_si128((const __m128i *) &EntityStore::speeds[i]));
+        __m128 timed   = _mm_cmpgt_ps(lifetime, zero);
+
+        for (int half = 0; half < 2; half++)
+        {
+            __m128 pairSpeed = half == 0 ? _mm_unpacklo_ps(speed, speed) 
+                                         : _mm_unpackhi_ps(speed, speed);
+            __m128 pairAlive = half == 0 ? _mm_unpacklo_ps(alive, alive) 
+                                         : _mm_unpackhi_ps(alive, alive);
+            __m128 pairTimed = half == 0 ? _mm_unpacklo_ps(timed, timed) 
+                                         : _mm_unpackhi_ps(timed, timed);
+
+            __m128 movement = _mm_loadu_ps(movements + half * 4);
+            __m128 moving   = _mm_cmpneq_ps(movement, zero);
+            moving = _mm_or_ps(moving, _mm_shuffle_ps(moving, moving, _MM_SHUFFLE(2, 3, 0, 1)));
+            moving = _mm_and_ps(pairAlive, _mm_or_ps(pairTimed, moving));
+
+            __m128 velocity = _mm_mul_ps(movement, pairSpeed);
+            __m128 position = _mm_loadu_ps(positions + half * 4);
+            _mm_storeu_ps(velocities + half * 4, 
+                select128(moving, velocity, _mm_loadu_ps(velocities + half * 4)));
+            _mm_storeu_ps(positions + half * 4, 
+                select128(moving, _mm_add_ps(position, _mm_mul_ps(velocity, dt)), position));
+        }
+
+        int expiredLanes = _mm_movemask_ps(expired);
+        for (int lane = 0; lane < 4; lane++)
+            if (expiredLanes & (1 << lane)) markExpired(i + lane);
+    }
+
+    integrateScalar(i, count, deltaTime);
+}
+
+__attribute__((target("avx2")))
+static void integrateAVX2(int count, float deltaTime)
+{
+    const __m256  dt      = _mm256_set1_ps(deltaTime);
+    const __m256  zero    = _mm256_setzero_ps();
+    const __m256i zeroInt = _mm256_setzero_si256();
+    const __m256i oneInt  = _mm256_set1_epi32(1);
+    const __m256i wanted  = _mm256_set1_epi32(BULK_ACTIVE);
+    const __m256i lowPairs  = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i highPairs = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i laneFlags = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i *) &EntityStore::flags[i]));
+        __m256 active = _mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(_mm256_and_si256(laneFlags, wanted), wanted));
+        if (_mm256_movemask_ps(active) == 0) continue;
+
+        // lifetime
+        float  *lifetimes = &EntityStore::lifetimes[i];
+        __m256 lifetime   = _mm256_loadu_ps(lifetimes);
+        __m256 counting   = _mm256_and_ps(active, _mm256_cmp_ps(lifetime, zero, _CMP_GT_OQ));
+        lifetime = _mm256_blendv_ps(lifetime, _mm256_sub_ps(lifetime, dt), counting);
+        _mm256_storeu_ps(lifetimes, lifetime);
+
+        __m256 expired = _mm256_and_ps(counting, _mm256_cmp_ps(lifetime, zero, _CMP_LE_OQ));
+        __m256 alive   = _mm256_andnot_ps(expired, active);
+
+        // animation frame
+        __m256i frameCount = _mm256_loadu_si256((const __m256i *) &EntityStore::frameCounts[i]);
+        __m256i frameIndex = _mm256_loadu_si256((const __m256i *) &EntityStore::frameIndices[i]);
+        __m256  animated   = _mm256_and_ps(alive, 
+            _mm256_castsi256_ps(_mm256_cmpgt_epi32(frameCount, zeroInt)));
+
+        float  *animationTimes = &EntityStore::animationTimes[i];
+        __m256 animationTime   = _mm256_loadu_ps(animationTimes);
+        __m256 advanced        = _mm256_add_ps(animationTime, dt);
+        __m256 stepped         = _mm256_and_ps(animated, _mm256_cmp_ps(advanced, 
+            _mm256_loadu_ps(&EntityStore::frameSpeeds[i]), _CMP_GE_OQ));
+        advanced = _mm256_andnot_ps(stepped, advanced); // 0 on a frame step
+        _mm256_storeu_ps(animationTimes, _mm256_blendv_ps(animationTime, advanced, animated));
+
+        __m256i next = _mm256_add_epi32(frameIndex, oneInt);
+        next = _mm256_and_si256(next, _mm256_cmpgt_epi32(frameCount, next)); // wrap to 0
+        frameIndex = _mm256_blendv_epi8(frameIndex, next, _mm256_castps_si256(stepped));
+        _mm256_storeu_si256((__m256i *) &EntityStore::frameIndices[i], frameIndex);
+
+        // motion, four slots per register
+        float *movements  = &EntityStore::movements[i].x;
+        float *velocities = &EntityStore::velocities[i].x;
+        float *positions  = &EntityStore::positions[i].x;
+
+        __m256 speed = _mm256_cvtepi32_ps(
+            _mm256_loadu_si256((const __m256i *) &EntityStore::speeds[i]));
+        __m256 timed = _mm256_cmp_ps(lifetime, zero, _CMP_GT_OQ);
+
+        for (int half = 0; half < 2; half++)
+        {
+            __m256i pairs     = half == 0 ? lowPairs : highPairs;
+            __m256  pairSpeed = _mm256_permutevar8x32_ps(speed, pairs);
+            __m256  pairAlive = _mm256_permutevar8x32_ps(alive, pairs);
+            __m256  pairTimed = _mm256_permutevar8x32_ps(timed, pairs);
+
+            __m256 movement = _mm256_loadu_ps(movements + half * 8);
+            __m256 moving   = _mm256_cmp_ps(movement, zero, _CMP_NEQ_UQ);
+            moving = _mm256_or_ps(moving, _mm256_permute_ps(moving, _MM_SHUFFLE(2, 3, 0, 1)));
+            moving = _mm256_and_ps(pairAlive, _mm256_or_ps(pairTimed, moving));
+
+            __m256 velocity = _mm256_mul_ps(movement, pairSpeed);
+            __m256 position = _mm256_loadu_ps(positions + half * 8);
+            _mm256_storeu_ps(velocities + half * 8, 
+                _mm256_blendv_ps(_mm256_loadu_ps(velocities + half * 8), velocity, moving));
+            _mm256_storeu_ps(positions + half * 8, _mm256_blendv_ps(position, 
+                _mm256_add_ps(position, _mm256_mul_ps(velocity, dt)), moving));
+        }
+
+        int expiredLanes = _mm256_movemask_ps(expired);
+        for (int lane = 0; lane < 8; lane++)
+            if (expiredLanes & (1 << lane)) markExpired(i + lane);
+    }
+
+    integrateScalar(i, count, deltaTime);
+}
+
+#endif // ENTITY_STORE_X86
+
+static bool kernelSupported(EntityStore::Kernel kernel)
+{
+    switch (kernel)
+    {
+        case EntityStore::SCALAR: return true;
+#ifdef ENTITY_STORE_X86
+        case EntityStore::SSE2:   return __builtin_cpu_supports("sse2");
+        case EntityStore::AVX2:   return __builtin_cpu_supports("avx2");
+#endif
+        default:                  return false;
+    }
+}
+
+EntityStore::Kernel EntityStore::getKernel()
+{
+    if (gKernel < 0)
+    {
+        if      (kernelSupported(AVX2)) gKernel = AVX2;
+        else if (kernelSupported(SSE2)) gKernel = SSE2;
+        else                            gKernel = SCALAR;
+    }
+    return (Kernel) gKernel;
+}
+
+bool EntityStore::setKernel(Kernel kernel)
+{
+    if (!kernelSupported(kernel)) return false;
+    gKernel = kernel;
+    return true;
+}
+
+const char *EntityStore::getKernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case SSE2: return "SSE2";
+        case AVX2: return "AVX2";
+        default:   return "scalar";
+    }
+}
+
+void EntityStore::integrate(float deltaTime)
+{
+    const int count = (int) flags.size();
+
+    expiredMask.assign((count + 31) / 32, 0u);
+    gExpiredCount = 0;
+
+    switch (getKernel())
+    {
+#ifdef ENTITY_STORE_X86
+        case AVX2: integrateAVX2(count, deltaTime); break;
+        case SSE2: integrateSSE2(count, deltaTime); break;
+#endif
+        default:   integrateScalar(0, count, deltaTime); break;
+    }
+}
+
+int EntityStore::getExpiredCount() { return gExpiredCount; }
+
+void EntityStore::snapshot()
+{
+    previousPositions = positions; // same size, so no reallocation
+
+    for (size_t slot = 0; slot < flags.size(); slot++)
+        flags[slot] &= ~FRESH;
+}
+
+int EntityStore::getLiveCount() { return (int) (flags.size() - gFreeSlots.size()); }
+int EntityStore::getCapacity()  { return (int) flags.size(); }
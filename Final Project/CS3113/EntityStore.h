@@ -0,0 +1,95 @@
+#include "cs3113.h"
+
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+/**
+ * Process-wide structure-of-arrays home for the per-tick entity state:
+ * position, movement, velocity, speed, lifetime, animation timer/frame and
+ * status flags. Every Entity owns one slot for its whole life and reads and
+ * writes these fields through it, so the Entity API is unchanged while the
+ * hot data of all live entities sits in a handful of contiguous arrays.
+ *
+ * Entities flagged BULK (the scene's pooled projectiles and beams) are not
+ * advanced by Entity::update at all; `integrate()` walks the arrays once per
+ * tick instead, touching only the bytes it needs rather than a whole Entity
+ * (and its map/vector members) per projectile.
+ *
+ * Slots are reused but the arrays only grow, so a reference into them must
+ * not be held across the construction of another Entity.
+ */
+class EntityStore
+{
+public:
+    enum Flag
+    {
+        IN_USE = 1 << 0, // slot belongs to a live Entity
+        ACTIVE = 1 << 1, // mirrors Entity::isActive()
+        BULK   = 1 << 2, // advanced by integrate() instead of Entity::update
+        FRESH  = 1 << 3  // (re)spawned since the last snapshot(): no history
+    };
+
+    static std::vector<Vector2>       positions;
+    static std::vector<Vector2>       previousPositions; // as of the last snapshot()
+    static std::vector<Vector2>       movements;
+    static std::vector<Vector2>       velocities;
+    static std::vector<int>           speeds;
+    static std::vector<float>         lifetimes;      // <= 0 means infinite
+    static std::vector<float>         animationTimes;
+    static std::vector<float>         frameSpeeds;    // seconds per frame
+    static std::vector<int>           frameIndices;
+    static std::vector<int>           frameCounts;    // size of the current animation
+    static std::vector<unsigned char> flags;
+
+    // One bit per slot (slot / 32, bit slot % 32), set for every slot whose
+    // lifetime ran out during the last integrate()
+    static std::vector<unsigned int>  expiredMask;
+
+    // Where between the last snapshot and the current state the frame being
+    // drawn sits (0 = previous, 1 = current); main sets it from its
+    // SimulationClock before rendering. 1 unless something sets it.
+    static float blend;
+
+    // integrate() implementations; picked from the CPU on first use
+    enum Kernel { SCALAR, SSE2, AVX2 };
+
+    // Returns a zeroed, active slot, reusing a released one when possible.
+    static int  allocate();
+    static void release(int slot);
+
+    /**
+     * One linear pass over every BULK slot, doing exactly what
+     * Entity::update does for an animated effect: count the lifetime down
+     * and deactivate on expiry, loop the frame timer, then move by
+     * movement * speed. Slots that expire are recorded in expiredMask.
+     *
+     * The AVX2 and SSE2 kernels do 8 and 4 slots per step and give the same
+     * results as the scalar one; other CPUs (and compilers without x86
+     * intrinsics) get the scalar loop.
+     */
+    static void integrate(float deltaTime);
+    static int  getExpiredCount();
+
+    // Copies every position into previousPositions and clears FRESH; main
+    // runs this before each fixed step
+    static void snapshot();
+    // Position to draw the slot at: previous and current blended, or just
+    // the current one for a FRESH slot (nothing to blend from yet)
+    static Vector2 renderPosition(int slot)
+    {
+        if (flags[slot] & FRESH) return positions[slot];
+        const Vector2 &from = previousPositions[slot];
+        const Vector2 &to   = positions[slot];
+        return { from.x + (to.x - from.x) * blend, from.y + (to.y - from.y) * blend };
+    }
+
+    static Kernel      getKernel();
+    // Forces a kernel (benchmarks); false if this CPU/build can't run it
+    static bool        setKernel(Kernel kernel);
+    static const char *getKernelName(Kernel kernel);
+
+    static int getLiveCount();
+    static int getCapacity();
+};
+
+#endif // ENTITY_STORE_H
@@ -0,0 +1,52 @@
+#include "Input.h"
+#include <algorithm>
+
+static bool             gScripted = false;
+static std::vector<int> gPressedKeys; // this tick only
+static std::vector<int> gHeldKeys;
+
+static bool contains(const std::vector<int> &keys, int key)
+{
+    return std::find(keys.begin(), keys.end(), key) != keys.end();
+}
+
+bool Input::isKeyPressed(int key)
+{
+    return gScripted ? contains(gPressedKeys, key) : IsKeyPressed(key);
+}
+
+bool Input::isKeyDown(int key)
+{
+    return gScripted ? contains(gHeldKeys, key) || contains(gPressedKeys, key)
+                     : IsKeyDown(key);
+}
+
+bool Input::isMouseButtonPressed(int button)
+{
+    // scripts choose from menus with the number keys
+    return gScripted ? false : IsMouseButtonPressed(button);
+}
+
+void Input::startScript()
+{
+    gScripted = true;
+    gPressedKeys.clear();
+    gHeldKeys.clear();
+}
+
+void Input::stopScript() { gScripted = false; }
+bool Input::isScripted() { return gScripted; }
+
+void Input::pressKey(int key)
+{
+    if (!contains(gPressedKeys, key)) gPressedKeys.push_back(key);
+}
+
+void Input::holdKey(int key, bool down)
+{
+    auto held = std::find(gHeldKeys.begin(), gHeldKeys.end(), key);
+    if (down && held == gHeldKeys.end()) gHeldKeys.push_back(key);
+    else if (!down && held != gHeldKeys.end()) gHeldKeys.erase(held);
+}
+
+void Input::endScriptedTick() { gPressedKeys.clear(); }
@@ -0,0 +1,30 @@
+#include "cs3113.h"
+
+#ifndef INPUT_H
+#define INPUT_H
+
+/**
+ * Keyboard and mouse-button queries for game code. Normally these are just
+ * raylib's. Once a script is started (headless runs, benchmarks) they answer
+ * from whatever the script pressed or held instead, so a level can be driven
+ * tick by tick without a window.
+ */
+class Input
+{
+public:
+    static bool isKeyPressed(int key);
+    static bool isKeyDown(int key);
+    static bool isMouseButtonPressed(int button);
+
+    static void startScript();
+    static void stopScript();
+    static bool isScripted();
+
+    // Pressed for the current tick only, like a real key press
+    static void pressKey(int key);
+    static void holdKey(int key, bool down);
+    // Call after each scripted tick; clears the presses, keeps held keys
+    static void endScriptedTick();
+};
+
+#endif // INPUT_H
@@ -10,18 +10,19 @@ LevelA::LevelA(Vector2 origin, const char *bgHexCode) : Scene{origin, bgHexCode}
 
 LevelA::~LevelA() {}
 
-Vector2 getRandomSpawnPosition(Vector2 playerPos, float safeRadius, Vector2 origin)
+Vector2 getRandomSpawnPosition(Vector2 playerPos, float safeRadius, Vector2 origin,
+   Random &random)
 {
    float x, y;
    Vector2 pos;
 
    do
    {
-      x = GetRandomValue(
+      x = random.range(
           origin.x - (LEVEL_WIDTH * LevelA::TILE_DIMENSION) / 4,
           origin.x + (LEVEL_WIDTH * LevelA::TILE_DIMENSION) / 4);
 
-      y = GetRandomValue(
+      y = random.range(
           origin.y - (LEVEL_HEIGHT * LevelA::TILE_DIMENSION) / 4,
           origin.y + (LEVEL_HEIGHT * LevelA::TILE_DIMENSION) / 4);
 
@@ -134,10 +135,10 @@ int PLAYER_PROJECTILE_DAMAGE = 1;
 int FLYER_PROJECTILE_DAMAGE = 1;
 
 // Sound effects
-Sound gBloodBulletSound = {0};
-Sound gUpgradeSound = {0};        // Upgrade sound effect
-Sound gChooseUpgradeSound = {0};  // Choose upgrade sound effect
-Sound gPlayerDeadSound = {0};     // Player death sound
+int gBloodBulletSound = VoicePool::NO_SOUND;
+int gUpgradeSound = VoicePool::NO_SOUND;        // Upgrade sound effect
+int gChooseUpgradeSound = VoicePool::NO_SOUND;  // Choose upgrade sound effect
+int gPlayerDeadSound = VoicePool::NO_SOUND;     // Player death sound
 
 // Aura damage cooldown
 float gAuraDamageTimer = 0.0f;
@@ -153,9 +154,6 @@ const int EXP_FOLLOWER = 10;  // LevelA training robot EXP
 const int EXP_WANDERER = 10;  // LevelA training robot EXP
 const int EXP_FLYER = 10;     // LevelA training robot EXP
 
-// Set of enemies that have given EXP (to avoid duplicate EXP)
-std::set<Entity*> gExpGivenEnemies;
-
 // Calculate EXP needed for level up
 int getExpForLevel(int level)
 {
@@ -200,8 +198,8 @@ void checkEnemyDeathAndGiveExp(Entity* enemy)
    if (!enemy->isDead()) return;
    if (enemy->getEntityType() != NPC) return;
    
-   if (gExpGivenEnemies.find(enemy) != gExpGivenEnemies.end()) return;
-   gExpGivenEnemies.insert(enemy);
+   if (enemy->isExpAwarded()) return;
+   enemy->markExpAwarded();
    int exp = getExpFromEnemy(enemy->getAIType());
    addPlayerExp(exp);
 }
@@ -220,14 +218,37 @@ float computeAngleDegFromDir(Vector2 dir, float offsetDeg)
    return angleDeg + offsetDeg;
 }
 
+const AssetManifest &LevelA::getAssetManifest()
+{
+   static const AssetManifest manifest = {
+      {
+         { "assets/hero/Player_run.png", 1, 14 }, { "assets/Tileset.png", 4, 16 },
+         { "assets/Projectiles/BloodBullet7.png", 6, 10 },
+         { "assets/Enemy1/Walk.png", 7, 1 },
+         { "assets/Effects/9_brightfire_spritesheet.png", 8, 8 },
+         { "assets/Effects/17_felspell_spritesheet.png", 10, 10 },
+         { "assets/weapons/weaponSheet.png", 24, 5 },
+         { "assets/weapons/105.png", 1, 1 }, { "assets/weapons/001.png", 1, 1 },
+         { "assets/weapons/002.png", 1, 1 }, { "assets/weapons/003.png", 1, 1 },
+         { "assets/weapons/004.png", 1, 1 }, { "assets/weapons/037.png", 1, 1 },
+         { "assets/weapons/039.png", 1, 1 }, { "assets/weapons/040.png", 1, 1 }
+      },
+      {
+         "assets/bloodBulletShoot.wav", "assets/upgrade.wav", "assets/chooseUpgrade.wav",
+         "assets/playerDead.wav"
+      },
+      { "assets/bgm.mp3" },
+      "assets/atlas/levelA.atlas"
+   };
+   return manifest;
+}
+
 void LevelA::initialise()
 {
    Scene::initialise();
    
-   // Load and play BGM (using main.cpp's bgm)
-   mGameState.bgm = LoadMusicStream("assets/bgm.mp3");
-   SetMusicVolume(mGameState.bgm, 0.33f);
-   PlayMusicStream(mGameState.bgm);
+   // BGM; crossfades from whatever the last scene played
+   MusicPlayer::play("assets/bgm.mp3", 0.33f);
    mGameState.nextSceneID = -1;
 
    mWeaponUpgrades.swordCount = 2;
@@ -255,14 +276,19 @@ void LevelA::initialise()
    mWeaponUpgrades.playerMaxHP = 100;
 
    // Load sound effects
-   gBloodBulletSound = LoadSound("assets/bloodBulletShoot.wav");
-   SetSoundVolume(gBloodBulletSound, 0.2f);
-   gUpgradeSound = LoadSound("assets/upgrade.wav");
-   SetSoundVolume(gUpgradeSound, 0.5f);
-   gChooseUpgradeSound = LoadSound("assets/chooseUpgrade.wav");
-   SetSoundVolume(gChooseUpgradeSound, 0.5f);
-   gPlayerDeadSound = LoadSound("assets/playerDead.wav");
-   SetSoundVolume(gPlayerDeadSound, 0.6f);
+   // voices, cooldown (seconds), priority, volume: see VoicePool
+   gBloodBulletSound = VoicePool::load("assets/bloodBulletShoot.wav",
+      { 3, 0.05f, PRIORITY_LOW, 0.2f });
+   gUpgradeSound = VoicePool::load("assets/upgrade.wav",
+      { 1, 0.0f, PRIORITY_HIGH, 0.5f });
+   gChooseUpgradeSound = VoicePool::load("assets/chooseUpgrade.wav",
+      { 1, 0.0f, PRIORITY_HIGH, 0.5f });
+   gPlayerDeadSound = VoicePool::load("assets/playerDead.wav",
+      { 1, 0.0f, PRIORITY_CRITICAL, 0.6f });
+
+   // Hold every sheet for the whole level: the title scene prefetched them,
+   // and anything unreferenced would be purged right after this switch
+   preloadManifest(getAssetManifest());
    
 
    /*
@@ -308,17 +334,17 @@ void LevelA::initialise()
        {LEFT, projFrames},
        {RIGHT, projFrames}};
 
-   mProjectileAtlas = projectileAtlas;
+   mProjectileAtlas = AnimationClips::internWalkSet(projectileAtlas);
 
    std::vector<int> flyerProjFrames;
    for (int i = 0; i < 64; ++i)
       flyerProjFrames.push_back(i);
 
-   mFlyerProjectileAtlas = {
+   mFlyerProjectileAtlas = AnimationClips::internWalkSet({
        {UP, flyerProjFrames},
        {DOWN, flyerProjFrames},
        {LEFT, flyerProjFrames},
-       {RIGHT, flyerProjFrames}};
+       {RIGHT, flyerProjFrames}});
 
    /*
    std::map<EntityState, std::vector<int>> xochitlAttackAtlas = {
@@ -622,49 +648,22 @@ void LevelA::initialise()
    mLevelUpSelectedIndex = -1;
 }
 
-Entity *LevelA::findClosestEnemy(Vector2 pos)
-{
-   Entity *closest = nullptr;
-   float minDist = 600.0f;
-
-   for (Entity *enemy : mGameState.collidableEntities)
-   {
-      if (enemy == nullptr)
-         continue;
-      if (enemy->getEntityType() != NPC)
-         continue;
-      if (enemy->isDead())
-         continue;
-
-      float d = Vector2Distance(pos, enemy->getPosition());
-      if (d < minDist)
-      {
-         minDist = d;
-         closest = enemy;
-      }
-   }
-   return closest;
-}
-
 void LevelA::update(float deltaTime)
 {
+   // Targeting index is rebuilt on first use each tick (enemies may have
+   // moved or been freed since the last one)
+   mEnemyIndex.invalidate();
+
    // Check if player is dead
    if (mGameState.xochitl != nullptr && mGameState.xochitl->isDead())
    {
-      PlaySound(gPlayerDeadSound); // Play death sound
+      VoicePool::play(gPlayerDeadSound); // Play death sound
       mGameState.nextSceneID = 7; // Lose Scene
       return;
    }
    
-   // 更新BGM（循环播放）
-   UpdateMusicStream(mGameState.bgm);
-   if (IsMusicStreamPlaying(mGameState.bgm) == false)
-   {
-      // 如果音乐播放完毕，重新播放（实现循环）
-      PlayMusicStream(mGameState.bgm);
-   }
    // 跳关功能：按P键快速跳到下一关
-   if (IsKeyPressed(KEY_P))
+   if (Input::isKeyPressed(KEY_P))
    {
       mGameState.nextSceneID = 4; // Go to LevelBTitle
       return;
@@ -681,33 +680,10 @@ void LevelA::update(float deltaTime)
    if (canLevelUp())
    {
       doLevelUp();
-      PlaySound(gUpgradeSound); // 播放升级音效
+      VoicePool::play(gUpgradeSound); // 播放升级音效
       openLevelUpMenu();
    }
 
-   // 清理已删除敌人的经验记录
-   for (auto it = gExpGivenEnemies.begin(); it != gExpGivenEnemies.end();)
-   {
-      Entity* enemy = *it;
-      bool found = false;
-      for (Entity* e : mGameState.collidableEntities)
-      {
-         if (e == enemy)
-         {
-            found = true;
-            break;
-         }
-      }
-      if (!found)
-      {
-         it = gExpGivenEnemies.erase(it);
-      }
-      else
-      {
-         ++it;
-      }
-   }
-
    mGameState.xochitl->update(
        deltaTime,                    // delta time / fixed timestep
        nullptr,                      // player
@@ -728,7 +704,8 @@ void LevelA::update(float deltaTime)
           deltaTime,
           mGameState.xochitl, // 敌人 AI 用这个来追踪玩家
           mGameState.map,     // 敌人 / 子弹和地图的碰撞
-          mGameState.collidableEntities);
+          mGameState.collidableEntities,
+          &mRandom.ai);       // wanderer direction changes
    }
 
    // 3. Flyer 远程攻击（在它们移动完之后决定要不要开枪）
@@ -1001,7 +978,7 @@ void LevelA::update(float deltaTime)
          arrow->setOwner(mGameState.xochitl);
 
          // 初始化穿透计数
-         mArrowPierceCount[arrow] = mWeaponUpgrades.arrowPierce;
+         arrow->setPierceRemaining(mWeaponUpgrades.arrowPierce);
 
          mGameState.collidableEntities.push_back(arrow);
          continue;
@@ -1224,34 +1201,11 @@ void LevelA::update(float deltaTime)
       bullet->setSpawnInvincible(0.0f);
       bullet->setAIType(BULLET);
       bullet->setOwner(mGameState.xochitl);
-      PlaySound(gBloodBulletSound);
+      VoicePool::play(gBloodBulletSound);
       mGameState.collidableEntities.push_back(bullet);
    }
 
    // ------------ 统一处理所有飞行弹幕（血弹 + 箭 + 敌人子弹）------------
-   // 清理已失效的箭的穿透计数
-   for (auto it = mArrowPierceCount.begin(); it != mArrowPierceCount.end();)
-   {
-      Entity *arrow = it->first;
-      bool found = false;
-      for (Entity *e : mGameState.collidableEntities)
-      {
-         if (e == arrow)
-         {
-            found = true;
-            break;
-         }
-      }
-      if (!found || !arrow || !arrow->isActive())
-      {
-         it = mArrowPierceCount.erase(it);
-      }
-      else
-      {
-         ++it;
-      }
-   }
-
    const int PLAYER_PROJECTILE_DAMAGE = 5;  // 血弹基础伤害（提高5倍）
    const int FLYER_PROJECTILE_DAMAGE = 10; // 敌人子弹伤害（提高5倍）
    const int ARROW_DAMAGE = 20;            // 弓箭伤害（提高5倍）
@@ -1323,8 +1277,8 @@ void LevelA::update(float deltaTime)
             if (enemy->getEntityType() != NPC)
                continue;
             
-            // 检查子弹是否与敌人重叠
-            if (proj->overlaps(enemy))
+            // 检查子弹本帧是否与敌人重叠（或已飞过敌人）
+            if (proj->sweepHits(enemy, deltaTime))
             {
                hit = enemy;
                hitIsEnemy = true;
@@ -1340,7 +1294,7 @@ void LevelA::update(float deltaTime)
          // 检查是否与任何shield碰撞
          for (Entity *shield : mOrbitShields)
          {
-            if (shield && shield->isActive() && proj->overlaps(shield))
+            if (shield && shield->isActive() && proj->sweepHits(shield, deltaTime))
             {
                // 被shield格挡，不造成伤害
                proj->deactivate();
@@ -1354,7 +1308,7 @@ void LevelA::update(float deltaTime)
          }
          
          // 如果没有被格挡，继续检查是否与玩家碰撞
-         if (proj->overlaps(mGameState.xochitl))
+         if (proj->sweepHits(mGameState.xochitl, deltaTime))
          {
             hit = mGameState.xochitl;
             hitIsPlayer = true;
@@ -1391,13 +1345,12 @@ void LevelA::update(float deltaTime)
          checkEnemyDeathAndGiveExp(hit);
 
          // 如果是箭，检查穿透
-         if (isArrow && mArrowPierceCount.find(proj) != mArrowPierceCount.end())
+         if (isArrow)
          {
-            mArrowPierceCount[proj]--;
-            if (mArrowPierceCount[proj] <= 0)
+            proj->setPierceRemaining(proj->getPierceRemaining() - 1);
+            if (proj->getPierceRemaining() <= 0)
             {
                // 穿透次数用尽，销毁箭
-               mArrowPierceCount.erase(proj);
                proj->deactivate();
             }
             // 否则继续穿透，不销毁
@@ -1468,6 +1421,7 @@ void LevelA::update(float deltaTime)
          }
          ++it;
       }
+      mEnemyIndex.invalidate(); // may have freed enemies
    }
 
    // TUTORIAL: Check if all training bots are killed
@@ -1689,7 +1643,7 @@ void LevelA::openLevelUpMenu()
    // 3) 随机打乱pool（简单的Fisher-Yates shuffle）
    for (int i = (int)pool.size() - 1; i > 0; --i)
    {
-      int j = GetRandomValue(0, i);
+      int j = mRandom.levelUp.range(0, i);
       LevelUpOption temp = pool[i];
       pool[i] = pool[j];
       pool[j] = temp;
@@ -1707,17 +1661,17 @@ void LevelA::openLevelUpMenu()
 void LevelA::handleLevelUpInput()
 {
    // 键盘：1/2/3 直接选
-   if (IsKeyPressed(KEY_ONE) && mLevelUpOptionCount >= 1)
+   if (Input::isKeyPressed(KEY_ONE) && mLevelUpOptionCount >= 1)
    {
       applyUpgradeChoice(0);
       return;
    }
-   if (IsKeyPressed(KEY_TWO) && mLevelUpOptionCount >= 2)
+   if (Input::isKeyPressed(KEY_TWO) && mLevelUpOptionCount >= 2)
    {
       applyUpgradeChoice(1);
       return;
    }
-   if (IsKeyPressed(KEY_THREE) && mLevelUpOptionCount >= 3)
+   if (Input::isKeyPressed(KEY_THREE) && mLevelUpOptionCount >= 3)
    {
       applyUpgradeChoice(2);
       return;
@@ -1749,7 +1703,7 @@ void LevelA::handleLevelUpInput()
       if (CheckCollisionPointRec(mouse, rect))
       {
          mLevelUpSelectedIndex = i;
-         if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+         if (Input::isMouseButtonPressed(MOUSE_LEFT_BUTTON))
          {
             applyUpgradeChoice(i);
             return;
@@ -1761,7 +1715,7 @@ void LevelA::handleLevelUpInput()
 void LevelA::applyUpgradeChoice(int index)
 {
    // 播放选择升级音效
-   PlaySound(gChooseUpgradeSound);
+   VoicePool::play(gChooseUpgradeSound);
    if (index < 0 || index >= mLevelUpOptionCount)
       return;
 
@@ -2412,14 +2366,18 @@ void LevelA::applyUpgradeChoice(int index)
 void LevelA::render()
 {
    ClearBackground(ColorFromHex(mBGColourHexCode));
+   beginCulling();
 
    // 1. 先渲染地图（最底层）
-   mGameState.map->render();
+   SpriteBatch::setLayer(LAYER_MAP);
+   mGameState.map->render(mVisibleArea);
 
    // 2. 渲染Aura（在玩家下面），稍微调暗
+   SpriteBatch::setLayer(LAYER_GROUND);
    for (Entity *entity : mAutoAttacks)
    {
-      if (entity && entity->getAttackType() == AURA && entity->isActive())
+      if (entity && entity->getAttackType() == AURA && entity->isActive() &&
+          isOnScreen(entity))
       {
          // 稍微调暗的颜色（不要太暗）
          Color darkTint = {200, 200, 200, 200};
@@ -2428,9 +2386,11 @@ void LevelA::render()
    }
 
    // 3. 渲染玩家
+   SpriteBatch::setLayer(LAYER_PLAYER);
    mGameState.xochitl->render();
    
    // 4. 最后渲染其他实体（敌人、武器等，在最上层）
+   SpriteBatch::setLayer(LAYER_ENTITIES);
    for (int i = 0; i < mGameState.collidableEntities.size(); ++i)
    {
       if (mGameState.collidableEntities[i])
@@ -2439,7 +2399,7 @@ void LevelA::render()
          // 跳过aura效果实体，因为已经渲染过了
          // 只有EFFECT类型且attackType是AURA的才跳过
          bool isAuraEffect = (entity->getEntityType() == EFFECT && entity->getAttackType() == AURA);
-         if (!isAuraEffect)
+         if (!isAuraEffect && entity->isActive() && isOnScreen(entity))
          {
             entity->render();
          }
@@ -2576,30 +2536,11 @@ void LevelA::renderLevelUpOverlay()
 
 void LevelA::shutdown()
 {
-   // Unload BGM
-   if (mGameState.bgm.frameCount > 0)
-   {
-      StopMusicStream(mGameState.bgm);
-      UnloadMusicStream(mGameState.bgm);
-   }
-   
    // Unload sound effects
-   if (gBloodBulletSound.frameCount > 0)
-   {
-      UnloadSound(gBloodBulletSound);
-   }
-   if (gUpgradeSound.frameCount > 0)
-   {
-      UnloadSound(gUpgradeSound);
-   }
-   if (gChooseUpgradeSound.frameCount > 0)
-   {
-      UnloadSound(gChooseUpgradeSound);
-   }
-   if (gPlayerDeadSound.frameCount > 0)
-   {
-      UnloadSound(gPlayerDeadSound);
-   }
+   VoicePool::unload(gBloodBulletSound);
+   VoicePool::unload(gUpgradeSound);
+   VoicePool::unload(gChooseUpgradeSound);
+   VoicePool::unload(gPlayerDeadSound);
    
    // printf("LevelA::shutdown()");
    Scene::shutdown();
@@ -32,11 +32,13 @@ public:
     LevelA();
     LevelA(Vector2 origin, const char *bgHexCode);
     ~LevelA();
+
+    // Every sheet and sound initialise() loads; LevelATitle prefetches it
+    static const AssetManifest &getAssetManifest();
     
-    Entity* findClosestEnemy(Vector2 pos);
     std::vector<Entity*> mAutoAttacks;
-    std::map<Direction, std::vector<int>> mProjectileAtlas;
-    std::map<Direction, std::vector<int>> mFlyerProjectileAtlas;
+    int mProjectileAtlas; // walk sets interned in AnimationClips
+    int mFlyerProjectileAtlas;
 
     std::vector<Entity*> mSwordHitList;
     bool    mSwordAttackThisFrame = false;
@@ -80,8 +82,6 @@ public:
     std::vector<Entity*> mOrbitShields;
     std::vector<float>   mShieldAngles;
 
-    std::map<Entity*, int> mArrowPierceCount;
-
     bool    mBowPrevAttacking = false;
     Vector2 mBowLastShotDir   = {0.0f, 0.0f};
     bool    mBowHadTargetWhenAttackStarted = false;
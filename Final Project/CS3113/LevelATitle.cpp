@@ -1,4 +1,5 @@
 #include "LevelATitle.h"
+#include "LevelA.h"
 #include <iostream>
 
 LevelATitle::LevelATitle() : Scene{{0.0f}, nullptr} {}
@@ -8,6 +9,8 @@ LevelATitle::~LevelATitle() {}
 void LevelATitle::initialise()
 {
     Scene::initialise();
+    // decode the level's sheets and sounds while the title is up
+    AssetLoader::prefetch(LevelA::getAssetManifest());
     mGameState.nextSceneID = -1;
     mTimer = 0.0f;
 }
@@ -15,13 +18,13 @@ void LevelATitle::initialise()
 void LevelATitle::update(float deltaTime)
 {
     // 跳关功能：按P键跳过LevelA直接进入LevelB
-    if (IsKeyPressed(KEY_P))
+    if (Input::isKeyPressed(KEY_P))
     {
         mGameState.nextSceneID = 4; // Go to LevelBTitle
         return;
     }
     
-    if (IsKeyPressed(KEY_ENTER))
+    if (Input::isKeyPressed(KEY_ENTER))
     {
         mGameState.nextSceneID = 0; // Go to LevelA
     }
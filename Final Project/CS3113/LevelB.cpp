@@ -10,18 +10,19 @@ LevelB::LevelB(Vector2 origin, const char *bgHexCode) : Scene{origin, bgHexCode}
 
 LevelB::~LevelB() {}
 
-static Vector2 getRandomSpawnPosition(Vector2 playerPos, float safeRadius, Vector2 origin)
+static Vector2 getRandomSpawnPosition(Vector2 playerPos, float safeRadius, Vector2 origin,
+   Random &random)
 {
    float x, y;
    Vector2 pos;
 
    do
    {
-      x = GetRandomValue(
+      x = random.range(
           origin.x - (LEVELB_WIDTH * LevelB::TILE_DIMENSION) / 4,
           origin.x + (LEVELB_WIDTH * LevelB::TILE_DIMENSION) / 4);
 
-      y = GetRandomValue(
+      y = random.range(
           origin.y - (LEVELB_HEIGHT * LevelB::TILE_DIMENSION) / 4,
           origin.y + (LEVELB_HEIGHT * LevelB::TILE_DIMENSION) / 4);
 
@@ -134,10 +135,10 @@ static int PLAYER_PROJECTILE_DAMAGE = 1;
 static int FLYER_PROJECTILE_DAMAGE = 1;
 
 // Sound effects
-static Sound gBloodBulletSound = {0};
-static Sound gUpgradeSound = {0};        // Upgrade sound effect
-static Sound gChooseUpgradeSound = {0};  // Choose upgrade sound effect
-static Sound gPlayerDeadSound = {0};     // Player death sound
+static int gBloodBulletSound = VoicePool::NO_SOUND;
+static int gUpgradeSound = VoicePool::NO_SOUND;        // Upgrade sound effect
+static int gChooseUpgradeSound = VoicePool::NO_SOUND;  // Choose upgrade sound effect
+static int gPlayerDeadSound = VoicePool::NO_SOUND;     // Player death sound
 
 // Aura damage cooldown
 static float gAuraDamageTimer = 0.0f;
@@ -153,9 +154,6 @@ static const int EXP_FOLLOWER = 10;
 static const int EXP_WANDERER = 10;
 static const int EXP_FLYER = 10;
 
-// Set of enemies that have given EXP (to avoid duplicate EXP)
-static std::set<Entity*> gExpGivenEnemies;
-
 // Calculate EXP needed for level up
 static int getExpForLevel(int level)
 {
@@ -202,10 +200,10 @@ static void checkEnemyDeathAndGiveExp(Entity* enemy)
    if (enemy->getEntityType() != NPC) return;
    
    // Check if EXP already given
-   if (gExpGivenEnemies.find(enemy) != gExpGivenEnemies.end()) return;
+   if (enemy->isExpAwarded()) return;
    
    // Mark as EXP given and add EXP
-   gExpGivenEnemies.insert(enemy);
+   enemy->markExpAwarded();
    int exp = getExpFromEnemy(enemy->getAIType());
    addPlayerExp(exp);
 }
@@ -226,14 +224,7 @@ static float computeAngleDegFromDir(Vector2 dir, float offsetDeg)
 
 Entity* LevelB::findClosestEnemy(Vector2 pos)
 {
-   Entity *closest = nullptr;
-   float minDist = 400.0f;
-   for (Entity *e : mGameState.collidableEntities) {
-      if (!e || e->getEntityType() != NPC || e->isDead()) continue;
-      float d = Vector2Distance(pos, e->getPosition());
-      if (d < minDist) { minDist = d; closest = e; }
-   }
-   return closest;
+   return Scene::findClosestEnemy(pos, 400.0f); // Level B aims shorter
 }
 
 void LevelB::spawnWave(int waveNum)
@@ -295,14 +286,38 @@ void LevelB::spawnWave(int waveNum)
    }
 }
 
+const AssetManifest &LevelB::getAssetManifest()
+{
+   static const AssetManifest manifest = {
+      {
+         { "assets/hero/Player_run.png", 1, 14 }, { "assets/Tileset.png", 4, 16 },
+         { "assets/Projectiles/BloodBullet7.png", 6, 10 },
+         { "assets/Enemy1/Walk.png", 7, 1 }, { "assets/Enemy 2/Idle Enemy2.png", 4, 1 },
+         { "assets/Enemy 3/Walk.png", 2, 1 },
+         { "assets/Effects/9_brightfire_spritesheet.png", 8, 8 },
+         { "assets/Effects/17_felspell_spritesheet.png", 10, 10 },
+         { "assets/weapons/weaponSheet.png", 24, 5 },
+         { "assets/weapons/105.png", 1, 1 }, { "assets/weapons/001.png", 1, 1 },
+         { "assets/weapons/002.png", 1, 1 }, { "assets/weapons/003.png", 1, 1 },
+         { "assets/weapons/004.png", 1, 1 }, { "assets/weapons/037.png", 1, 1 },
+         { "assets/weapons/039.png", 1, 1 }, { "assets/weapons/040.png", 1, 1 }
+      },
+      {
+         "assets/bloodBulletShoot.wav", "assets/upgrade.wav", "assets/chooseUpgrade.wav",
+         "assets/playerDead.wav"
+      },
+      { "assets/bgm.mp3" },
+      "assets/atlas/levelB.atlas"
+   };
+   return manifest;
+}
+
 void LevelB::initialise()
 {
    Scene::initialise();
    
-   // Load and play BGM (using main.cpp's bgm)
-   mGameState.bgm = LoadMusicStream("assets/bgm.mp3");
-   SetMusicVolume(mGameState.bgm, 0.33f);
-   PlayMusicStream(mGameState.bgm);
+   // BGM; crossfades from whatever the last scene played
+   MusicPlayer::play("assets/bgm.mp3", 0.33f);
    mGameState.nextSceneID = -1;
 
    mWeaponUpgrades.swordCount = 2;
@@ -331,14 +346,19 @@ void LevelB::initialise()
    mWeaponUpgrades.playerMaxHP = 100; // Max HP (increased 5x)
 
    // Load sound effects
-   gBloodBulletSound = LoadSound("assets/bloodBulletShoot.wav");
-   SetSoundVolume(gBloodBulletSound, 0.2f);
-   gUpgradeSound = LoadSound("assets/upgrade.wav");
-   SetSoundVolume(gUpgradeSound, 0.5f);
-   gChooseUpgradeSound = LoadSound("assets/chooseUpgrade.wav");
-   SetSoundVolume(gChooseUpgradeSound, 0.5f);
-   gPlayerDeadSound = LoadSound("assets/playerDead.wav");
-   SetSoundVolume(gPlayerDeadSound, 0.6f);
+   // voices, cooldown (seconds), priority, volume: see VoicePool
+   gBloodBulletSound = VoicePool::load("assets/bloodBulletShoot.wav",
+      { 3, 0.05f, PRIORITY_LOW, 0.2f });
+   gUpgradeSound = VoicePool::load("assets/upgrade.wav",
+      { 1, 0.0f, PRIORITY_HIGH, 0.5f });
+   gChooseUpgradeSound = VoicePool::load("assets/chooseUpgrade.wav",
+      { 1, 0.0f, PRIORITY_HIGH, 0.5f });
+   gPlayerDeadSound = VoicePool::load("assets/playerDead.wav",
+      { 1, 0.0f, PRIORITY_CRITICAL, 0.6f });
+
+   // Hold every sheet for the whole level: the title scene prefetched them,
+   // and anything unreferenced would be purged right after this switch
+   preloadManifest(getAssetManifest());
    
 
    /*
@@ -391,17 +411,17 @@ void LevelB::initialise()
        {LEFT, projFrames},
        {RIGHT, projFrames}};
 
-   mProjectileAtlas = projectileAtlas;
+   mProjectileAtlas = AnimationClips::internWalkSet(projectileAtlas);
 
    std::vector<int> flyerProjFrames;
    for (int i = 0; i < 64; ++i)
       flyerProjFrames.push_back(i);
 
-   mFlyerProjectileAtlas = {
+   mFlyerProjectileAtlas = AnimationClips::internWalkSet({
        {UP, flyerProjFrames},
        {DOWN, flyerProjFrames},
        {LEFT, flyerProjFrames},
-       {RIGHT, flyerProjFrames}};
+       {RIGHT, flyerProjFrames}});
 
    /*
    std::map<EntityState, std::vector<int>> xochitlAttackAtlas = {
@@ -665,21 +685,18 @@ void LevelB::initialise()
 
 void LevelB::update(float deltaTime)
 {
+   // Targeting index is rebuilt on first use each tick (enemies may have
+   // moved or been freed since the last one)
+   mEnemyIndex.invalidate();
+
    // Check if player is dead
    if (mGameState.xochitl != nullptr && mGameState.xochitl->isDead())
    {
-      PlaySound(gPlayerDeadSound); // Play death sound
+      VoicePool::play(gPlayerDeadSound); // Play death sound
       mGameState.nextSceneID = 7; // Lose Scene
       return;
    }
    
-   // Update BGM (loop playback)
-   UpdateMusicStream(mGameState.bgm);
-   if (IsMusicStreamPlaying(mGameState.bgm) == false)
-   {
-      // If music finished, replay (loop implementation)
-      PlayMusicStream(mGameState.bgm);
-   }
    // upgrade menu open: game stalls
    if (mLevelUpMenuOpen)
    {
@@ -691,38 +708,10 @@ void LevelB::update(float deltaTime)
    if (canLevelUp())
    {
       doLevelUp();
-      PlaySound(gUpgradeSound); // Play upgrade sound effect
+      VoicePool::play(gUpgradeSound); // Play upgrade sound effect
       openLevelUpMenu();
    }
 
-   // Clean up EXP records of deleted enemies
-   for (auto it = gExpGivenEnemies.begin(); it != gExpGivenEnemies.end();)
-   {
-      Entity* enemy = *it;
-      if (!enemy) // Check if pointer is valid
-      {
-         it = gExpGivenEnemies.erase(it);
-         continue;
-      }
-      bool found = false;
-      for (Entity* e : mGameState.collidableEntities)
-      {
-         if (e && e == enemy && e->isActive()) // Check if Entity is valid and active
-         {
-            found = true;
-            break;
-         }
-      }
-      if (!found)
-      {
-         it = gExpGivenEnemies.erase(it);
-      }
-      else
-      {
-         ++it;
-      }
-   }
-
    mGameState.xochitl->update(
        deltaTime,                    // delta time / fixed timestep
        nullptr,                      // player
@@ -743,7 +732,8 @@ void LevelB::update(float deltaTime)
           deltaTime,
           mGameState.xochitl, // Enemy AI uses this to track player
           mGameState.map,     // Enemy/bullet collision with map
-          mGameState.collidableEntities);
+          mGameState.collidableEntities,
+          &mRandom.ai);       // wanderer direction changes
    }
 
    // 3. Flyer ranged attack (decide whether to shoot after they move)
@@ -1016,7 +1006,7 @@ void LevelB::update(float deltaTime)
          arrow->setOwner(mGameState.xochitl);
 
          // Initialize pierce count
-         mArrowPierceCount[arrow] = mWeaponUpgrades.arrowPierce;
+         arrow->setPierceRemaining(mWeaponUpgrades.arrowPierce);
 
          mGameState.collidableEntities.push_back(arrow);
          continue;
@@ -1240,34 +1230,11 @@ void LevelB::update(float deltaTime)
       bullet->setSpawnInvincible(0.0f);
       bullet->setAIType(BULLET);
       bullet->setOwner(mGameState.xochitl);
-      PlaySound(gBloodBulletSound);
+      VoicePool::play(gBloodBulletSound);
       mGameState.collidableEntities.push_back(bullet);
    }
 
    // ------------ Unified handling of all flying projectiles (blood bullet + arrow + enemy bullets) ------------
-   // Clean up pierce count of expired arrows
-   for (auto it = mArrowPierceCount.begin(); it != mArrowPierceCount.end();)
-   {
-      Entity *arrow = it->first;
-      bool found = false;
-      for (Entity *e : mGameState.collidableEntities)
-      {
-         if (e == arrow)
-         {
-            found = true;
-            break;
-         }
-      }
-      if (!found || !arrow || !arrow->isActive())
-      {
-         it = mArrowPierceCount.erase(it);
-      }
-      else
-      {
-         ++it;
-      }
-   }
-
    const int PLAYER_PROJECTILE_DAMAGE = 5;  // Blood bullet base damage (5x)
    const int FLYER_PROJECTILE_DAMAGE = 10; // Enemy bullet damage (5x)
    const int ARROW_DAMAGE = 20;            // Arrow damage (5x)
@@ -1337,8 +1304,8 @@ void LevelB::update(float deltaTime)
             if (enemy->getEntityType() != NPC)
                continue;
             
-            // Check if bullet overlaps with enemy
-            if (proj->overlaps(enemy))
+            // Check if bullet overlaps (or flew through) the enemy this tick
+            if (proj->sweepHits(enemy, deltaTime))
             {
                hit = enemy;
                hitIsEnemy = true;
@@ -1354,7 +1321,7 @@ void LevelB::update(float deltaTime)
          // Check if colliding with any shield
          for (Entity *shield : mOrbitShields)
          {
-            if (shield && shield->isActive() && proj->overlaps(shield))
+            if (shield && shield->isActive() && proj->sweepHits(shield, deltaTime))
             {
                // Blocked by shield, no damage dealt
                proj->deactivate();
@@ -1368,7 +1335,7 @@ void LevelB::update(float deltaTime)
          }
          
          // If not blocked, continue checking if colliding with player
-         if (proj->overlaps(mGameState.xochitl))
+         if (proj->sweepHits(mGameState.xochitl, deltaTime))
          {
             hit = mGameState.xochitl;
             hitIsPlayer = true;
@@ -1411,13 +1378,12 @@ void LevelB::update(float deltaTime)
          }
 
          // If arrow, check pierce
-         if (isArrow && mArrowPierceCount.find(proj) != mArrowPierceCount.end())
+         if (isArrow)
          {
-            mArrowPierceCount[proj]--;
-            if (mArrowPierceCount[proj] <= 0)
+            proj->setPierceRemaining(proj->getPierceRemaining() - 1);
+            if (proj->getPierceRemaining() <= 0)
             {
                // Pierce count exhausted, destroy arrow
-               mArrowPierceCount.erase(proj);
                proj->deactivate();
             }
             // Otherwise continue piercing, don't destroy
@@ -1488,6 +1454,7 @@ void LevelB::update(float deltaTime)
          }
          ++it;
       }
+      mEnemyIndex.invalidate(); // may have freed enemies
    }
 
    // TUTORIAL: Check wave completion
@@ -1723,7 +1690,7 @@ void LevelB::openLevelUpMenu()
    // 3) Randomly shuffle pool (simple Fisher-Yates shuffle)
    for (int i = (int)pool.size() - 1; i > 0; --i)
    {
-      int j = GetRandomValue(0, i);
+      int j = mRandom.levelUp.range(0, i);
       LevelUpOption temp = pool[i];
       pool[i] = pool[j];
       pool[j] = temp;
@@ -1741,17 +1708,17 @@ void LevelB::openLevelUpMenu()
 void LevelB::handleLevelUpInput()
 {
    // Keyboard: 1/2/3 to directly select
-   if (IsKeyPressed(KEY_ONE) && mLevelUpOptionCount >= 1)
+   if (Input::isKeyPressed(KEY_ONE) && mLevelUpOptionCount >= 1)
    {
       applyUpgradeChoice(0);
       return;
    }
-   if (IsKeyPressed(KEY_TWO) && mLevelUpOptionCount >= 2)
+   if (Input::isKeyPressed(KEY_TWO) && mLevelUpOptionCount >= 2)
    {
       applyUpgradeChoice(1);
       return;
    }
-   if (IsKeyPressed(KEY_THREE) && mLevelUpOptionCount >= 3)
+   if (Input::isKeyPressed(KEY_THREE) && mLevelUpOptionCount >= 3)
    {
       applyUpgradeChoice(2);
       return;
@@ -1783,7 +1750,7 @@ void LevelB::handleLevelUpInput()
       if (CheckCollisionPointRec(mouse, rect))
       {
          mLevelUpSelectedIndex = i;
-         if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+         if (Input::isMouseButtonPressed(MOUSE_LEFT_BUTTON))
          {
             applyUpgradeChoice(i);
             return;
@@ -1795,7 +1762,7 @@ void LevelB::handleLevelUpInput()
 void LevelB::applyUpgradeChoice(int index)
 {
    // Play upgrade selection sound effect
-   PlaySound(gChooseUpgradeSound);
+   VoicePool::play(gChooseUpgradeSound);
    if (index < 0 || index >= mLevelUpOptionCount || index >= MAX_LEVELUP_OPTIONS)
       return;
 
@@ -2430,14 +2397,18 @@ void LevelB::applyUpgradeChoice(int index)
 void LevelB::render()
 {
    ClearBackground(ColorFromHex(mBGColourHexCode));
+   beginCulling();
 
    // 1. 先渲染地图（最底层）
-   mGameState.map->render();
+   SpriteBatch::setLayer(LAYER_MAP);
+   mGameState.map->render(mVisibleArea);
 
    // 2. 渲染Aura（在玩家下面），稍微调暗
+   SpriteBatch::setLayer(LAYER_GROUND);
    for (Entity *entity : mAutoAttacks)
    {
-      if (entity && entity->getAttackType() == AURA && entity->isActive())
+      if (entity && entity->getAttackType() == AURA && entity->isActive() &&
+          isOnScreen(entity))
       {
          // 稍微调暗的颜色（不要太暗）
          Color darkTint = {200, 200, 200, 200};
@@ -2446,9 +2417,11 @@ void LevelB::render()
    }
 
    // 3. 渲染玩家
+   SpriteBatch::setLayer(LAYER_PLAYER);
    mGameState.xochitl->render();
    
    // 4. 最后渲染其他实体（敌人、武器等，在最上层）
+   SpriteBatch::setLayer(LAYER_ENTITIES);
    for (int i = 0; i < mGameState.collidableEntities.size(); ++i)
    {
       if (mGameState.collidableEntities[i])
@@ -2457,7 +2430,7 @@ void LevelB::render()
          // 跳过aura效果实体，因为已经渲染过了
          // 只有EFFECT类型且attackType是AURA的才跳过
          bool isAuraEffect = (entity->getEntityType() == EFFECT && entity->getAttackType() == AURA);
-         if (!isAuraEffect)
+         if (!isAuraEffect && entity->isActive() && isOnScreen(entity))
          {
             entity->render();
          }
@@ -2601,30 +2574,11 @@ void LevelB::renderLevelUpOverlay()
 
 void LevelB::shutdown()
 {
-   // Unload BGM
-   if (mGameState.bgm.frameCount > 0)
-   {
-      StopMusicStream(mGameState.bgm);
-      UnloadMusicStream(mGameState.bgm);
-   }
-   
    // Unload sound effects
-   if (gBloodBulletSound.frameCount > 0)
-   {
-      UnloadSound(gBloodBulletSound);
-   }
-   if (gUpgradeSound.frameCount > 0)
-   {
-      UnloadSound(gUpgradeSound);
-   }
-   if (gChooseUpgradeSound.frameCount > 0)
-   {
-      UnloadSound(gChooseUpgradeSound);
-   }
-   if (gPlayerDeadSound.frameCount > 0)
-   {
-      UnloadSound(gPlayerDeadSound);
-   }
+   VoicePool::unload(gBloodBulletSound);
+   VoicePool::unload(gUpgradeSound);
+   VoicePool::unload(gChooseUpgradeSound);
+   VoicePool::unload(gPlayerDeadSound);
    
    // printf("LevelB::shutdown()");
    Scene::shutdown();
@@ -33,6 +33,9 @@ public:
     LevelB();
     LevelB(Vector2 origin, const char *bgHexCode);
     ~LevelB();
+
+    // Every sheet and sound initialise() loads; LevelBTitle prefetches it
+    static const AssetManifest &getAssetManifest();
     
     void initialise() override;
     void update(float deltaTime) override;
@@ -49,8 +52,8 @@ public:
     
     // Auto attacks
     std::vector<Entity*> mAutoAttacks;
-    std::map<Direction, std::vector<int>> mProjectileAtlas;
-    std::map<Direction, std::vector<int>> mFlyerProjectileAtlas;
+    int mProjectileAtlas; // walk sets interned in AnimationClips
+    int mFlyerProjectileAtlas;
 
     std::vector<Entity*> mOrbitSwords;
     std::vector<float>   mSwordAngles;
@@ -59,8 +62,6 @@ public:
     std::vector<Entity*> mOrbitShields;
     std::vector<float>   mShieldAngles;
 
-    std::map<Entity*, int> mArrowPierceCount;
-
     bool    mBowPrevAttacking = false;
     Vector2 mBowLastShotDir   = {0.0f, 0.0f};
     bool    mBowHadTargetWhenAttackStarted = false;
@@ -1,4 +1,5 @@
 #include "LevelBTitle.h"
+#include "LevelB.h"
 #include <iostream>
 
 LevelBTitle::LevelBTitle() : Scene{{0.0f}, nullptr} {}
@@ -8,6 +9,8 @@ LevelBTitle::~LevelBTitle() {}
 void LevelBTitle::initialise()
 {
     Scene::initialise();
+    // decode the level's sheets and sounds while the title is up
+    AssetLoader::prefetch(LevelB::getAssetManifest());
     mGameState.nextSceneID = -1;
     mTimer = 0.0f;
 }
@@ -15,13 +18,13 @@ void LevelBTitle::initialise()
 void LevelBTitle::update(float deltaTime)
 {
     // 跳关功能：按P键跳过LevelB直接进入LevelC
-    if (IsKeyPressed(KEY_P))
+    if (Input::isKeyPressed(KEY_P))
     {
         mGameState.nextSceneID = 5; // Go to LevelCTitle
         return;
     }
     
-    if (IsKeyPressed(KEY_ENTER))
+    if (Input::isKeyPressed(KEY_ENTER))
     {
         mGameState.nextSceneID = 1; // Go to LevelB
     }
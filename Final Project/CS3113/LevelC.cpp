@@ -10,18 +10,19 @@ LevelC::LevelC(Vector2 origin, const char *bgHexCode) : Scene{origin, bgHexCode}
 
 LevelC::~LevelC() {}
 
-static Vector2 getRandomSpawnPosition(Vector2 playerPos, float safeRadius, Vector2 origin)
+static Vector2 getRandomSpawnPosition(Vector2 playerPos, float safeRadius, Vector2 origin,
+   Random &random)
 {
    float x, y;
    Vector2 pos;
 
    do
    {
-      x = GetRandomValue(
+      x = random.range(
           origin.x - (LEVELC_WIDTH * LevelC::TILE_DIMENSION) / 4,
           origin.x + (LEVELC_WIDTH * LevelC::TILE_DIMENSION) / 4);
 
-      y = GetRandomValue(
+      y = random.range(
           origin.y - (LEVELC_HEIGHT * LevelC::TILE_DIMENSION) / 4,
           origin.y + (LEVELC_HEIGHT * LevelC::TILE_DIMENSION) / 4);
 
@@ -197,10 +198,10 @@ static const float HEAVEN_LASER_WIDTH = 32.0f; // Beam width
 
 // Track active laser beams with their animation state
 struct LaserBeam {
-   Entity* entity;
+   EntityHandle entity;
    Vector2 direction;
    int lastDamageFrame; // Track which frame we last dealt damage on
-   std::set<Entity*> hitEnemies; // Track enemies already hit by this beam
+   std::set<EntityHandle> hitEnemies; // Track enemies already hit by this beam
 };
 static std::vector<LaserBeam> gActiveLaserBeams;
 
@@ -216,12 +217,12 @@ static int PLAYER_PROJECTILE_DAMAGE = 1;
 static int FLYER_PROJECTILE_DAMAGE = 1;
 
 // Sound effects
-static Sound gBloodBulletSound = {0};
-static Sound gUpgradeSound = {0};        // Upgrade sound effect
-static Sound gChooseUpgradeSound = {0};  // Choose upgrade sound effect
-static Sound gHeavenLaserSound = {0};    // Heaven Laser firing sound
-static Sound gPlayerDeadSound = {0};     // Player death sound
-static Sound gPlayerHurtSound = {0};     // Player hurt sound
+static int gBloodBulletSound = VoicePool::NO_SOUND;
+static int gUpgradeSound = VoicePool::NO_SOUND;        // Upgrade sound effect
+static int gChooseUpgradeSound = VoicePool::NO_SOUND;  // Choose upgrade sound effect
+static int gHeavenLaserSound = VoicePool::NO_SOUND;    // Heaven Laser firing sound
+static int gPlayerDeadSound = VoicePool::NO_SOUND;     // Player death sound
+static int gPlayerHurtSound = VoicePool::NO_SOUND;     // Player hurt sound
 
 // Aura damage cooldown
 static float gAuraDamageTimer = 0.0f;
@@ -237,9 +238,6 @@ static const int EXP_FOLLOWER = 4; // Increased from 3 to 4
 static const int EXP_WANDERER = 3; // Increased from 2 to 3
 static const int EXP_FLYER = 3;    // Increased from 2 to 3
 
-// Set of enemies that have already given experience (to avoid duplicate experience)
-static std::set<Entity*> gExpGivenEnemies;
-
 // Kill counters (extern so other scenes can access)
 int gTotalKills = 0;
 int gFollowerKills = 0;
@@ -298,10 +296,10 @@ static void checkEnemyDeathAndGiveExp(Entity* enemy)
    if (enemy->getEntityType() != NPC) return;
    
    // Check if experience has already been given
-   if (gExpGivenEnemies.find(enemy) != gExpGivenEnemies.end()) return;
+   if (enemy->isExpAwarded()) return;
    
    // Mark as experience given and add experience
-   gExpGivenEnemies.insert(enemy);
+   enemy->markExpAwarded();
    int exp = getExpFromEnemy(enemy->getAIType());
    addPlayerExp(exp);
    
@@ -330,6 +328,33 @@ static float computeAngleDegFromDir(Vector2 dir, float offsetDeg)
    return angleDeg + offsetDeg;
 }
 
+const AssetManifest &LevelC::getAssetManifest()
+{
+   static const AssetManifest manifest = {
+      {
+         { "assets/hero/Player_run.png", 1, 14 }, { "assets/Tileset.png", 4, 16 },
+         { "assets/Projectiles/BloodBullet7.png", 6, 10 },
+         { "assets/Enemy1/Walk.png", 7, 1 }, { "assets/Enemy 2/Idle Enemy2.png", 4, 1 },
+         { "assets/Enemy 3/Walk.png", 2, 1 },
+         { "assets/Effects/9_brightfire_spritesheet.png", 8, 8 },
+         { "assets/Effects/17_felspell_spritesheet.png", 10, 10 },
+         { "assets/weapons/weaponSheet.png", 24, 5 },
+         { "assets/weapons/105.png", 1, 1 }, { "assets/Effects/heavenLaser.png", 8, 1 },
+         { "assets/weapons/001.png", 1, 1 }, { "assets/weapons/002.png", 1, 1 },
+         { "assets/weapons/003.png", 1, 1 }, { "assets/weapons/004.png", 1, 1 },
+         { "assets/weapons/037.png", 1, 1 }, { "assets/weapons/039.png", 1, 1 },
+         { "assets/weapons/040.png", 1, 1 }
+      },
+      {
+         "assets/bloodBulletShoot.wav", "assets/upgrade.wav", "assets/chooseUpgrade.wav",
+         "assets/heavenLaser.wav", "assets/playerDead.wav", "assets/hurt 1.wav"
+      },
+      { "assets/levelCbgm.mp3" },
+      "assets/atlas/levelC.atlas"
+   };
+   return manifest;
+}
+
 void LevelC::initialise()
 {
    Scene::initialise();
@@ -353,6 +378,7 @@ void LevelC::initialise()
    gBloodEmitter = nullptr;
    mBowEmitter = nullptr;
    mBowWasAttackingLastFrame = false;
+   mAutoAttacks.clear();
    gHeavenLaserTimer = 0.0f;
    
    // Reset other static variables
@@ -366,7 +392,6 @@ void LevelC::initialise()
    gPlayerLevel = 1;
    gPlayerExp = 0;
    gExpToNextLevel = 10;
-   gExpGivenEnemies.clear();
 
    mWeaponUpgrades.swordCount = 2;
    mWeaponUpgrades.swordSize = 24.0f; // Initial sword size
@@ -399,24 +424,28 @@ void LevelC::initialise()
    mWeaponUpgrades.playerMaxHP = 100; // Max HP (increased 5x)
 
    // Load sound effects
-   gBloodBulletSound = LoadSound("assets/bloodBulletShoot.wav");
-   SetSoundVolume(gBloodBulletSound, 0.2f);
-   gUpgradeSound = LoadSound("assets/upgrade.wav");
-   SetSoundVolume(gUpgradeSound, 0.5f);
-   gChooseUpgradeSound = LoadSound("assets/chooseUpgrade.wav");
-   SetSoundVolume(gChooseUpgradeSound, 0.5f);
-   gHeavenLaserSound = LoadSound("assets/heavenLaser.wav");
-   SetSoundVolume(gHeavenLaserSound, 0.4f);
-   gPlayerDeadSound = LoadSound("assets/playerDead.wav");
-   SetSoundVolume(gPlayerDeadSound, 0.6f);
-   gPlayerHurtSound = LoadSound("assets/hurt 1.wav");
-   SetSoundVolume(gPlayerHurtSound, 0.5f);
-   
-   // Load and play LevelC specific BGM (loop playback)
-   mGameState.bgm = LoadMusicStream("assets/levelCbgm.mp3");
-   SetMusicVolume(mGameState.bgm, 0.33f);
-   PlayMusicStream(mGameState.bgm);
+   // voices, cooldown (seconds), priority, volume: see VoicePool
+   gBloodBulletSound = VoicePool::load("assets/bloodBulletShoot.wav",
+      { 3, 0.05f, PRIORITY_LOW, 0.2f });
+   gUpgradeSound = VoicePool::load("assets/upgrade.wav",
+      { 1, 0.0f, PRIORITY_HIGH, 0.5f });
+   gChooseUpgradeSound = VoicePool::load("assets/chooseUpgrade.wav",
+      { 1, 0.0f, PRIORITY_HIGH, 0.5f });
+   gHeavenLaserSound = VoicePool::load("assets/heavenLaser.wav",
+      { 2, 0.1f, PRIORITY_NORMAL, 0.4f });
+   gPlayerDeadSound = VoicePool::load("assets/playerDead.wav",
+      { 1, 0.0f, PRIORITY_CRITICAL, 0.6f });
+   gPlayerHurtSound = VoicePool::load("assets/hurt 1.wav",
+      { 1, 0.15f, PRIORITY_NORMAL, 0.5f });
    
+   // BGM; crossfades from whatever the last scene played
+   MusicPlayer::play("assets/levelCbgm.mp3", 0.33f);
+
+   // Warm the texture cache with every sheet that gets spawned mid-game, so
+   // firing and enemy spawns never go to disk or re-upload to the GPU (the
+   // title scene prefetched them, so this is mostly cache hits)
+   preloadManifest(getAssetManifest());
+
 
    /*
       ----------- MAP -----------
@@ -461,17 +490,35 @@ void LevelC::initialise()
        {LEFT, projFrames},
        {RIGHT, projFrames}};
 
-   mProjectileAtlas = projectileAtlas;
+   mProjectileAtlas = AnimationClips::internWalkSet(projectileAtlas);
 
    std::vector<int> flyerProjFrames;
    for (int i = 0; i < 64; ++i)
       flyerProjFrames.push_back(i);
 
-   mFlyerProjectileAtlas = {
+   mFlyerProjectileAtlas = AnimationClips::internWalkSet({
        {UP, flyerProjFrames},
        {DOWN, flyerProjFrames},
        {LEFT, flyerProjFrames},
-       {RIGHT, flyerProjFrames}};
+       {RIGHT, flyerProjFrames}});
+
+   // Arrow (105.png is a single image) and Heaven Laser (8 frames) atlases,
+   // built once here rather than on every shot
+   mArrowAtlas = AnimationClips::internWalkSet({
+       {UP, {0}}, {DOWN, {0}}, {LEFT, {0}}, {RIGHT, {0}}});
+
+   std::vector<int> laserFrames;
+   for (int i = 0; i < 8; ++i)
+      laserFrames.push_back(i);
+
+   mLaserAtlas = AnimationClips::internWalkSet({
+       {RIGHT, laserFrames},
+       {LEFT, laserFrames},
+       {UP, laserFrames},
+       {DOWN, laserFrames}});
+
+   // Every bullet, arrow and beam comes out of this block
+   mEffectPool.allocate(EFFECT_POOL_CAPACITY);
 
    /*
    std::map<EntityState, std::vector<int>> xochitlAttackAtlas = {
@@ -530,8 +577,7 @@ void LevelC::initialise()
       Vector2 pos = {mGameState.xochitl->getPosition().x, mGameState.xochitl->getPosition().y - 5};
       flameAura->setPosition(pos);
       flameAura->setCheckCollision(false);
-      mAutoAttacks.push_back(flameAura);
-      mGameState.collidableEntities.push_back(flameAura);
+      mAutoAttacks.push_back(addEntity(flameAura));
    }
 
    /*
@@ -554,8 +600,9 @@ void LevelC::initialise()
       projectileEmitter1->setAttackType(PROJECTILE);
       projectileEmitter1->setAttackInterval(mWeaponUpgrades.bloodBulletCD);
       projectileEmitter1->setCheckCollision(false);
+      projectileEmitter1->setIsEffect(true); // registered like the other weapons
 
-      mAutoAttacks.push_back(projectileEmitter1);
+      mAutoAttacks.push_back(addEntity(projectileEmitter1));
       gBloodEmitter = projectileEmitter1;
    }
 
@@ -597,8 +644,7 @@ void LevelC::initialise()
          mSwordOverlaps.push_back(emptyList);
          mSwordAttackTimers.push_back(0.0f); // Initialize attack timer
 
-         mGameState.collidableEntities.push_back(sword);
-         mAutoAttacks.push_back(sword);
+         mAutoAttacks.push_back(addEntity(sword));
       }
    }
 
@@ -642,8 +688,7 @@ void LevelC::initialise()
          mOrbitShields.push_back(shield);
          mShieldAngles.push_back(baseAngle);
 
-         mAutoAttacks.push_back(shield);
-         mGameState.collidableEntities.push_back(shield);
+         mAutoAttacks.push_back(addEntity(shield));
       }
    }
 
@@ -707,8 +752,7 @@ void LevelC::initialise()
       mBowEmitter->setCheckCollision(false);
       mBowEmitter->setAttackInterval(mWeaponUpgrades.bowCooldown);
 
-      mAutoAttacks.push_back(mBowEmitter);
-      mGameState.collidableEntities.push_back(mBowEmitter);
+      mAutoAttacks.push_back(addEntity(mBowEmitter));
    }
 
    /*
@@ -726,7 +770,7 @@ void LevelC::initialise()
    // Initially spawn a few enemies as opening
    for (int i = 0; i < 5; ++i)
    {
-      int type = GetRandomValue(0, 2);
+      int type = mRandom.enemyRolls.range(0, 2);
       spawnEnemy(type, 1.0f);
    }
 
@@ -748,87 +792,17 @@ void LevelC::initialise()
    mLevelUpSelectedIndex = -1;
 }
 
-Entity *LevelC::findClosestEnemy(Vector2 pos)
-{
-   Entity *closest = nullptr;
-   float minDist = 600.0f;
-
-   for (Entity *enemy : mGameState.collidableEntities)
-   {
-      if (enemy == nullptr)
-         continue;
-      if (enemy->getEntityType() != NPC)
-         continue;
-      if (enemy->isDead())
-         continue;
-
-      float d = Vector2Distance(pos, enemy->getPosition());
-      if (d < minDist)
-      {
-         minDist = d;
-         closest = enemy;
-      }
-   }
-   return closest;
-}
-
-// Find N closest enemies for Heaven Laser targeting
-std::vector<Entity*> LevelC::findClosestEnemies(Vector2 pos, int count)
-{
-   std::vector<Entity*> result;
-   std::vector<std::pair<float, Entity*>> distances;
-
-   for (Entity *enemy : mGameState.collidableEntities)
-   {
-      if (enemy == nullptr)
-         continue;
-      if (enemy->getEntityType() != NPC)
-         continue;
-      if (enemy->isDead())
-         continue;
-
-      float d = Vector2Distance(pos, enemy->getPosition());
-      if (d < 600.0f) // Only consider enemies within range
-      {
-         distances.push_back({d, enemy});
-      }
-   }
-
-   // Sort by distance (ascending)
-   for (size_t i = 0; i < distances.size(); ++i)
-   {
-      for (size_t j = i + 1; j < distances.size(); ++j)
-      {
-         if (distances[j].first < distances[i].first)
-         {
-            std::swap(distances[i], distances[j]);
-         }
-      }
-   }
-
-   // Get the first N enemies
-   for (size_t i = 0; i < distances.size() && (int)i < count; ++i)
-   {
-      result.push_back(distances[i].second);
-   }
-
-   return result;
-}
-
 void LevelC::update(float deltaTime)
 {
-   // Update BGM (loop playback)
-   UpdateMusicStream(mGameState.bgm);
-   if (IsMusicStreamPlaying(mGameState.bgm) == false)
-   {
-      // If music finished (after 1 minute), replay (implement loop)
-      PlayMusicStream(mGameState.bgm);
-   }
+   // Targeting index is rebuilt on first use each tick (enemies may have
+   // moved or been freed since the last one)
+   mEnemyIndex.invalidate();
+
    // Check if player is dead
    if (mGameState.xochitl != nullptr && mGameState.xochitl->isDead() && !mGameOver)
    {
       mGameOver = true;
-      PlaySound(gPlayerDeadSound); // Play death sound
+      VoicePool::play(gPlayerDeadSound); // Play death sound
       mGameState.nextSceneID = 7; // Lose Scene
       return;
    }
@@ -840,7 +814,7 @@ void LevelC::update(float deltaTime)
    }
 
    // Cheat mode: Press L to open upgrade menu with Heaven Laser always available
-   if (IsKeyPressed(KEY_L))
+   if (Input::isKeyPressed(KEY_L))
    {
       // printf("[DEBUG] L pressed - Cheat mode activated!\n");
       gCheatModeActive = true;
@@ -859,7 +833,7 @@ void LevelC::update(float deltaTime)
    if (canLevelUp())
    {
       doLevelUp();
-      PlaySound(gUpgradeSound);
+      VoicePool::play(gUpgradeSound);
       
       // If Heaven Laser is unlocked, automatically add HP instead of showing menu
       if (gHasHeavenLaser)
@@ -880,60 +854,54 @@ void LevelC::update(float deltaTime)
       }
    }
 
-   // Clean up experience records of deleted enemies
-   for (auto it = gExpGivenEnemies.begin(); it != gExpGivenEnemies.end();)
-   {
-      Entity* enemy = *it;
-      if (!enemy) // Check if pointer is valid
-      {
-         it = gExpGivenEnemies.erase(it);
-         continue;
-      }
-      bool found = false;
-      for (Entity* e : mGameState.collidableEntities)
-      {
-         if (e && e == enemy && e->isActive()) // Check if Entity is valid and active
-         {
-            found = true;
-            break;
-         }
-      }
-      if (!found)
-      {
-         it = gExpGivenEnemies.erase(it);
-      }
-      else
-      {
-         ++it;
-      }
-   }
+   // Broadphase for this step: every query below (movement, touch damage,
+   // projectile hits) reads from this one build
+   mCollisionGrid.build(mGameState.collidableEntities, deltaTime);
 
+   mCollisionGrid.queryMovement(mGameState.xochitl, deltaTime, mCollisionCandidates);
    mGameState.xochitl->update(
        deltaTime,                    // delta time / fixed timestep
        nullptr,                      // player
        nullptr,                      // map
-       mGameState.collidableEntities // col. entity count
+       mCollisionCandidates          // whatever it can reach this step
    );
 
    mSwordAttackThisFrame = false;
 
+   // Pooled bullets, arrows, flyer shots and beams: lifetime, frame timer and
+   // motion in one pass over EntityStore's arrays
+   EntityStore::integrate(deltaTime);
+
    for (Entity *entity : mGameState.collidableEntities)
    {
       if (!entity)
          continue;
       if (entity == mGameState.xochitl)
          continue;
+      if (entity->isBulkIntegrated())
+         continue;
+
+      // Effects and inactive entities never run entity collision
+      if (entity->getIsEffect() || !entity->isActive())
+         mCollisionCandidates.clear();
+      else
+         mCollisionGrid.queryMovement(entity, deltaTime, mCollisionCandidates);
 
       entity->update(
           deltaTime,
           mGameState.xochitl, // Enemy AI uses this to track player
           mGameState.map,     // Enemy / bullet collision with map
-          mGameState.collidableEntities);
+          mCollisionCandidates,
+          &mRandom.ai);       // Wanderer direction changes
    }
 
    // 3. Flyer ranged attack (decide whether to shoot after they move)
-   for (Entity *entity : mGameState.collidableEntities)
+   // Indexed over the flyers that exist now: the shots are appended to the
+   // same vector, which a range-for would not survive
+   size_t shooterCount = mGameState.collidableEntities.size();
+   for (size_t i = 0; i < shooterCount; ++i)
    {
+      Entity *entity = mGameState.collidableEntities[i];
       if (!entity || !entity->isActive() || entity->isDead())
          continue;
       if (entity->getEntityType() != NPC)
@@ -960,14 +928,14 @@ void LevelC::update(float deltaTime)
       Vector2 dir = {dx / len, dy / len};
 
       // —— Spawn Flyer projectile (8x8 sprite sheet) ——
-      Entity *proj = new Entity(
+      Entity *proj = spawnEffect(
           from,
           {32.0f, 32.0f}, // Texture size doubled
           "assets/Effects/9_brightfire_spritesheet.png",
-          ATLAS,
           {8, 8},
-          mFlyerProjectileAtlas,
-          EFFECT);
+          mFlyerProjectileAtlas);
+      if (proj == nullptr)
+         continue; // pool exhausted, skip this shot
 
       proj->setIsEffect(true);
       proj->setAttackType(PROJECTILE);
@@ -997,7 +965,7 @@ void LevelC::update(float deltaTime)
       proj->setAIType(BULLET);
       proj->setOwner(entity);
 
-      mGameState.collidableEntities.push_back(proj);
+      addEntity(proj);
    }
 
    Vector2 currentPlayerPosition = mGameState.xochitl->getPosition();
@@ -1024,7 +992,10 @@ void LevelC::update(float deltaTime)
    const int MELEE_TOUCH_DAMAGE = 10; // Melee enemy touch damage (increased 5x)
    const int FLYER_TOUCH_DAMAGE = 5;  // Flyer body touch damage (increased 5x)
 
-   for (Entity *enemy : mGameState.collidableEntities)
+   mCollisionGrid.query(mGameState.xochitl->getPosition(),
+      mGameState.xochitl->getColliderDimensions(), NPC, mCollisionCandidates);
+
+   for (Entity *enemy : mCollisionCandidates)
    {
       if (!enemy || !enemy->isActive() || enemy->isDead())
          continue;
@@ -1038,18 +1009,19 @@ void LevelC::update(float deltaTime)
       {
          // Ranged enemy body touches player: deal damage once
          mGameState.xochitl->takeDamage(FLYER_TOUCH_DAMAGE);
-         if (gPlayerHurtSound.frameCount > 0) PlaySound(gPlayerHurtSound);
+         VoicePool::play(gPlayerHurtSound);
       }
       else
       {
          // Wanderer / Follower melee enemies touch player: deal damage once
          mGameState.xochitl->takeDamage(MELEE_TOUCH_DAMAGE);
-         if (gPlayerHurtSound.frameCount > 0) PlaySound(gPlayerHurtSound);
+         VoicePool::play(gPlayerHurtSound);
       }
    }
 
-   for (Entity *entity : mAutoAttacks)
+   for (EntityHandle handle : mAutoAttacks)
    {
+      Entity *entity = getEntity(handle);
       if (!entity)
          continue;
       if (entity->getAttackType() == AURA)
@@ -1107,8 +1079,9 @@ void LevelC::update(float deltaTime)
    }
 
    // --- Effect positioning & cooldown update ---
-   for (Entity *entity : mAutoAttacks)
+   for (EntityHandle handle : mAutoAttacks)
    {
+      Entity *entity = getEntity(handle);
       if (!entity)
          continue;
       
@@ -1180,18 +1153,15 @@ void LevelC::update(float deltaTime)
          from.x += shotDir.x * 16.0f;
          from.y += shotDir.y * 16.0f;
 
-         // Create arrow entity (use SINGLE type, because 105.png is a single image)
-         std::map<Direction, std::vector<int>> arrowAtlas = {
-             {UP, {0}}, {DOWN, {0}}, {LEFT, {0}}, {RIGHT, {0}}
-         };
-         Entity *arrow = new Entity(
+         // Create arrow entity (1x1 atlas, because 105.png is a single image)
+         Entity *arrow = spawnEffect(
              from,
              {10, 10},
              "assets/weapons/105.png",
-             ATLAS,
              {1, 1},
-             arrowAtlas,
-             EFFECT);
+             mArrowAtlas);
+         if (arrow == nullptr)
+            continue; // pool exhausted, skip this shot
 
          arrow->setIsEffect(true);
          arrow->setAttackType(ARROW); // Use ARROW type, distinguish from blood bullet
@@ -1218,9 +1188,8 @@ void LevelC::update(float deltaTime)
          arrow->setOwner(mGameState.xochitl);
 
          // Initialize pierce count
-         mArrowPierceCount[arrow] = mWeaponUpgrades.arrowPierce;
-
-         mGameState.collidableEntities.push_back(arrow);
+         arrow->setPierceRemaining(mWeaponUpgrades.arrowPierce);
+         addEntity(arrow);
          continue;
       }
 
@@ -1428,15 +1397,15 @@ void LevelC::update(float deltaTime)
          shotDir.y = dy / len;
       }
 
-      // create bullet entity (single-sprite version to avoid atlas scoping issues)
-      Entity *bullet = new Entity(
+      // create bullet entity
+      Entity *bullet = spawnEffect(
           from,
           {15, 15},
           "assets/Projectiles/BloodBullet7.png",
-          ATLAS,
           {6, 10},
-          mProjectileAtlas,
-          EFFECT);
+          mProjectileAtlas);
+      if (bullet == nullptr)
+         continue; // pool exhausted, skip this shot
 
       bullet->setIsEffect(true);
       bullet->setAttackType(PROJECTILE);
@@ -1466,8 +1435,8 @@ void LevelC::update(float deltaTime)
       bullet->setSpawnInvincible(0.0f);
       bullet->setAIType(BULLET);
       bullet->setOwner(mGameState.xochitl);
-      PlaySound(gBloodBulletSound);
-      mGameState.collidableEntities.push_back(bullet);
+      VoicePool::play(gBloodBulletSound);
+      addEntity(bullet);
    }
 
    // ------------ HEAVEN LASER (Ultimate Weapon) ------------
@@ -1498,10 +1467,8 @@ void LevelC::update(float deltaTime)
       if (gBloodEmitter != nullptr)
       {
          Entity* temp = gBloodEmitter;
-         gBloodEmitter = nullptr; // Clear first to prevent double delete
-         mAutoAttacks.erase(std::remove(mAutoAttacks.begin(), mAutoAttacks.end(), temp), mAutoAttacks.end());
-         mGameState.collidableEntities.erase(std::remove(mGameState.collidableEntities.begin(), mGameState.collidableEntities.end(), temp), mGameState.collidableEntities.end());
-         delete temp;
+         gBloodEmitter = nullptr; // Clear first, freed at the end of the tick
+         removeAutoAttack(temp);
          // printf("[DEBUG] Blood emitter removed (auto-unlock)\n");
       }
       
@@ -1509,10 +1476,8 @@ void LevelC::update(float deltaTime)
       if (mBowEmitter != nullptr)
       {
          Entity* temp = mBowEmitter;
-         mBowEmitter = nullptr; // Clear first to prevent double delete
-         mAutoAttacks.erase(std::remove(mAutoAttacks.begin(), mAutoAttacks.end(), temp), mAutoAttacks.end());
-         mGameState.collidableEntities.erase(std::remove(mGameState.collidableEntities.begin(), mGameState.collidableEntities.end(), temp), mGameState.collidableEntities.end());
-         delete temp;
+         mBowEmitter = nullptr; // Clear first, freed at the end of the tick
+         removeAutoAttack(temp);
          // printf("[DEBUG] Bow emitter removed (auto-unlock)\n");
       }
    }
@@ -1529,16 +1494,12 @@ void LevelC::update(float deltaTime)
       for (auto it = gActiveLaserBeams.begin(); it != gActiveLaserBeams.end();)
       {
          LaserBeam& beam = *it;
-         Entity* laser = beam.entity;
+         Entity* laser = getEntity(beam.entity); // nullptr once recycled
          
          if (!laser || !laser->isActive() || laser->getLifetime() <= 0)
          {
             // Clean up finished laser
-            if (laser)
-            {
-               mGameState.collidableEntities.erase(std::remove(mGameState.collidableEntities.begin(), mGameState.collidableEntities.end(), laser), mGameState.collidableEntities.end());
-               delete laser;
-            }
+            if (laser) removeEntity(laser);
             it = gActiveLaserBeams.erase(it);
          }
          else
@@ -1555,26 +1516,28 @@ void LevelC::update(float deltaTime)
                {
                   if (!enemy || enemy->getEntityType() != NPC || enemy->isDead())
                      continue;
-                  if (beam.hitEnemies.find(enemy) != beam.hitEnemies.end())
+                  if (beam.hitEnemies.find(enemy->getHandle()) != beam.hitEnemies.end())
                      continue; // Already hit this enemy
                   
-                  // Check if enemy is within the beam rectangle
-                  Vector2 enemyPos = enemy->getPosition();
-                  Vector2 toEnemy = {enemyPos.x - playerPos.x, enemyPos.y - playerPos.y};
-                  
-                  // Project enemy position onto beam direction
-                  float dot = toEnemy.x * beam.direction.x + toEnemy.y * beam.direction.y;
-                  if (dot > 0 && dot < HEAVEN_LASER_LENGTH)
+                  // Sweep a beam-wide square from the player down the beam:
+                  // it touches the enemy's collider exactly when the beam's
+                  // centre line crosses the collider grown by the beam width
+                  Vector2 enemyPos  = enemy->getPosition();
+                  Vector2 enemySize = enemy->getColliderDimensions();
+                  Rectangle reach = {
+                     enemyPos.x - (enemySize.x + HEAVEN_LASER_WIDTH) / 2.0f,
+                     enemyPos.y - (enemySize.y + HEAVEN_LASER_WIDTH) / 2.0f,
+                     enemySize.x + HEAVEN_LASER_WIDTH,
+                     enemySize.y + HEAVEN_LASER_WIDTH
+                  };
+                  float entry, exit;
+                  if (intersectSegmentBox(playerPos, Vector2Scale(beam.direction, HEAVEN_LASER_LENGTH),
+                                          reach, &entry, &exit))
                   {
-                     // Check perpendicular distance
-                     float perpDist = fabsf(toEnemy.x * (-beam.direction.y) + toEnemy.y * beam.direction.x);
-                     if (perpDist < HEAVEN_LASER_WIDTH + 20.0f) // Add some tolerance
-                     {
-                        // Hit! Deal damage
-                        beam.hitEnemies.insert(enemy);
-                        enemy->takeDamage(HEAVEN_LASER_DAMAGE);
-                        checkEnemyDeathAndGiveExp(enemy);
-                     }
+                     // Hit! Deal damage
+                     beam.hitEnemies.insert(enemy->getHandle());
+                     enemy->takeDamage(HEAVEN_LASER_DAMAGE);
+                     checkEnemyDeathAndGiveExp(enemy);
                   }
                }
             }
@@ -1605,16 +1568,6 @@ void LevelC::update(float deltaTime)
             }
          }
          
-         // Create laser beam animation atlas
-         std::vector<int> frames;
-         for (int i = 0; i < 8; ++i) frames.push_back(i);
-         std::map<Direction, std::vector<int>> laserAtlas = {
-            {RIGHT, frames},
-            {LEFT, frames},
-            {UP, frames},
-            {DOWN, frames}
-         };
-         
          // Position beam starting from player, stretched horizontally
          Vector2 beamPos = playerPos;
          beamPos.x += shotDir.x * (HEAVEN_LASER_LENGTH / 2.0f); // Center of beam
@@ -1629,67 +1582,43 @@ void LevelC::update(float deltaTime)
          const float LASER_FRAME_SPEED = 0.06f; // ~16fps (0.06 seconds per frame)
          const float LASER_LIFETIME = 0.6f; // Slightly longer than animation duration
          
-         Entity* laserBeam = new Entity(
+         Entity* laserBeam = spawnEffect(
             beamPos,
             {HEAVEN_LASER_LENGTH, HEAVEN_LASER_WIDTH}, // Stretched horizontally
             "assets/Effects/heavenLaser.png",
-            ATLAS,
             {8, 1}, // 8 columns, 1 row
-            laserAtlas,
-            EFFECT);
+            mLaserAtlas);
          
-         laserBeam->setIsEffect(true);
-         laserBeam->setEntityState(WALK);
-         laserBeam->setFrameSpeed(LASER_FRAME_SPEED);
-         laserBeam->setCheckCollision(false);
-         laserBeam->setLifetime(LASER_LIFETIME);
-         laserBeam->setDirection(RIGHT);
-         laserBeam->setAngle(angleDeg); // Rotate beam to face target
-         laserBeam->setWalkAnimations(laserAtlas);
-         
-         mGameState.collidableEntities.push_back(laserBeam);
+         if (laserBeam != nullptr)
+         {
+            laserBeam->setIsEffect(true);
+            laserBeam->setEntityState(WALK);
+            laserBeam->setFrameSpeed(LASER_FRAME_SPEED);
+            laserBeam->setCheckCollision(false);
+            laserBeam->setLifetime(LASER_LIFETIME);
+            laserBeam->setDirection(RIGHT);
+            laserBeam->setAngle(angleDeg); // Rotate beam to face target
+            laserBeam->setWalkAnimations(mLaserAtlas);
          
-         // Track this beam
-         LaserBeam beam;
-         beam.entity = laserBeam;
-         beam.direction = shotDir;
-         beam.lastDamageFrame = -1;
-         gActiveLaserBeams.push_back(beam);
+            // Track this beam
+            LaserBeam beam;
+            beam.entity = addEntity(laserBeam);
+            beam.direction = shotDir;
+            beam.lastDamageFrame = -1;
+            gActiveLaserBeams.push_back(beam);
          
-         // Play Heaven Laser sound (with safety check)
-         if (gHeavenLaserSound.frameCount > 0) PlaySound(gHeavenLaserSound);
-         // printf("[DEBUG] Laser beam fired!\n");
+            // Play Heaven Laser sound (with safety check)
+            VoicePool::play(gHeavenLaserSound);
+            // printf("[DEBUG] Laser beam fired!\n");
          
-         /*printf("[DEBUG] Laser beam created! Pos: (%.1f, %.1f), Scale: (%.1f, %.1f), Angle: %.1f\n",
-                beamPos.x, beamPos.y, laserBeam->getScale().x, laserBeam->getScale().y, angleDeg);
-                */
-      }
-   }
-
-   // ------------ Unified handling of all flying projectiles (blood bullet + arrow + enemy bullets) ------------
-   // Clean up pierce count of expired arrows
-   for (auto it = mArrowPierceCount.begin(); it != mArrowPierceCount.end();)
-   {
-      Entity *arrow = it->first;
-      bool found = false;
-      for (Entity *e : mGameState.collidableEntities)
-      {
-         if (e == arrow)
-         {
-            found = true;
-            break;
+            /*printf("[DEBUG] Laser beam created! Pos: (%.1f, %.1f), Scale: (%.1f, %.1f), Angle: %.1f\n",
+                   beamPos.x, beamPos.y, laserBeam->getScale().x, laserBeam->getScale().y, angleDeg);
+                   */
          }
       }
-      if (!found || !arrow || !arrow->isActive())
-      {
-         it = mArrowPierceCount.erase(it);
-      }
-      else
-      {
-         ++it;
-      }
    }
 
+   // ------------ Unified handling of all flying projectiles (blood bullet + arrow + enemy bullets) ------------
    const int PLAYER_PROJECTILE_DAMAGE = 5;  // Blood bullet base damage (increased 5x)
    const int FLYER_PROJECTILE_DAMAGE = 5; // Enemy bullet damage reduced from 10 to 5
    const int ARROW_DAMAGE = 20;            // Arrow damage (increased 5x)
@@ -1747,16 +1676,25 @@ void LevelC::update(float deltaTime)
       // ---------- Player bullet fallback: if colliders didn't record, manually check overlap with enemies ----------
       if (ownerIsPlayer && !hitIsEnemy)
       {
-         // Manually check player bullet collision with all enemies
-         for (Entity *enemy : mGameState.collidableEntities)
+         // Manually check player bullet collision with nearby enemies,
+         // anywhere along this tick's flight so fast arrows cannot skip one
+         Vector2 projPos  = proj->getPosition();
+         Vector2 projSize = proj->getColliderDimensions();
+         Vector2 flight   = Vector2Scale(proj->getVelocity(), deltaTime);
+         mCollisionGrid.query(
+            { projPos.x - flight.x / 2.0f, projPos.y - flight.y / 2.0f },
+            { projSize.x + fabsf(flight.x), projSize.y + fabsf(flight.y) },
+            NPC, mCollisionCandidates);
+
+         for (Entity *enemy : mCollisionCandidates)
          {
             if (!enemy || !enemy->isActive() || enemy->isDead())
                continue;
             if (enemy->getEntityType() != NPC)
                continue;
             
-            // Check if bullet overlaps with enemy
-            if (proj->overlaps(enemy))
+            // Check if bullet overlaps (or flew through) the enemy this tick
+            if (proj->sweepHits(enemy, deltaTime))
             {
                hit = enemy;
                hitIsEnemy = true;
@@ -1772,7 +1710,7 @@ void LevelC::update(float deltaTime)
          // Check if colliding with any shield
          for (Entity *shield : mOrbitShields)
          {
-            if (shield && shield->isActive() && proj->overlaps(shield))
+            if (shield && shield->isActive() && proj->sweepHits(shield, deltaTime))
             {
                // Blocked by shield, no damage dealt
                proj->deactivate();
@@ -1786,7 +1724,7 @@ void LevelC::update(float deltaTime)
          }
          
          // If not blocked, continue checking if colliding with player
-         if (proj->overlaps(mGameState.xochitl))
+         if (proj->sweepHits(mGameState.xochitl, deltaTime))
          {
             hit = mGameState.xochitl;
             hitIsPlayer = true;
@@ -1837,13 +1775,12 @@ void LevelC::update(float deltaTime)
          }
 
          // If arrow, check pierce
-         if (isArrow && mArrowPierceCount.find(proj) != mArrowPierceCount.end())
+         if (isArrow)
          {
-            mArrowPierceCount[proj]--;
-            if (mArrowPierceCount[proj] <= 0)
+            proj->setPierceRemaining(proj->getPierceRemaining() - 1);
+            if (proj->getPierceRemaining() <= 0)
             {
                // Pierce count exhausted, destroy arrow
-               mArrowPierceCount.erase(proj);
                proj->deactivate();
             }
             // Otherwise continue piercing, don't destroy
@@ -1860,7 +1797,7 @@ void LevelC::update(float deltaTime)
       if (!ownerIsPlayer && hitIsPlayer)
       {
          mGameState.xochitl->takeDamage(FLYER_PROJECTILE_DAMAGE);
-         if (gPlayerHurtSound.frameCount > 0) PlaySound(gPlayerHurtSound);
+         VoicePool::play(gPlayerHurtSound);
          proj->deactivate(); // Disappear immediately after hitting player
          continue;
       }
@@ -1882,6 +1819,10 @@ void LevelC::update(float deltaTime)
       // Ignore all other cases
    }
 
+   // Spent bullets, arrows and beams go back to the effect pool at the end
+   // of the tick
+   recycleInactiveEffects();
+
    // ========== LEVEL C: Survival Mode - Enemy Spawn System ==========
    // Update game timer
    mGameTimer += deltaTime;
@@ -1976,33 +1917,28 @@ void LevelC::update(float deltaTime)
    if (cleanupTimer >= 0.5f)
    {
       cleanupTimer = 0.0f;
-      for (auto it = mGameState.collidableEntities.begin(); it != mGameState.collidableEntities.end();)
+      for (Entity *e : mGameState.collidableEntities)
       {
-         Entity* e = *it;
          // Clean up dead enemies or inactive entities (but keep player and weapons)
          if (e && e != mGameState.xochitl)
          {
             // Only clean up dead or inactive NPC type entities
             if (e->getEntityType() == NPC && (e->isDead() || !e->isActive()))
             {
-               delete e; // Free memory
-               it = mGameState.collidableEntities.erase(it);
-               continue;
+               removeEntity(e); // Freed at the end of the tick
             }
             // Clean up inactive effect entities (bullets, arrows, etc.)
             else if (e->getEntityType() == EFFECT && !e->isActive())
             {
-               delete e; // Free memory
-               it = mGameState.collidableEntities.erase(it);
-               continue;
+               removeEntity(e); // Back to the pool, or freed if not pooled
             }
          }
-         ++it;
       }
    }
    
-   // Limit max enemy count (80 enemies max, or 100 if Heaven Laser unlocked)
-   const size_t MAX_ENEMIES = gHasHeavenLaser ? 100 : 80;
+   // Limit max enemy count (raised once the broadphase took over the
+   // pairwise tests; a little more headroom once Heaven Laser is unlocked)
+   const int MAX_ENEMIES = gHasHeavenLaser ? MAX_ENEMIES_ULTIMATE : MAX_ENEMIES_BASE;
    int enemyCount = 0;
    for (Entity *e : mGameState.collidableEntities)
    {
@@ -2016,18 +1952,11 @@ void LevelC::update(float deltaTime)
    if (enemyCount >= MAX_ENEMIES)
    {
       // Prioritize cleaning up dead enemies
-      for (auto it = mGameState.collidableEntities.begin(); 
-           it != mGameState.collidableEntities.end();)
+      for (Entity *e : mGameState.collidableEntities)
       {
-         Entity* e = *it;
          if (e && e != mGameState.xochitl && e->getEntityType() == NPC && e->isDead())
          {
-            delete e;
-            it = mGameState.collidableEntities.erase(it);
-         }
-         else
-         {
-            ++it;
+            removeEntity(e);
          }
       }
    }
@@ -2061,13 +1990,13 @@ void LevelC::update(float deltaTime)
             if (countActiveFlyers() >= currentMaxFlyers)
             {
                // Weights: 70% Follower, 30% Wanderer
-               int roll = GetRandomValue(0, 99);
+               int roll = mRandom.enemyRolls.range(0, 99);
                type = (roll < 70) ? 2 : 0; // 2=Follower, 0=Wanderer
             }
             else if (mGameTimer >= 60.0f)
             {
                // After 1 minute: Priority spawn Flyers (40% Flyer, 40% Follower, 20% Wanderer)
-               int roll = GetRandomValue(0, 99);
+               int roll = mRandom.enemyRolls.range(0, 99);
                if (roll < 40)
                {
                   type = 1; // Flyer (priority)
@@ -2084,7 +2013,7 @@ void LevelC::update(float deltaTime)
             else
             {
                // Before 1 minute: Normal weight system (60% Follower, 25% Wanderer, 15% Flyer)
-               int roll = GetRandomValue(0, 99);
+               int roll = mRandom.enemyRolls.range(0, 99);
                if (roll < 60)
                {
                   type = 2; // Follower
@@ -2328,7 +2257,7 @@ void LevelC::openLevelUpMenu()
    // 3) Randomly shuffle pool (simple Fisher-Yates shuffle)
    for (int i = (int)pool.size() - 1; i > 0; --i)
    {
-      int j = GetRandomValue(0, i);
+      int j = mRandom.levelUp.range(0, i);
       LevelUpOption temp = pool[i];
       pool[i] = pool[j];
       pool[j] = temp;
@@ -2346,17 +2275,17 @@ void LevelC::openLevelUpMenu()
 void LevelC::handleLevelUpInput()
 {
    // Keyboard: 1/2/3 to select directly
-   if (IsKeyPressed(KEY_ONE) && mLevelUpOptionCount >= 1)
+   if (Input::isKeyPressed(KEY_ONE) && mLevelUpOptionCount >= 1)
    {
       applyUpgradeChoice(0);
       return;
    }
-   if (IsKeyPressed(KEY_TWO) && mLevelUpOptionCount >= 2)
+   if (Input::isKeyPressed(KEY_TWO) && mLevelUpOptionCount >= 2)
    {
       applyUpgradeChoice(1);
       return;
    }
-   if (IsKeyPressed(KEY_THREE) && mLevelUpOptionCount >= 3)
+   if (Input::isKeyPressed(KEY_THREE) && mLevelUpOptionCount >= 3)
    {
       applyUpgradeChoice(2);
       return;
@@ -2388,7 +2317,7 @@ void LevelC::handleLevelUpInput()
       if (CheckCollisionPointRec(mouse, rect))
       {
          mLevelUpSelectedIndex = i;
-         if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+         if (Input::isMouseButtonPressed(MOUSE_LEFT_BUTTON))
          {
             applyUpgradeChoice(i);
             return;
@@ -2403,7 +2332,7 @@ void LevelC::applyUpgradeChoice(int index)
    gCheatModeActive = false;
    
    // Play upgrade selection sound effect
-   PlaySound(gChooseUpgradeSound);
+   VoicePool::play(gChooseUpgradeSound);
    if (index < 0 || index >= mLevelUpOptionCount || index >= MAX_LEVELUP_OPTIONS)
       return;
 
@@ -2455,8 +2384,7 @@ void LevelC::applyUpgradeChoice(int index)
             mSwordOverlaps.push_back(emptyList);
             mSwordAttackTimers.push_back(0.0f); // Initialize attack timer
 
-            mGameState.collidableEntities.push_back(sword);
-            mAutoAttacks.push_back(sword);
+            mAutoAttacks.push_back(addEntity(sword));
          }
       }
       break;
@@ -2506,8 +2434,7 @@ void LevelC::applyUpgradeChoice(int index)
             mOrbitShields.push_back(shield);
             mShieldAngles.push_back(baseAngle);
 
-            mAutoAttacks.push_back(shield);
-            mGameState.collidableEntities.push_back(shield);
+            mAutoAttacks.push_back(addEntity(shield));
          }
       }
       break;
@@ -2552,8 +2479,7 @@ void LevelC::applyUpgradeChoice(int index)
          flameAura->setWalkAnimations(flameAtlas); // Set WalkAnimations
          flameAura->setCheckCollision(false);
 
-         mAutoAttacks.push_back(flameAura);
-         mGameState.collidableEntities.push_back(flameAura);
+         mAutoAttacks.push_back(addEntity(flameAura));
       }
       // Aura upgrades (radius, damage) to be done later
       break;
@@ -2624,8 +2550,7 @@ void LevelC::applyUpgradeChoice(int index)
          mBowEmitter->setCheckCollision(false);
          mBowEmitter->setAttackInterval(mWeaponUpgrades.bowCooldown);
 
-         mAutoAttacks.push_back(mBowEmitter);
-         mGameState.collidableEntities.push_back(mBowEmitter);
+         mAutoAttacks.push_back(addEntity(mBowEmitter));
       }
       break;
    }
@@ -2675,15 +2600,7 @@ void LevelC::applyUpgradeChoice(int index)
          // First clean up old swords
          for (Entity *oldSword : mOrbitSwords)
          {
-            // Remove from collidableEntities and mAutoAttacks
-            mGameState.collidableEntities.erase(
-                std::remove(mGameState.collidableEntities.begin(), 
-                           mGameState.collidableEntities.end(), oldSword),
-                mGameState.collidableEntities.end());
-            mAutoAttacks.erase(
-                std::remove(mAutoAttacks.begin(), mAutoAttacks.end(), oldSword),
-                mAutoAttacks.end());
-            delete oldSword;
+            removeAutoAttack(oldSword);
          }
          mOrbitSwords.clear();
          mSwordAngles.clear();
@@ -2718,8 +2635,7 @@ void LevelC::applyUpgradeChoice(int index)
             mSwordOverlaps.push_back(emptyList);
             mSwordAttackTimers.push_back(0.0f); // Initialize attack timer
 
-            mGameState.collidableEntities.push_back(sw);
-            mAutoAttacks.push_back(sw);
+            mAutoAttacks.push_back(addEntity(sw));
          }
       }
       break;
@@ -2791,15 +2707,7 @@ void LevelC::applyUpgradeChoice(int index)
          // First clean up old ones
          for (Entity *shield : mOrbitShields)
          {
-            // Remove from collidableEntities and mAutoAttacks
-            mGameState.collidableEntities.erase(
-                std::remove(mGameState.collidableEntities.begin(), 
-                           mGameState.collidableEntities.end(), shield),
-                mGameState.collidableEntities.end());
-            mAutoAttacks.erase(
-                std::remove(mAutoAttacks.begin(), mAutoAttacks.end(), shield),
-                mAutoAttacks.end());
-            delete shield;
+            removeAutoAttack(shield);
          }
          mOrbitShields.clear();
          mShieldAngles.clear();
@@ -2832,8 +2740,7 @@ void LevelC::applyUpgradeChoice(int index)
             mOrbitShields.push_back(shield);
             mShieldAngles.push_back(baseAngle);
 
-            mAutoAttacks.push_back(shield);
-            mGameState.collidableEntities.push_back(shield);
+            mAutoAttacks.push_back(addEntity(shield));
          }
       }
       break;
@@ -2880,14 +2787,7 @@ void LevelC::applyUpgradeChoice(int index)
             float bowAngle = mBowEmitter->getAngle();
             
             // Remove old entity from lists
-            mGameState.collidableEntities.erase(
-                std::remove(mGameState.collidableEntities.begin(), 
-                           mGameState.collidableEntities.end(), mBowEmitter),
-                mGameState.collidableEntities.end());
-            mAutoAttacks.erase(
-                std::remove(mAutoAttacks.begin(), mAutoAttacks.end(), mBowEmitter),
-                mAutoAttacks.end());
-            delete mBowEmitter;
+            removeAutoAttack(mBowEmitter);
             
             // Recreate bow entity (with new material)
             std::vector<int> bowIdleFrames;
@@ -2916,8 +2816,7 @@ void LevelC::applyUpgradeChoice(int index)
             mBowEmitter->setAttackInterval(mWeaponUpgrades.bowCooldown);
             mBowEmitter->setAngle(bowAngle);
             
-            mAutoAttacks.push_back(mBowEmitter);
-            mGameState.collidableEntities.push_back(mBowEmitter);
+            mAutoAttacks.push_back(addEntity(mBowEmitter));
          }
       }
       break;
@@ -2950,14 +2849,7 @@ void LevelC::applyUpgradeChoice(int index)
                Vector2 bowPos = mBowEmitter->getPosition();
                float bowAngle = mBowEmitter->getAngle();
                
-               mGameState.collidableEntities.erase(
-                   std::remove(mGameState.collidableEntities.begin(), 
-                              mGameState.collidableEntities.end(), mBowEmitter),
-                   mGameState.collidableEntities.end());
-               mAutoAttacks.erase(
-                   std::remove(mAutoAttacks.begin(), mAutoAttacks.end(), mBowEmitter),
-                   mAutoAttacks.end());
-               delete mBowEmitter;
+               removeAutoAttack(mBowEmitter);
                
                std::vector<int> bowIdleFrames;
                bowIdleFrames.push_back(104);
@@ -2985,8 +2877,7 @@ void LevelC::applyUpgradeChoice(int index)
                mBowEmitter->setAttackInterval(mWeaponUpgrades.bowCooldown);
                mBowEmitter->setAngle(bowAngle);
                
-               mAutoAttacks.push_back(mBowEmitter);
-               mGameState.collidableEntities.push_back(mBowEmitter);
+               mAutoAttacks.push_back(addEntity(mBowEmitter));
             }
          }
       }
@@ -3010,8 +2901,9 @@ void LevelC::applyUpgradeChoice(int index)
          mWeaponUpgrades.auraUpgradeCount++;
 
          // Update all aura entity radii
-         for (Entity *entity : mAutoAttacks)
+         for (EntityHandle handle : mAutoAttacks)
          {
+            Entity *entity = getEntity(handle);
             if (entity && entity->getAttackType() == AURA)
             {
                entity->setAttackRadius(mWeaponUpgrades.auraRadius);
@@ -3096,10 +2988,8 @@ void LevelC::applyUpgradeChoice(int index)
          if (gBloodEmitter != nullptr)
          {
             Entity* temp = gBloodEmitter;
-            gBloodEmitter = nullptr; // Clear first to prevent double delete
-            mAutoAttacks.erase(std::remove(mAutoAttacks.begin(), mAutoAttacks.end(), temp), mAutoAttacks.end());
-            mGameState.collidableEntities.erase(std::remove(mGameState.collidableEntities.begin(), mGameState.collidableEntities.end(), temp), mGameState.collidableEntities.end());
-            delete temp;
+            gBloodEmitter = nullptr; // Clear first, freed at the end of the tick
+            removeAutoAttack(temp);
             // printf("[DEBUG] Blood emitter removed (upgrade menu)\n");
          }
          
@@ -3107,10 +2997,8 @@ void LevelC::applyUpgradeChoice(int index)
          if (mBowEmitter != nullptr)
          {
             Entity* temp = mBowEmitter;
-            mBowEmitter = nullptr; // Clear first to prevent double delete
-            mAutoAttacks.erase(std::remove(mAutoAttacks.begin(), mAutoAttacks.end(), temp), mAutoAttacks.end());
-            mGameState.collidableEntities.erase(std::remove(mGameState.collidableEntities.begin(), mGameState.collidableEntities.end(), temp), mGameState.collidableEntities.end());
-            delete temp;
+            mBowEmitter = nullptr; // Clear first, freed at the end of the tick
+            removeAutoAttack(temp);
             // printf("[DEBUG] Bow emitter removed (upgrade menu)\n");
          }
       }
@@ -3146,14 +3034,19 @@ void LevelC::applyUpgradeChoice(int index)
 void LevelC::render()
 {
    ClearBackground(ColorFromHex(mBGColourHexCode));
+   beginCulling();
 
-   // 1. Render map first (bottom layer)
-   mGameState.map->render();
+   // 1. Render map first (bottom layer), only the part the camera shows
+   SpriteBatch::setLayer(LAYER_MAP);
+   mGameState.map->render(mVisibleArea);
 
    // 2. Render Aura (below player), slightly dimmed
-   for (Entity *entity : mAutoAttacks)
+   SpriteBatch::setLayer(LAYER_GROUND);
+   for (EntityHandle handle : mAutoAttacks)
    {
-      if (entity && entity->getAttackType() == AURA && entity->isActive())
+      Entity *entity = getEntity(handle);
+      if (entity && entity->getAttackType() == AURA && entity->isActive() &&
+          isOnScreen(entity))
       {
          // Debug: Check Aura animation state
          static int auraDebugCounter = 0;
@@ -3173,9 +3066,12 @@ void LevelC::render()
    }
 
    // 3. Render player
+   SpriteBatch::setLayer(LAYER_PLAYER);
    mGameState.xochitl->render();
    
-   // 4. Finally render other entities (enemies, weapons, etc., on top layer)
+   // 4. Finally render other entities (enemies, weapons, etc., on top layer);
+   // the batch groups these by sprite sheet
+   SpriteBatch::setLayer(LAYER_ENTITIES);
    for (int i = 0; i < mGameState.collidableEntities.size(); ++i)
    {
       if (mGameState.collidableEntities[i])
@@ -3184,7 +3080,7 @@ void LevelC::render()
          // Skip aura effect entity since it's already rendered
          // Only skip if EFFECT type and attackType is AURA
          bool isAuraEffect = (entity->getEntityType() == EFFECT && entity->getAttackType() == AURA);
-         if (!isAuraEffect)
+         if (!isAuraEffect && entity->isActive() && isOnScreen(entity))
          {
             entity->render();
          }
@@ -3192,11 +3088,13 @@ void LevelC::render()
    }
    
    // Render active laser beams directly (they might not be in collidableEntities yet)
+   SpriteBatch::setLayer(LAYER_OVERLAY);
    for (const LaserBeam& beam : gActiveLaserBeams)
    {
-      if (beam.entity && beam.entity->isActive())
+      Entity *laser = getEntity(beam.entity);
+      if (laser && laser->isActive() && isOnScreen(laser))
       {
-         beam.entity->render();
+         laser->render();
       }
    }
 }
@@ -3394,38 +3292,13 @@ void LevelC::renderLevelUpOverlay()
 
 void LevelC::shutdown()
 {
-   // Unload BGM
-   if (mGameState.bgm.frameCount > 0)
-   {
-      StopMusicStream(mGameState.bgm);
-      UnloadMusicStream(mGameState.bgm);
-   }
-   
    // Unload sound effects
-   if (gBloodBulletSound.frameCount > 0)
-   {
-      UnloadSound(gBloodBulletSound);
-   }
-   if (gUpgradeSound.frameCount > 0)
-   {
-      UnloadSound(gUpgradeSound);
-   }
-   if (gChooseUpgradeSound.frameCount > 0)
-   {
-      UnloadSound(gChooseUpgradeSound);
-   }
-   if (gHeavenLaserSound.frameCount > 0)
-   {
-      UnloadSound(gHeavenLaserSound);
-   }
-   if (gPlayerDeadSound.frameCount > 0)
-   {
-      UnloadSound(gPlayerDeadSound);
-   }
-   if (gPlayerHurtSound.frameCount > 0)
-   {
-      UnloadSound(gPlayerHurtSound);
-   }
+   VoicePool::unload(gBloodBulletSound);
+   VoicePool::unload(gUpgradeSound);
+   VoicePool::unload(gChooseUpgradeSound);
+   VoicePool::unload(gHeavenLaserSound);
+   VoicePool::unload(gPlayerDeadSound);
+   VoicePool::unload(gPlayerHurtSound);
    
    // printf("LevelC::shutdown()");
    Scene::shutdown();
@@ -3433,26 +3306,28 @@ void LevelC::shutdown()
 
 void LevelC::spawnEnemy(int type, float difficulty)
 {
-   Vector2 spawnPos = getRandomSpawnPosition(mGameState.xochitl->getPosition(), 150.0f, mOrigin);
+   Vector2 spawnPos = getRandomSpawnPosition(mGameState.xochitl->getPosition(), 150.0f, mOrigin,
+      mRandom.spawns);
    
-   std::map<Direction, std::vector<int>> WandererAtlas = {
+   // Interned on the first spawn; every later enemy just takes the IDs
+   static const int WandererAtlas = AnimationClips::internWalkSet({
       {RIGHT, {1, 2, 3, 4, 5, 6, 7}},
       {LEFT, {1, 2, 3, 4, 5, 6, 7}},
       {UP, {1, 2, 3, 4, 5, 6, 7}},
       {DOWN, {1, 2, 3, 4, 5, 6, 7}},
-   };
+   });
    
-   std::map<Direction, std::vector<int>> FlyerAtlas = {
+   static const int FlyerAtlas = AnimationClips::internWalkSet({
       {RIGHT, {1, 2, 3, 4}},
       {LEFT, {1, 2, 3, 4}},
       {UP, {1, 2, 3, 4}},
       {DOWN, {1, 2, 3, 4}},
-   };
+   });
    
-   std::map<Direction, std::vector<int>> FollowerAtlas = {
+   static const int FollowerAtlas = AnimationClips::internWalkSet({
       {LEFT, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}},
       {RIGHT, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}},
-   };
+   });
    
    Entity *enemy = nullptr;
    
@@ -3543,7 +3418,7 @@ void LevelC::spawnEnemy(int type, float difficulty)
       enemy->setSpawnInvincible(0.0f);
       enemy->setAcceleration({0.0f, 0.0f});
       enemy->render();
-      mGameState.collidableEntities.push_back(enemy);
+      addEntity(enemy);
    }
 }
 
@@ -3575,6 +3450,19 @@ int LevelC::countActiveFlyers()
    return count;
 }
 
+// Drops a weapon entity from mAutoAttacks and queues it for removal; it is
+// freed at the end of the tick
+void LevelC::removeAutoAttack(Entity *entity)
+{
+   if (!entity)
+      return;
+
+   mAutoAttacks.erase(
+       std::remove(mAutoAttacks.begin(), mAutoAttacks.end(), entity->getHandle()),
+       mAutoAttacks.end());
+   removeEntity(entity);
+}
+
 int LevelC::getTotalWeaponLevel()
 {
    int total = 0;
@@ -1,5 +1,6 @@
 #pragma once
 #include "Scene.h"
+#include "SpatialHash.h"
 
 // Main Level C: 2-minute Survival
 // Full game with upgrade system, dynamic difficulty, and enemy waves
@@ -43,10 +44,16 @@ public:
     static constexpr float TILE_DIMENSION = 25.0f;
     static constexpr float SURVIVAL_TIME = 120.0f;  // 2 minutes
     static constexpr int MAX_FLYERS = 5;
+    static constexpr int MAX_ENEMIES_BASE = 2000;
+    static constexpr int MAX_ENEMIES_ULTIMATE = 3000; // with Heaven Laser
+    static constexpr int EFFECT_POOL_CAPACITY = 1024;
 
     LevelC();
     LevelC(Vector2 origin, const char *bgHexCode);
     ~LevelC();
+
+    // Every sheet and sound initialise() loads; LevelCTitle prefetches it
+    static const AssetManifest &getAssetManifest();
     
     void initialise() override;
     void update(float deltaTime) override;
@@ -55,8 +62,6 @@ public:
     void shutdown() override;
     
     // Game systems
-    Entity* findClosestEnemy(Vector2 pos);
-    std::vector<Entity*> findClosestEnemies(Vector2 pos, int count); // For Heaven Laser targeting
     void openLevelUpMenu();
     void handleLevelUpInput();
     void renderLevelUpOverlay();
@@ -65,6 +70,7 @@ public:
     void spawnWave(int followerCount);
     int countActiveFlyers();
     int getTotalWeaponLevel();
+    void removeAutoAttack(Entity *entity);
     
     // Timer
     float mGameTimer = 0.0f;
@@ -134,10 +140,12 @@ public:
     int mLevelUpSelectedIndex = -1;
     LevelUpOption mLevelUpOptions[MAX_LEVELUP_OPTIONS];
     
-    // Auto attacks
-    std::vector<Entity*> mAutoAttacks;
-    std::map<Direction, std::vector<int>> mProjectileAtlas;
-    std::map<Direction, std::vector<int>> mFlyerProjectileAtlas;
+    // Auto attacks (handles into collidableEntities)
+    std::vector<EntityHandle> mAutoAttacks;
+    int mProjectileAtlas; // walk sets interned in AnimationClips
+    int mFlyerProjectileAtlas;
+    int mArrowAtlas;
+    int mLaserAtlas;
     
     // Sword orbiting
     std::vector<Entity*> mOrbitSwords;
@@ -150,9 +158,11 @@ public:
     std::vector<Entity*> mOrbitShields;
     std::vector<float> mShieldAngles;
     
-    // Arrow pierce tracking
-    std::map<Entity*, int> mArrowPierceCount;
-    
     // Aura damage timer
     float mAuraDamageTimer = 0.0f;
+
+    // Entity broadphase, one cell per tile. The slack covers shield
+    // knockback, which moves enemies after the grid is built.
+    SpatialHash mCollisionGrid { TILE_DIMENSION, 4.0f };
+    std::vector<Entity*> mCollisionCandidates;
 };
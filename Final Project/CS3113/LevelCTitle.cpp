@@ -1,4 +1,5 @@
 #include "LevelCTitle.h"
+#include "LevelC.h"
 #include <iostream>
 
 LevelCTitle::LevelCTitle() : Scene{{0.0f}, nullptr} {}
@@ -8,13 +9,15 @@ LevelCTitle::~LevelCTitle() {}
 void LevelCTitle::initialise()
 {
     Scene::initialise();
+    // decode the level's sheets and sounds while the title is up
+    AssetLoader::prefetch(LevelC::getAssetManifest());
     mGameState.nextSceneID = -1;
     mTimer = 0.0f;
 }
 
 void LevelCTitle::update(float deltaTime)
 {
-    if (IsKeyPressed(KEY_ENTER))
+    if (Input::isKeyPressed(KEY_ENTER))
     {
         mGameState.nextSceneID = 2; // Go to LevelC
     }
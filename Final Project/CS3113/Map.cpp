@@ -1,15 +1,48 @@
 #include "Map.h"
+#include "SpriteAtlas.h"
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <sstream>
 
 Map::Map(int mapColumns, int mapRows, unsigned int *levelData,
          const char *textureFilePath, float tileSize, int textureColumns,
          int textureRows, Vector2 origin) : 
          mMapColumns {mapColumns}, mMapRows {mapRows}, 
-         mTextureAtlas { LoadTexture(textureFilePath) },
          mLevelData {levelData }, mTileSize {tileSize}, 
          mTextureColumns {textureColumns}, mTextureRows {textureRows},
-         mOrigin {origin} { build(); }
+         mOrigin {origin}
+{
+    mSheet = SpriteAtlas::findSheet(textureFilePath, mTextureRows, mTextureColumns);
+    loadTileProperties(textureFilePath);
+    build();
+}
+
+Map::Map(const char *mapFilePath, const char *textureFilePath, float tileSize,
+         int textureColumns, int textureRows, Vector2 origin) :
+         mMapColumns {0}, mMapRows {0},
+         mLevelData {nullptr}, mTileSize {tileSize},
+         mTextureColumns {textureColumns}, mTextureRows {textureRows},
+         mOrigin {origin}
+{
+    mSheet = SpriteAtlas::findSheet(textureFilePath, mTextureRows, mTextureColumns);
+    if (mFile.open(mapFilePath))
+    {
+        mMapColumns = mFile.getColumns();
+        mMapRows    = mFile.getRows();
+    }
+    else TraceLog(LOG_WARNING, "MAP: Failed to open map file %s", mapFilePath);
 
-Map::~Map() { UnloadTexture(mTextureAtlas); }
+    loadTileProperties(textureFilePath);
+    build();
+}
+
+static bool gLiveRendering = false;
+
+Map::~Map() 
+{ 
+    for (Chunk &chunk : mChunks)
+        if (chunk.target.id != 0) UnloadRenderTexture(chunk.target);
+}
 
 void Map::build()
 {
@@ -19,36 +52,100 @@ void Map::build()
     mTopBoundary    = mOrigin.y - (mMapRows * mTileSize) / 2.0f;
     mBottomBoundary = mOrigin.y + (mMapRows * mTileSize) / 2.0f;
 
-    // Precompute texture areas for each tile
-    float tileWidth = (float)mTextureAtlas.width / (float)mTextureColumns;
-    float tileHeight = (float)mTextureAtlas.height / (float)mTextureRows;
-    
-    for (int row = 0; row < mTextureRows; row++)
+    buildChunks();
+
+    // streamed maps get their solidity rows as chunks are paged in
+    if (mLevelData != nullptr)
+        for (int chunkIndex = 0; chunkIndex < (int) mChunks.size(); chunkIndex++)
+            buildSolidRows(chunkIndex);
+}
+
+void Map::loadTileProperties(const char *textureFilePath)
+{
+    // every tile of the sheet is solid unless the table says otherwise
+    mTileFlags.assign(mTextureColumns * mTextureRows + 1, TILE_SOLID);
+    mTileFlags[0] = 0;
+
+    std::string path = textureFilePath;
+    size_t extension = path.find_last_of('.');
+    if (extension != std::string::npos && extension > path.find_last_of("/\\") + 1)
+        path.erase(extension);
+    path += ".tiles";
+
+    if (!FileExists(path.c_str())) return;
+    char *text = LoadFileText(path.c_str());
+    if (text == nullptr) return;
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line))
     {
-        for (int col = 0; col < mTextureColumns; col++)
-        {
-            Rectangle textureArea = {
-                (float)col * tileWidth,
-                (float)row * tileHeight,
-                tileWidth,
-                tileHeight
-            };
+        std::istringstream words(line.substr(0, line.find('#')));
+        unsigned int tile;
+        if (!(words >> tile) || tile == 0) continue; // 0 is always empty
 
-            mTextureAreas.push_back(textureArea);
+        unsigned char flags = TILE_SOLID;
+        std::string property;
+        while (words >> property)
+        {
+            if      (property == "solid")    flags |= TILE_SOLID;
+            else if (property == "passable") flags &= ~TILE_SOLID;
+            else TraceLog(LOG_WARNING, "MAP: Unknown tile property '%s' in %s",
+                          property.c_str(), path.c_str());
         }
+
+        if (tile >= mTileFlags.size()) mTileFlags.resize(tile + 1, TILE_SOLID);
+        mTileFlags[tile] = flags;
     }
+
+    UnloadFileText(text);
 }
 
-void Map::render()
+unsigned char Map::flagsOf(unsigned int tile) const
+{
+    if (tile < mTileFlags.size()) return mTileFlags[tile];
+    return tile == 0 ? 0 : TILE_SOLID;
+}
+
+void Map::setTileFlags(unsigned int tile, unsigned char flags)
+{
+    if (tile == 0) return;
+    if (tile >= mTileFlags.size()) mTileFlags.resize(tile + 1, TILE_SOLID);
+    mTileFlags[tile] = flags;
+
+    for (int chunkIndex = 0; chunkIndex < (int) mChunks.size(); chunkIndex++)
+        buildSolidRows(chunkIndex);
+}
+
+void Map::buildSolidRows(int chunkIndex)
+{
+    const Chunk &chunk = mChunks[chunkIndex];
+    int block = mLevelData != nullptr ? chunkIndex : chunk.slot;
+    if (block < 0) return;
+
+    if (mSolidRows.size() < (size_t) (block + 1) * CHUNK_TILES)
+        mSolidRows.resize((size_t) (block + 1) * CHUNK_TILES, 0);
+
+    for (int row = 0; row < CHUNK_TILES; row++)
+    {
+        unsigned int mask = 0;
+        for (int col = 0; row < chunk.rows && col < chunk.columns; col++)
+            if (flagsOf(tileAt(chunk.firstColumn + col, chunk.firstRow + row)) & TILE_SOLID)
+                mask |= 1u << col;
+        mSolidRows[block * CHUNK_TILES + row] = mask;
+    }
+}
+
+void Map::renderTiles(int firstColumn, int firstRow, int columns, int rows)
 {
     // Draw each tile in the map
-    for (int row = 0; row < mMapRows; row++)
+    for (int row = firstRow; row < firstRow + rows; row++)
     {
         // Draw each column in the row
-        for (int col = 0; col < mMapColumns; col++)
+        for (int col = firstColumn; col < firstColumn + columns; col++)
         {
             // Get the tile index at the current row and column
-            int tile = mLevelData[row * mMapColumns + col];
+            int tile = tileAt(col, row);
 
             // If the tile index is 0, we do not draw anything
             if (tile == 0) continue;
@@ -60,10 +157,11 @@ void Map::render()
                 mTileSize
             };
 
-            // Draw the tile
-            DrawTexturePro(
-                mTextureAtlas,
-                mTextureAreas[tile - 1], // -1 because tile indices start at 1
+            // Draw the tile (-1 because tile indices start at 1)
+            const SpriteFrame &frame = SpriteAtlas::frame(mSheet, tile - 1);
+            SpriteBatch::draw(
+                frame.texture,
+                frame.source,
                 destinationArea,
                 {0.0f, 0.0f}, // origin
                 0.0f,         // rotation
@@ -73,25 +171,338 @@ void Map::render()
     }
 }
 
+void Map::render()
+{
+    render({ mLeftBoundary, mTopBoundary, mRightBoundary - mLeftBoundary,
+             mBottomBoundary - mTopBoundary });
+}
+
+void Map::render(Rectangle visibleArea)
+{
+    // tile range under the visible area, clamped to the map
+    int firstColumn = (int) floorf((visibleArea.x - mLeftBoundary) / mTileSize);
+    int firstRow    = (int) floorf((visibleArea.y - mTopBoundary)  / mTileSize);
+    int lastColumn  = (int) floorf((visibleArea.x + visibleArea.width  - mLeftBoundary) / mTileSize);
+    int lastRow     = (int) floorf((visibleArea.y + visibleArea.height - mTopBoundary)  / mTileSize);
+
+    firstColumn = std::max(firstColumn, 0);
+    firstRow    = std::max(firstRow, 0);
+    lastColumn  = std::min(lastColumn, mMapColumns - 1);
+    lastRow     = std::min(lastRow, mMapRows - 1);
+
+    mDrawnCount  = 0;
+    mCulledCount = 0;
+
+    if (gLiveRendering)
+    {
+        int columns = std::max(lastColumn - firstColumn + 1, 0);
+        int rows    = std::max(lastRow    - firstRow    + 1, 0);
+        if (columns > 0 && rows > 0) renderTiles(firstColumn, firstRow, columns, rows);
+
+        mDrawnCount  = columns * rows;
+        mCulledCount = mMapColumns * mMapRows - mDrawnCount;
+        return;
+    }
+
+    // only the chunks under that range are visited, however large the map
+    if (firstColumn <= lastColumn && firstRow <= lastRow)
+    {
+        for (int chunkRow = firstRow / CHUNK_TILES; chunkRow <= lastRow / CHUNK_TILES; chunkRow++)
+        {
+            for (int chunkCol = firstColumn / CHUNK_TILES; chunkCol <= lastColumn / CHUNK_TILES;
+                 chunkCol++)
+            {
+                Chunk &chunk = mChunks[chunkRow * mChunkColumns + chunkCol];
+                mDrawnCount++;
+                if (chunk.empty) continue;
+
+                // not baked yet (no GL context so far) or empty
+                if (chunk.target.id == 0 || chunk.dirty)
+                {
+                    int fromColumn = std::max(chunk.firstColumn, firstColumn);
+                    int fromRow    = std::max(chunk.firstRow, firstRow);
+                    int toColumn   = std::min(chunk.firstColumn + chunk.columns - 1, lastColumn);
+                    int toRow      = std::min(chunk.firstRow    + chunk.rows    - 1, lastRow);
+                    renderTiles(fromColumn, fromRow, toColumn - fromColumn + 1,
+                        toRow - fromRow + 1);
+                    continue;
+                }
+
+                float width  = chunk.columns * mTileSize;
+                float height = chunk.rows    * mTileSize;
+
+                // render textures are stored bottom-up, hence the negative height
+                SpriteBatch::draw(
+                    chunk.target.texture,
+                    { 0.0f, 0.0f, (float) chunk.target.texture.width, 
+                      -(float) chunk.target.texture.height },
+                    { mLeftBoundary + chunk.firstColumn * mTileSize,
+                      mTopBoundary  + chunk.firstRow    * mTileSize, width, height },
+                    { 0.0f, 0.0f }, 0.0f, WHITE
+                );
+            }
+        }
+    }
+
+    mCulledCount = (int) mChunks.size() - mDrawnCount;
+}
+
+void Map::buildChunks()
+{
+    mChunkColumns = (mMapColumns + CHUNK_TILES - 1) / CHUNK_TILES;
+    mChunkRows    = (mMapRows    + CHUNK_TILES - 1) / CHUNK_TILES;
+
+    for (Chunk &chunk : mChunks)
+        if (chunk.target.id != 0) UnloadRenderTexture(chunk.target);
+    mChunks.clear();
+    mResidentTiles.clear();
+    mSlotChunks.clear();
+    mSolidRows.clear();
+
+    for (int chunkRow = 0; chunkRow < mChunkRows; chunkRow++)
+    {
+        for (int chunkCol = 0; chunkCol < mChunkColumns; chunkCol++)
+        {
+            Chunk chunk;
+            chunk.target      = RenderTexture2D { 0 };
+            chunk.firstColumn = chunkCol * CHUNK_TILES;
+            chunk.firstRow    = chunkRow * CHUNK_TILES;
+            chunk.columns     = std::min(mMapColumns - chunk.firstColumn, (int) CHUNK_TILES);
+            chunk.rows        = std::min(mMapRows    - chunk.firstRow,    (int) CHUNK_TILES);
+            chunk.dirty       = true;
+            chunk.slot        = -1;
+            chunk.pinned      = false;
+            chunk.lastSeen    = 0;
+            chunk.empty       = mFile.isOpen() &&
+                                mFile.isChunkEmpty(chunkRow * mChunkColumns + chunkCol);
+            mChunks.push_back(chunk);
+        }
+    }
+}
+
+void Map::bakeChunk(Chunk &chunk)
+{
+    chunk.dirty = false;
+
+    bool hasTiles = false;
+    for (int row = chunk.firstRow; row < chunk.firstRow + chunk.rows && !hasTiles; row++)
+        for (int col = chunk.firstColumn; col < chunk.firstColumn + chunk.columns; col++)
+            if (tileAt(col, row) != 0) { hasTiles = true; break; }
+
+    chunk.empty = !hasTiles;
+    if (!hasTiles)
+    {
+        if (chunk.target.id != 0) UnloadRenderTexture(chunk.target);
+        chunk.target = RenderTexture2D { 0 };
+        return;
+    }
+
+    if (chunk.target.id == 0)
+    {
+        chunk.target = LoadRenderTexture((int) ceilf(chunk.columns * mTileSize),
+                                         (int) ceilf(chunk.rows    * mTileSize));
+        if (chunk.target.id == 0) return; // stays on live drawing
+    }
+
+    // draw the chunk's tiles at the texture's origin
+    Camera2D camera = { 0 };
+    camera.offset = { 0.0f, 0.0f };
+    camera.target = { mLeftBoundary + chunk.firstColumn * mTileSize,
+                      mTopBoundary  + chunk.firstRow    * mTileSize };
+    camera.zoom   = 1.0f;
+
+    BeginTextureMode(chunk.target);
+    ClearBackground(BLANK);
+    BeginMode2D(camera);
+    renderTiles(chunk.firstColumn, chunk.firstRow, chunk.columns, chunk.rows);
+    EndMode2D();
+    EndTextureMode();
+}
+
+void Map::bakeDirtyChunks()
+{
+    if (gLiveRendering) return;
+
+    // a streamed chunk is baked once it is paged in, not before, so only
+    // the resident ones (at most mResidentLimit) need looking at
+    if (mFile.isOpen())
+    {
+        for (int chunkIndex : mSlotChunks)
+            if (chunkIndex >= 0 && mChunks[chunkIndex].dirty) bakeChunk(mChunks[chunkIndex]);
+        return;
+    }
+
+    for (Chunk &chunk : mChunks)
+        if (chunk.dirty) bakeChunk(chunk);
+}
+
+void Map::setTile(int column, int row, unsigned int tile)
+{
+    if (column < 0 || column >= mMapColumns || row < 0 || row >= mMapRows) return;
+
+    int chunkIndex = (row / CHUNK_TILES) * mChunkColumns + column / CHUNK_TILES;
+    Chunk &chunk = mChunks[chunkIndex];
+
+    if (mLevelData != nullptr) mLevelData[row * mMapColumns + column] = tile;
+    else
+    {
+        // the file is read-only, so the edit lives in the resident copy,
+        // which then has to stay
+        if (chunk.slot < 0) pageIn(chunkIndex, true);
+        chunk.pinned = true;
+        mResidentTiles[chunk.slot * CHUNK_TILES * CHUNK_TILES +
+            (row % CHUNK_TILES) * CHUNK_TILES + column % CHUNK_TILES] = tile;
+    }
+
+    chunk.dirty = true;
+    chunk.empty = false;
+
+    int block = mLevelData != nullptr ? chunkIndex : chunk.slot;
+    unsigned int bit = 1u << (column % CHUNK_TILES);
+    unsigned int &mask = mSolidRows[block * CHUNK_TILES + row % CHUNK_TILES];
+    mask = (flagsOf(tile) & TILE_SOLID) ? (mask | bit) : (mask & ~bit);
+}
+
+unsigned int Map::tileAt(int column, int row) const
+{
+    if (mLevelData != nullptr) return mLevelData[row * mMapColumns + column];
+
+    const Chunk &chunk = mChunks[(row / CHUNK_TILES) * mChunkColumns + column / CHUNK_TILES];
+    if (chunk.slot < 0) return mFile.readTile(column, row);
+
+    return mResidentTiles[chunk.slot * CHUNK_TILES * CHUNK_TILES +
+        (row % CHUNK_TILES) * CHUNK_TILES + column % CHUNK_TILES];
+}
+
+void Map::stream(Rectangle visibleArea)
+{
+    if (!mFile.isOpen()) return;
+    mStreamCount++;
+
+    float chunkSize = CHUNK_TILES * mTileSize;
+    float margin    = STREAM_MARGIN_TILES * mTileSize;
+    int firstChunkColumn = (int) floorf((visibleArea.x - margin - mLeftBoundary) / chunkSize);
+    int firstChunkRow    = (int) floorf((visibleArea.y - margin - mTopBoundary)  / chunkSize);
+    int lastChunkColumn  = (int) floorf((visibleArea.x + visibleArea.width  + margin - mLeftBoundary) / chunkSize);
+    int lastChunkRow     = (int) floorf((visibleArea.y + visibleArea.height + margin - mTopBoundary)  / chunkSize);
+
+    firstChunkColumn = std::max(firstChunkColumn, 0);
+    firstChunkRow    = std::max(firstChunkRow, 0);
+    lastChunkColumn  = std::min(lastChunkColumn, mChunkColumns - 1);
+    lastChunkRow     = std::min(lastChunkRow, mChunkRows - 1);
+
+    // mark the whole range first, so paging in one chunk never evicts
+    // another one that is also in view
+    for (int chunkRow = firstChunkRow; chunkRow <= lastChunkRow; chunkRow++)
+        for (int chunkCol = firstChunkColumn; chunkCol <= lastChunkColumn; chunkCol++)
+            mChunks[chunkRow * mChunkColumns + chunkCol].lastSeen = mStreamCount;
+
+    for (int chunkRow = firstChunkRow; chunkRow <= lastChunkRow; chunkRow++)
+    {
+        for (int chunkCol = firstChunkColumn; chunkCol <= lastChunkColumn; chunkCol++)
+        {
+            int chunkIndex = chunkRow * mChunkColumns + chunkCol;
+            const Chunk &chunk = mChunks[chunkIndex];
+            if (chunk.slot < 0 && !chunk.empty) pageIn(chunkIndex, false);
+        }
+    }
+}
+
+int Map::acquireSlot(bool force)
+{
+    int victim = -1;
+    for (int slot = 0; slot < (int) mSlotChunks.size(); slot++)
+    {
+        if (mSlotChunks[slot] < 0) return slot;
+
+        // least recently seen chunk that is neither in view nor edited
+        const Chunk &chunk = mChunks[mSlotChunks[slot]];
+        if (chunk.pinned || chunk.lastSeen == mStreamCount) continue;
+        if (victim < 0 || chunk.lastSeen < mChunks[mSlotChunks[victim]].lastSeen)
+            victim = slot;
+    }
+
+    if ((int) mSlotChunks.size() < mResidentLimit || (victim < 0 && force))
+    {
+        mSlotChunks.push_back(-1);
+        mResidentTiles.resize(mSlotChunks.size() * CHUNK_TILES * CHUNK_TILES);
+        return (int) mSlotChunks.size() - 1;
+    }
+    if (victim < 0) return -1;
+
+    pageOut(mSlotChunks[victim]);
+    return victim;
+}
+
+void Map::pageIn(int chunkIndex, bool force)
+{
+    int slot = acquireSlot(force);
+    if (slot < 0) return; // over the limit: drawn from the file instead
+
+    Chunk &chunk = mChunks[chunkIndex];
+    mFile.readChunk(chunkIndex, &mResidentTiles[slot * CHUNK_TILES * CHUNK_TILES]);
+    mSlotChunks[slot] = chunkIndex;
+    chunk.slot  = slot;
+    chunk.dirty = true;
+    buildSolidRows(chunkIndex);
+    mPageIns++;
+}
+
+void Map::pageOut(int chunkIndex)
+{
+    Chunk &chunk = mChunks[chunkIndex];
+    if (chunk.target.id != 0) UnloadRenderTexture(chunk.target);
+
+    mSlotChunks[chunk.slot] = -1;
+    chunk.target = RenderTexture2D { 0 };
+    chunk.slot   = -1;
+    chunk.dirty  = true;
+    mFile.releaseChunk(chunkIndex);
+    mPageOuts++;
+}
+
+void Map::setResidentChunkLimit(int chunks)
+{
+    mResidentLimit = std::max(chunks, 1);
+}
+
+int Map::getResidentChunks() const
+{
+    int resident = 0;
+    for (int chunkIndex : mSlotChunks)
+        if (chunkIndex >= 0) resident++;
+    return resident;
+}
+
+size_t Map::getResidentBytes() const
+{
+    return mResidentTiles.size() * sizeof(unsigned int) + getBakedBytes();
+}
+
+size_t Map::getBakedBytes() const
+{
+    size_t bytes = 0;
+    for (const Chunk &chunk : mChunks)
+        if (chunk.target.id != 0)
+            bytes += (size_t) GetPixelDataSize(chunk.target.texture.width,
+                chunk.target.texture.height, chunk.target.texture.format);
+    return bytes;
+}
+
+void Map::setLiveRendering(bool live) { gLiveRendering = live; }
+bool Map::isLiveRendering()           { return gLiveRendering; }
+
 bool Map::isSolidTileAt(Vector2 position, float *xOverlap, float *yOverlap)
 {
     *xOverlap = 0.0f;
     *yOverlap = 0.0f;
 
-    if (position.x < mLeftBoundary || position.x > mRightBoundary ||
-        position.y < mTopBoundary  || position.y > mBottomBoundary)
-        return false;
-
-    int tileXIndex = floor((position.x - mLeftBoundary) / mTileSize);
-    int tileYIndex = floor((position.y - mTopBoundary) / mTileSize);
+    int tileXIndex = columnAt(position.x);
+    int tileYIndex = rowAt(position.y);
 
-    if (tileXIndex < 0 || tileXIndex >= mMapColumns ||
-        tileYIndex < 0 || tileYIndex >= mMapRows)
+    if (tileXIndex < 0 || tileYIndex < 0 || !isSolidTile(tileXIndex, tileYIndex))
         return false;
 
-    int tile = mLevelData[tileYIndex * mMapColumns + tileXIndex];
-    if (tile == 0 || tile == 30) return false;
-
     float tileCentreX = mLeftBoundary + tileXIndex * mTileSize + mTileSize / 2.0f;
     float tileCentreY = mTopBoundary + tileYIndex * mTileSize + mTileSize / 2.0f;
 
@@ -103,3 +514,247 @@ bool Map::isSolidTileAt(Vector2 position, float *xOverlap, float *yOverlap)
 
     return true;
 }
+
+int Map::columnAt(float x) const
+{
+    if (x < mLeftBoundary || x > mRightBoundary) return -1;
+
+    int column = floor((x - mLeftBoundary) / mTileSize);
+    return column >= 0 && column < mMapColumns ? column : -1;
+}
+
+int Map::rowAt(float y) const
+{
+    if (y < mTopBoundary || y > mBottomBoundary) return -1;
+
+    int row = floor((y - mTopBoundary) / mTileSize);
+    return row >= 0 && row < mMapRows ? row : -1;
+}
+
+bool Map::isSolidTile(int column, int row) const
+{
+    if (column < 0 || column >= mMapColumns || row < 0 || row >= mMapRows) return false;
+
+    // both are non-negative here, so unsigned division is a plain shift
+    unsigned int chunkIndex = (unsigned int) row / CHUNK_TILES * mChunkColumns +
+                              (unsigned int) column / CHUNK_TILES;
+    int block = mLevelData != nullptr ? (int) chunkIndex : mChunks[chunkIndex].slot;
+    if (block < 0) return (flagsOf(mFile.readTile(column, row)) & TILE_SOLID) != 0;
+
+    unsigned int mask = mSolidRows[block * CHUNK_TILES + (unsigned int) row % CHUNK_TILES];
+    return (mask >> ((unsigned int) column % CHUNK_TILES)) & 1u;
+}
+
+Map::BoxContacts Map::probeBox(Vector2 centre, Vector2 size, int edges) const
+{
+    BoxContacts contacts = {};
+    float halfWidth  = size.x / 2.0f;
+    float halfHeight = size.y / 2.0f;
+
+    // the same overlap isSolidTileAt reports for a probe in a solid tile
+    auto contactAt = [this](Vector2 probe, int column, int row) {
+        float tileCentreX = mLeftBoundary + column * mTileSize + mTileSize / 2.0f;
+        float tileCentreY = mTopBoundary + row * mTileSize + mTileSize / 2.0f;
+
+        TileContact contact;
+        contact.solid    = true;
+        contact.xOverlap = fmaxf(0.0f, (mTileSize / 2.0f) - fabs(probe.x - tileCentreX));
+        contact.yOverlap = fmaxf(0.0f, (mTileSize / 2.0f) - fabs(probe.y - tileCentreY));
+        return contact;
+    };
+
+    if (edges & (EDGE_TOP | EDGE_BOTTOM))
+    {
+        // centre, then left and right corner; both edges share the columns
+        float probeX[3] = { centre.x, centre.x - halfWidth, centre.x + halfWidth };
+        int   columns[3];
+        for (int i = 0; i < 3; i++) columns[i] = columnAt(probeX[i]);
+
+        for (int edge = EDGE_TOP; edge <= EDGE_BOTTOM; edge <<= 1)
+        {
+            if (!(edges & edge)) continue;
+
+            float probeY = edge == EDGE_TOP ? centre.y - halfHeight : centre.y + halfHeight;
+            int row = rowAt(probeY);
+            if (row < 0) continue;
+
+            for (int i = 0; i < 3; i++)
+            {
+                if (columns[i] < 0 || !isSolidTile(columns[i], row)) continue;
+                (edge == EDGE_TOP ? contacts.top : contacts.bottom) =
+                    contactAt({ probeX[i], probeY }, columns[i], row);
+                break;
+            }
+        }
+    }
+
+    for (int edge = EDGE_LEFT; edge <= EDGE_RIGHT; edge <<= 1)
+    {
+        if (!(edges & edge)) continue;
+
+        Vector2 probe = { edge == EDGE_LEFT ? centre.x - halfWidth : centre.x + halfWidth,
+                          centre.y };
+        int column = columnAt(probe.x);
+        int row    = rowAt(probe.y);
+        if (column < 0 || row < 0 || !isSolidTile(column, row)) continue;
+
+        (edge == EDGE_LEFT ? contacts.left : contacts.right) = contactAt(probe, column, row);
+    }
+
+    return contacts;
+}
+
+template <typename Visit>
+void Map::walkTiles(Vector2 from, Vector2 delta, int margin, Visit visit) const
+{
+    if (mMapColumns == 0 || mMapRows == 0) return;
+
+    // only the part of the segment over the map (and the margin around it)
+    int firstColumn = -margin, lastColumn = mMapColumns - 1 + margin;
+    int firstRow    = -margin, lastRow    = mMapRows    - 1 + margin;
+    Rectangle bounds = {
+        mLeftBoundary + firstColumn * mTileSize, mTopBoundary + firstRow * mTileSize,
+        (lastColumn - firstColumn + 1) * mTileSize, (lastRow - firstRow + 1) * mTileSize
+    };
+
+    float entry = 0.0f, exit = 1.0f;
+    if (delta.x == 0.0f && delta.y == 0.0f)
+    {
+        if (!CheckCollisionPointRec(from, bounds)) return;
+    }
+    else if (!intersectSegmentBox(from, delta, bounds, &entry, &exit)) return;
+
+    float fraction = fmaxf(entry, 0.0f);
+    float end      = fminf(exit, 1.0f);
+
+    Vector2 normal = { 0.0f, 0.0f };
+    if (entry > 0.0f)
+    {
+        // came in through the edge; the later slab is the one crossed
+        float throughX = delta.x == 0.0f ? -INFINITY :
+            ((delta.x > 0.0f ? bounds.x : bounds.x + bounds.width) - from.x) / delta.x;
+        float throughY = delta.y == 0.0f ? -INFINITY :
+            ((delta.y > 0.0f ? bounds.y : bounds.y + bounds.height) - from.y) / delta.y;
+        if (throughX >= throughY) normal = { delta.x > 0.0f ? -1.0f : 1.0f, 0.0f };
+        else                      normal = { 0.0f, delta.y > 0.0f ? -1.0f : 1.0f };
+    }
+
+    int column = (int) floorf((from.x + delta.x * fraction - mLeftBoundary) / mTileSize);
+    int row    = (int) floorf((from.y + delta.y * fraction - mTopBoundary)  / mTileSize);
+    column = std::min(std::max(column, firstColumn), lastColumn);
+    row    = std::min(std::max(row, firstRow), lastRow);
+
+    int stepX = delta.x > 0.0f ? 1 : (delta.x < 0.0f ? -1 : 0);
+    int stepY = delta.y > 0.0f ? 1 : (delta.y < 0.0f ? -1 : 0);
+
+    // fraction at which the segment crosses the next column/row boundary;
+    // worked out from the boundary each time rather than accumulated, so
+    // long rays do not drift off the grid near corners
+    auto crossing = [&](int step, int index, float origin, float start, float span) {
+        return step == 0 ? INFINITY
+            : (origin + (index + (step > 0 ? 1 : 0)) * mTileSize - start) / span;
+    };
+    float nextX = crossing(stepX, column, mLeftBoundary, from.x, delta.x);
+    float nextY = crossing(stepY, row,    mTopBoundary,  from.y, delta.y);
+
+    while (visit(column, row, fraction, normal))
+    {
+        if (nextX < nextY)
+        {
+            fraction = nextX;
+            column  += stepX;
+            nextX    = crossing(stepX, column, mLeftBoundary, from.x, delta.x);
+            normal   = { (float) -stepX, 0.0f };
+        }
+        else
+        {
+            fraction = nextY;
+            row     += stepY;
+            nextY    = crossing(stepY, row, mTopBoundary, from.y, delta.y);
+            normal   = { 0.0f, (float) -stepY };
+        }
+
+        if (fraction > end || column < firstColumn || column > lastColumn ||
+            row < firstRow || row > lastRow)
+            return;
+    }
+}
+
+bool Map::raycast(Vector2 from, Vector2 to, RayHit *hit) const
+{
+    Vector2 delta = { to.x - from.x, to.y - from.y };
+    bool found = false;
+
+    walkTiles(from, delta, 0, [&](int column, int row, float fraction, Vector2 normal) {
+        if (!isSolidTile(column, row)) return true;
+
+        hit->fraction = fraction;
+        hit->point    = { from.x + delta.x * fraction, from.y + delta.y * fraction };
+        hit->normal   = normal;
+        hit->column   = column;
+        hit->row      = row;
+        found = true;
+        return false;
+    });
+
+    return found;
+}
+
+bool Map::sweepBox(Vector2 centre, Vector2 size, Vector2 displacement,
+    RayHit *hit) const
+{
+    float halfWidth  = size.x / 2.0f;
+    float halfHeight = size.y / 2.0f;
+
+    // tiles a box centred anywhere in a tile can reach on either side
+    int reachX = (int) ceilf(halfWidth  / mTileSize);
+    int reachY = (int) ceilf(halfHeight / mTileSize);
+
+    float best = INFINITY;
+
+    // walk the centre's path and test the tiles the box can touch from each
+    // tile on it. A tile the box enters at some fraction is within reach of
+    // the tile the centre is in at that moment, which is visited no later,
+    // so once the walk is past the best hit nothing earlier can turn up. The
+    // walk extends past the map by the reach, where the box still can.
+    walkTiles(centre, displacement, std::max(reachX, reachY), [&](int column, int row, float fraction, Vector2) {
+        if (fraction > best) return false;
+
+        for (int r = row - reachY; r <= row + reachY; r++)
+        {
+            for (int c = column - reachX; c <= column + reachX; c++)
+            {
+                if (!isSolidTile(c, r)) continue;
+
+                // the box hits the tile when its centre hits the tile grown
+                // by half the box
+                Rectangle grown = {
+                    mLeftBoundary + c * mTileSize - halfWidth,
+                    mTopBoundary  + r * mTileSize - halfHeight,
+                    mTileSize + size.x, mTileSize + size.y
+                };
+                float entry, exit;
+                if (!intersectSegmentBox(centre, displacement, grown, &entry, &exit) ||
+                    entry < 0.0f || entry >= best)
+                    continue;
+
+                float throughX = displacement.x == 0.0f ? -INFINITY :
+                    ((displacement.x > 0.0f ? grown.x : grown.x + grown.width) - centre.x) / displacement.x;
+                float throughY = displacement.y == 0.0f ? -INFINITY :
+                    ((displacement.y > 0.0f ? grown.y : grown.y + grown.height) - centre.y) / displacement.y;
+
+                best = entry;
+                hit->fraction = entry;
+                hit->point    = { centre.x + displacement.x * entry, centre.y + displacement.y * entry };
+                hit->normal   = throughX >= throughY
+                    ? Vector2 { displacement.x > 0.0f ? -1.0f : 1.0f, 0.0f }
+                    : Vector2 { 0.0f, displacement.y > 0.0f ? -1.0f : 1.0f };
+                hit->column   = c;
+                hit->row      = r;
+            }
+        }
+        return true;
+    });
+
+    return best <= 1.0f;
+}
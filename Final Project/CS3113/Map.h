@@ -1,23 +1,57 @@
 #include "cs3113.h"
+#include "MapFile.h"
 
 #ifndef MAP_H
 #define MAP_H
 
+/**
+ * Tile grid plus its pre-rendered image. The tiles are baked once into
+ * render textures of up to CHUNK_TILES x CHUNK_TILES tiles each, so drawing
+ * the map is one quad per chunk; `setTile()` marks only its own chunk for
+ * re-baking. Live per-tile drawing remains available for debugging, and is
+ * what any chunk that has not been baked yet falls back to.
+ *
+ * A map can also be streamed from a chunked map file (see MapFile) instead of
+ * a level array. Then only the chunks around the camera are resident: each
+ * `stream()` pages in the chunks under the visible area (plus a margin) and,
+ * once `setResidentChunkLimit()` chunks are in, pages the least recently seen
+ * ones back out, tile copy and baked texture alike. Tiles of chunks that are
+ * not resident are read straight from the mapped file, so `isSolidTileAt()`
+ * and `render()` behave the same anywhere on the map.
+ *
+ * Collision never looks at tile indices directly. `build()` reads the
+ * tileset's property table (the texture path with a ".tiles" extension) and
+ * keeps one solidity bit per tile, a 32-bit row mask per chunk row, which is
+ * what `isSolidTileAt()` and `probeBox()` test.
+ */
 class Map
 {
 private:
+    struct Chunk
+    {
+        RenderTexture2D target; // id 0 until baked (or if it has no tiles)
+        int  firstColumn, firstRow;
+        int  columns, rows;
+        bool dirty;
+        bool empty;             // known to have no tiles: nothing to draw
+
+        // streamed maps only
+        int          slot;      // resident tile copy, -1 while paged out
+        bool         pinned;    // edited by setTile(), so never paged out
+        unsigned int lastSeen;  // stream() call that last had it in range
+    };
+
     int mMapColumns; // number of columns in map
     int mMapRows;    // number of rows in map
 
-    unsigned int *mLevelData; // array of tile indices
-    Texture2D mTextureAtlas;  // texture atlas
+    unsigned int *mLevelData; // array of tile indices (nullptr if streamed)
+    int mSheet; // SpriteAtlas sheet of the tileset, one frame per tile
 
     float mTileSize; // size of each tile in pixels
 
     int mTextureColumns; // number of columns in texture atlas
     int mTextureRows;    // number of rows in texture atlas
 
-    std::vector<Rectangle> mTextureAreas; // texture areas for each tile
     Vector2 mOrigin; // center of the map in world coordinates
 
     float mLeftBoundary;  // left boundary of the map in world coordinates
@@ -25,21 +59,152 @@ private:
     float mTopBoundary;   // top boundary of the map in world coordinates
     float mBottomBoundary;// bottom boundary of the map in world coordinates
 
+    std::vector<Chunk> mChunks; // row-major, mChunkColumns per row
+    int mChunkColumns = 0;
+    int mChunkRows    = 0;
+
+    // what the last render() drew and skipped: chunks, or tiles when live
+    int mDrawnCount  = 0;
+    int mCulledCount = 0;
+
+    std::vector<unsigned char> mTileFlags;   // TileFlag bits per tile index
+    // solidity, one CHUNK_TILES-bit mask per tile row of a chunk: indexed by
+    // chunk for level arrays, by resident slot for streamed maps
+    std::vector<unsigned int> mSolidRows;
+
+    MapFile mFile;                            // open only for streamed maps
+    std::vector<unsigned int> mResidentTiles; // CHUNK_TILES^2 tiles per slot
+    std::vector<int> mSlotChunks;             // chunk held by each slot, -1 if free
+    int mResidentLimit = 24;
+    unsigned int mStreamCount = 0;
+    int mPageIns  = 0;
+    int mPageOuts = 0;
+
+    unsigned int tileAt(int column, int row) const;
+    unsigned char flagsOf(unsigned int tile) const;
+    void loadTileProperties(const char *textureFilePath);
+    void buildSolidRows(int chunkIndex);
+    // tile under a coordinate, or -1 outside the map
+    int columnAt(float x) const;
+    int rowAt(float y) const;
+    // Calls visit(column, row, fraction, normal) for every tile the segment
+    // crosses, in order, until it returns false; `margin` tiles beyond the
+    // map's edge are walked too
+    template <typename Visit>
+    void walkTiles(Vector2 from, Vector2 delta, int margin, Visit visit) const;
+    int  acquireSlot(bool force);
+    void pageIn(int chunkIndex, bool force);
+    void pageOut(int chunkIndex);
+
+    void buildChunks();
+    void bakeChunk(Chunk &chunk);
+    void renderTiles(int firstColumn, int firstRow, int columns, int rows);
+
 public:
+    enum TileFlag
+    {
+        TILE_SOLID = 1 << 0 // blocks movement
+    };
+
+    // Edges of a box for probeBox()
+    enum BoxEdge
+    {
+        EDGE_TOP    = 1 << 0,
+        EDGE_BOTTOM = 1 << 1,
+        EDGE_LEFT   = 1 << 2,
+        EDGE_RIGHT  = 1 << 3
+    };
+
+    // What isSolidTileAt() would report for one of the probes on an edge
+    struct TileContact
+    {
+        bool  solid;
+        float xOverlap;
+        float yOverlap;
+    };
+
+    struct BoxContacts
+    {
+        TileContact top, bottom, left, right;
+    };
+
+    // First solid tile along a ray or sweep
+    struct RayHit
+    {
+        float   fraction; // of the way along, 0..1
+        Vector2 point;    // where the ray (or the swept box's centre) stops
+        Vector2 normal;   // of the tile face that was hit; zero if it started inside
+        int     column, row;
+    };
+
+    static constexpr int CHUNK_TILES = MapFile::CHUNK_TILES;
+    // tiles beyond the visible area that stream() keeps resident
+    static constexpr int STREAM_MARGIN_TILES = 8;
+
     Map(int mapColumns, int mapRows, unsigned int *levelData,
         const char *textureFilePath, float tileSize, int textureColumns,
         int textureRows, Vector2 origin);
+    // Streamed map; the size comes from the file. A file that fails to open
+    // leaves an empty 0 x 0 map.
+    Map(const char *mapFilePath, const char *textureFilePath, float tileSize,
+        int textureColumns, int textureRows, Vector2 origin);
     ~Map();
 
     void build();
     void render();
+    // Draws only the tiles/chunks overlapping the world-space area
+    void render(Rectangle visibleArea);
     bool isSolidTileAt(Vector2 position, float *xOverlap, float *yOverlap);
+    bool isSolidTile(int column, int row) const;
+    // The edge probes Entity uses against the map, for a box of `size`
+    // centred on `centre`, in one call: top and bottom test their centre and
+    // both corners (first solid one wins), left and right their midpoint.
+    // Edges not asked for come back not solid.
+    BoxContacts probeBox(Vector2 centre, Vector2 size, int edges) const;
+    // Walks the tiles under the segment from `from` to `to` (DDA, one tile
+    // per step however long the segment) and reports the first solid one.
+    bool raycast(Vector2 from, Vector2 to, RayHit *hit) const;
+    // Moves a box of `size` centred on `centre` by `displacement` and
+    // reports the first solid tile it would run into, so a fast mover
+    // stops at the wall instead of stepping past it. Tiles the box already
+    // overlaps at the start, or only slides along, do not stop it.
+    bool sweepBox(Vector2 centre, Vector2 size, Vector2 displacement,
+        RayHit *hit) const;
+    // Replaces the property table entry of one tile index
+    void setTileFlags(unsigned int tile, unsigned char flags);
+
+    // Pages chunks in and out around the world-space area; a no-op unless
+    // the map is streamed. Runs before bakeDirtyChunks() each frame.
+    void stream(Rectangle visibleArea);
+    // Most chunks kept resident at once (tile copies and baked textures).
+    // Chunks in view beyond it are drawn tile by tile from the file.
+    void setResidentChunkLimit(int chunks);
+
+    // Changes one tile and schedules its chunk for re-baking
+    void setTile(int column, int row, unsigned int tile);
+    // Re-bakes every dirty chunk. Needs a GL context and must run outside
+    // BeginMode2D/BeginTextureMode (main calls it before the world pass).
+    void bakeDirtyChunks();
+
+    // Debug switch shared by every map: draw tile by tile instead of chunks
+    static void setLiveRendering(bool live);
+    static bool isLiveRendering();
+
+    int    getChunkCount()      const { return (int) mChunks.size(); }
+    int    getDrawnCount()      const { return mDrawnCount;  }
+    int    getCulledCount()     const { return mCulledCount; }
+    size_t getBakedBytes()      const;
+    bool   isStreamed()         const { return mFile.isOpen(); }
+    int    getResidentChunks()  const;
+    size_t getResidentBytes()   const; // resident tile copies plus baked chunks
+    int    getPageIns()         const { return mPageIns;  }
+    int    getPageOuts()        const { return mPageOuts; }
 
     int           getMapColumns()     const { return mMapColumns;     };
     int           getMapRows()        const { return mMapRows;        };
     float         getTileSize()       const { return mTileSize;       };
     unsigned int* getLevelData()      const { return mLevelData;      };
-    Texture2D     getTextureAtlas()   const { return mTextureAtlas;   };
+    int           getSheet()          const { return mSheet;          };
     int           getTextureColumns() const { return mTextureColumns; };
     int           getTextureRows()    const { return mTextureRows;    };
     float         getLeftBoundary()   const { return mLeftBoundary;   };
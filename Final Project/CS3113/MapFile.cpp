@@ -0,0 +1,175 @@
+#include "MapFile.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const char         MAGIC[4]    = { 'C', 'M', 'A', 'P' };
+static const unsigned int VERSION     = 1;
+static const int          HEADER_INTS = 8;
+static const int          INDEX_INTS  = 2;
+static const size_t       DATA_ALIGN  = 4096;
+
+// The format is little-endian and so is every platform this game builds for
+// (x86 and ARM), so words are read and written as-is.
+
+bool MapFile::write(const char *filePath, int columns, int rows,
+    const std::function<unsigned int(int column, int row)> &tileAt)
+{
+    if (columns <= 0 || rows <= 0) return false;
+
+    unsigned int chunkColumns = (columns + CHUNK_TILES - 1) / CHUNK_TILES;
+    unsigned int chunkRows    = (rows    + CHUNK_TILES - 1) / CHUNK_TILES;
+    size_t chunkCount = (size_t) chunkColumns * chunkRows;
+
+    FILE *file = fopen(filePath, "wb");
+    if (file == nullptr) return false;
+
+    unsigned int header[HEADER_INTS];
+    memcpy(&header[0], MAGIC, 4);
+    header[1] = VERSION;
+    header[2] = (unsigned int) columns;
+    header[3] = (unsigned int) rows;
+    header[4] = CHUNK_TILES;
+    header[5] = chunkColumns;
+    header[6] = chunkRows;
+    header[7] = 0;
+
+    std::vector<unsigned int> index(chunkCount * INDEX_INTS, 0);
+    size_t headerBytes = sizeof(header) + index.size() * sizeof(unsigned int);
+    size_t offset = (headerBytes + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+
+    // the index is only known once every chunk has been looked at, so the
+    // payloads go first and the header and index are filled in at the end
+    bool ok = fseek(file, (long) offset, SEEK_SET) == 0;
+    unsigned short tiles[CHUNK_TILES * CHUNK_TILES];
+
+    for (size_t chunk = 0; chunk < chunkCount && ok; chunk++)
+    {
+        int firstColumn = (int) (chunk % chunkColumns) * CHUNK_TILES;
+        int firstRow    = (int) (chunk / chunkColumns) * CHUNK_TILES;
+        bool hasTiles = false;
+
+        memset(tiles, 0, sizeof(tiles));
+        for (int row = 0; row < CHUNK_TILES && firstRow + row < rows; row++)
+        {
+            for (int col = 0; col < CHUNK_TILES && firstColumn + col < columns; col++)
+            {
+                unsigned int tile = tileAt(firstColumn + col, firstRow + row);
+                if (tile > 0xFFFF) { ok = false; break; }
+                tiles[row * CHUNK_TILES + col] = (unsigned short) tile;
+                if (tile != 0) hasTiles = true;
+            }
+        }
+        if (!ok || !hasTiles) continue;
+
+        if (offset > 0xFFFFFFFFu - CHUNK_BYTES) { ok = false; break; }
+        index[chunk * INDEX_INTS] = (unsigned int) offset;
+        ok = fwrite(tiles, sizeof(tiles), 1, file) == 1;
+        offset += CHUNK_BYTES;
+    }
+
+    if (ok) ok = fseek(file, 0, SEEK_SET) == 0 &&
+                 fwrite(header, sizeof(header), 1, file) == 1 &&
+                 fwrite(index.data(), sizeof(unsigned int), index.size(), file) == index.size();
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) remove(filePath);
+    return ok;
+}
+
+bool MapFile::write(const char *filePath, int columns, int rows,
+    const unsigned int *levelData)
+{
+    return write(filePath, columns, rows, [levelData, columns](int column, int row) {
+        return levelData[row * columns + column];
+    });
+}
+
+MapFile::~MapFile() { close(); }
+
+bool MapFile::open(const char *filePath)
+{
+    close();
+
+    if (!mMapping.open(filePath)) return false;
+    const unsigned char *data = mMapping.getData();
+    size_t size = mMapping.getSize();
+
+    const unsigned int *header = (const unsigned int *) data;
+    size_t chunkCount = 0;
+    bool valid = size >= HEADER_INTS * sizeof(unsigned int) &&
+                 memcmp(data, MAGIC, 4) == 0 && header[1] == VERSION &&
+                 header[4] == CHUNK_TILES && header[2] > 0 && header[3] > 0 &&
+                 header[5] == (header[2] + CHUNK_TILES - 1) / CHUNK_TILES &&
+                 header[6] == (header[3] + CHUNK_TILES - 1) / CHUNK_TILES;
+
+    if (valid)
+    {
+        chunkCount = (size_t) header[5] * header[6];
+        valid = size >= (HEADER_INTS + chunkCount * INDEX_INTS) * sizeof(unsigned int);
+    }
+
+    // every payload must lie inside the file, so reads never fault
+    const unsigned int *index = header + HEADER_INTS;
+    for (size_t chunk = 0; chunk < chunkCount && valid; chunk++)
+    {
+        size_t offset = index[chunk * INDEX_INTS];
+        if (offset != 0 && (offset % DATA_ALIGN % CHUNK_BYTES != 0 ||
+                            offset + CHUNK_BYTES > size)) valid = false;
+    }
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    mIndex        = index;
+    mColumns      = (int) header[2];
+    mRows         = (int) header[3];
+    mChunkColumns = (int) header[5];
+    mChunkRows    = (int) header[6];
+    return true;
+}
+
+void MapFile::close()
+{
+    mMapping.close();
+    mIndex = nullptr;
+    mColumns = mRows = mChunkColumns = mChunkRows = 0;
+}
+
+const unsigned short *MapFile::chunkTiles(int chunkIndex) const
+{
+    unsigned int offset = mIndex[chunkIndex * INDEX_INTS];
+    return offset == 0 ? nullptr : (const unsigned short *) (mMapping.getData() + offset);
+}
+
+bool MapFile::isChunkEmpty(int chunkIndex) const
+{
+    return chunkTiles(chunkIndex) == nullptr;
+}
+
+void MapFile::readChunk(int chunkIndex, unsigned int *tiles) const
+{
+    const unsigned short *source = chunkTiles(chunkIndex);
+    for (int i = 0; i < CHUNK_TILES * CHUNK_TILES; i++)
+        tiles[i] = source == nullptr ? 0 : source[i];
+}
+
+unsigned int MapFile::readTile(int column, int row) const
+{
+    if (column < 0 || column >= mColumns || row < 0 || row >= mRows) return 0;
+
+    const unsigned short *source = chunkTiles(
+        (row / CHUNK_TILES) * mChunkColumns + column / CHUNK_TILES);
+    if (source == nullptr) return 0;
+
+    return source[(row % CHUNK_TILES) * CHUNK_TILES + column % CHUNK_TILES];
+}
+
+void MapFile::releaseChunk(int chunkIndex) const
+{
+    unsigned int offset = mIndex[chunkIndex * INDEX_INTS];
+    if (offset != 0) mMapping.release(offset, CHUNK_BYTES);
+}
@@ -0,0 +1,80 @@
+#include "MappedFile.h"
+#include <cstddef>
+#include <functional>
+
+#ifndef MAP_FILE_H
+#define MAP_FILE_H
+
+/**
+ * Read-only view of a chunked binary map (".cmap") that is memory-mapped
+ * rather than read, so opening a world of thousands by thousands of tiles
+ * costs nothing until a chunk is actually touched, and the OS is free to drop
+ * pages again once they have been copied out.
+ *
+ * Layout (all integers little-endian):
+ *
+ *     header   "CMAP", version, columns, rows, chunk tiles,
+ *              chunk columns, chunk rows, reserved      (8 x uint32)
+ *     index    one entry per chunk, row-major           (uint32 offset,
+ *              0 for a chunk with no tiles)              uint32 reserved)
+ *     chunks   CHUNK_TILES x CHUNK_TILES uint16 tiles, row-major with a
+ *              full CHUNK_TILES stride even for edge chunks
+ *
+ * Chunk payloads start on a page boundary and are 2 KB each, so no chunk
+ * straddles two pages.
+ *
+ * This class only knows the file; Map::Map(const char *mapFilePath, ...)
+ * decides which chunks to keep resident.
+ */
+class MapFile
+{
+private:
+    MappedFile          mMapping;         // whole file, read-only
+    const unsigned int *mIndex = nullptr; // two uint32 per chunk
+
+    int mColumns      = 0;
+    int mRows         = 0;
+    int mChunkColumns = 0;
+    int mChunkRows    = 0;
+
+    const unsigned short *chunkTiles(int chunkIndex) const;
+
+public:
+    static constexpr int CHUNK_TILES = 32;
+    static constexpr int CHUNK_BYTES = CHUNK_TILES * CHUNK_TILES * 2;
+
+    // Writes a map whose tile at (column, row) is `tileAt(column, row)`; the
+    // source is walked one chunk at a time, so the whole grid never has to
+    // exist in memory. Fails on I/O errors or tiles above 65535.
+    static bool write(const char *filePath, int columns, int rows,
+        const std::function<unsigned int(int column, int row)> &tileAt);
+    // Same, from a row-major array such as a level's mLevelData
+    static bool write(const char *filePath, int columns, int rows,
+        const unsigned int *levelData);
+
+    MapFile() = default;
+    ~MapFile();
+    MapFile(const MapFile &) = delete;
+    MapFile &operator=(const MapFile &) = delete;
+
+    // Maps the file and validates its header and index
+    bool open(const char *filePath);
+    void close();
+    bool isOpen() const { return mMapping.isOpen(); }
+
+    bool isChunkEmpty(int chunkIndex) const;
+    // Copies a chunk's tiles into `tiles` (CHUNK_TILES x CHUNK_TILES,
+    // row-major); an empty chunk comes out all zero
+    void readChunk(int chunkIndex, unsigned int *tiles) const;
+    unsigned int readTile(int column, int row) const;
+    // Tells the OS the chunk's pages are not needed any more
+    void releaseChunk(int chunkIndex) const;
+
+    int    getColumns()      const { return mColumns;           }
+    int    getRows()         const { return mRows;              }
+    int    getChunkColumns() const { return mChunkColumns;      }
+    int    getChunkRows()    const { return mChunkRows;         }
+    size_t getFileBytes()    const { return mMapping.getSize(); }
+};
+
+#endif // MAP_FILE_H
@@ -0,0 +1,89 @@
+#include "MappedFile.h"
+
+// no raylib in this file: windows.h and raylib.h do not mix
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOGDI
+    #define NOUSER
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const char *filePath)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) return false;
+
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) { CloseHandle(mapping); return false; }
+
+    mMappingHandle = mapping;
+    mData = (const unsigned char *) data;
+    mSize = (size_t) size.QuadPart;
+#else
+    int file = ::open(filePath, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat status;
+    void *data = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+        data = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file); // the mapping keeps its own reference
+    if (data == MAP_FAILED) return false;
+
+    mData = (const unsigned char *) data;
+    mSize = (size_t) status.st_size;
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mData != nullptr)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(mData);
+        CloseHandle((HANDLE) mMappingHandle);
+#else
+        munmap((void *) mData, mSize);
+#endif
+    }
+
+    mData = nullptr;
+    mSize = 0;
+    mMappingHandle = nullptr;
+}
+
+void MappedFile::release(size_t offset, size_t bytes) const
+{
+#if !defined(_WIN32)
+    if (mData == nullptr || offset >= mSize) return;
+
+    // madvise wants whole pages; a neighbour sharing the page just faults
+    // back in from the page cache if it is read again
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    size_t first = offset / pageSize * pageSize;
+    madvise((void *) (mData + first), offset + bytes - first, MADV_DONTNEED);
+#else
+    (void) offset;
+    (void) bytes;
+#endif
+}
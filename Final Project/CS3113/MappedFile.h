@@ -0,0 +1,40 @@
+#include <cstddef>
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/**
+ * A whole file mapped read-only into memory: the one place that knows how
+ * each platform maps and unmaps files. MapFile and AssetPack keep one of
+ * these and read their format straight out of `getData()`.
+ *
+ * Reads go through the OS page cache, so pages are only touched (and only
+ * count against the process) when something reads them.
+ */
+class MappedFile
+{
+private:
+    const unsigned char *mData = nullptr;
+    size_t               mSize = 0;
+    void                *mMappingHandle = nullptr; // Windows only
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Maps the file; false if it is missing, empty or cannot be mapped
+    bool open(const char *filePath);
+    void close();
+    bool isOpen() const { return mData != nullptr; }
+
+    // Tells the OS the bytes are not needed any more (whole pages around
+    // them, which fault back in from the page cache if read again)
+    void release(size_t offset, size_t bytes) const;
+
+    const unsigned char *getData() const { return mData; }
+    size_t               getSize() const { return mSize; }
+};
+
+#endif // MAPPED_FILE_H
@@ -14,7 +14,7 @@ void MenuScene::initialise()
 void MenuScene::update(float deltaTime)
 {
     // Press Enter to start - goes to Level A Title (or Level A directly)
-    if (IsKeyPressed(KEY_ENTER))
+    if (Input::isKeyPressed(KEY_ENTER))
     {
         mGameState.nextSceneID = 3; // Go to Level A Title (or change to 0 for Level A directly)
     }
@@ -0,0 +1,369 @@
+#include "MusicPlayer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// A decoded track: interleaved 16-bit frames at SAMPLE_RATE, or none if the
+// file could not be decoded (it then plays as silence)
+struct MusicTrack
+{
+    std::string path;
+    Wave wave;
+    int  lastUsed;
+};
+
+// A track being mixed: `fade` runs between 0 and 1 by `fadeStep` per frame
+// (negative while fading out) and scales `volume`
+struct MusicDeck
+{
+    MusicTrack  *track;
+    unsigned int position; // next frame, wrapping to loop
+    float volume;
+    float fade;
+    float fadeStep;
+};
+
+struct MusicCommand
+{
+    std::string path; // empty to fade out
+    float volume;
+    float fadeSeconds;
+};
+
+static const int          MIX_FRAMES         = 512; // mixed per pass
+static const int          MAX_DECODED_TRACKS = 3;
+static const unsigned int RING_MASK          = MusicPlayer::RING_FRAMES - 1;
+
+// Single producer (the music thread) and single consumer (raylib's audio
+// thread); the frame counters only grow and wrap together
+static float gRing[MusicPlayer::RING_FRAMES * MusicPlayer::CHANNELS];
+static std::atomic<unsigned int> gWriteFrame(0);
+static std::atomic<unsigned int> gReadFrame(0);
+static std::atomic<int>          gUnderrunCount(0);
+static std::atomic<int>          gDecodedTrackCount(0);
+
+// Guards the commands and what the main thread last asked for
+static std::mutex              gMutex;
+static std::condition_variable gCommandQueued;
+static std::deque<MusicCommand> gCommands;
+static std::string gTrack;
+static float       gVolume   = 0.0f;
+static bool        gStopping = false;
+
+// Main thread only
+static AudioStream gStream;
+static std::thread gMusicThread;
+static bool        gRunning = false;
+
+// Music thread only (and `stop`, once it is joined)
+static std::vector<MusicTrack*> gTracks;
+static std::vector<MusicDeck>   gDecks;
+static MusicCommand gWanted;          // a play waiting for its track to decode
+static bool         gHasWanted = false;
+static MusicTrack  *gDecoding  = nullptr;
+static std::thread  gDecoder;
+static std::atomic<bool> gDecoded(false);
+static int gUseCount = 0;
+
+// raylib's audio thread: hands over what is mixed, silence for the rest
+static void drainRing(void *buffer, unsigned int frames)
+{
+    float *out = (float *) buffer;
+    unsigned int read  = gReadFrame.load(std::memory_order_relaxed);
+    unsigned int ready = gWriteFrame.load(std::memory_order_acquire) - read;
+    unsigned int count = frames < ready ? frames : ready;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const float *frame = gRing + ((read + i) & RING_MASK) * MusicPlayer::CHANNELS;
+        for (int channel = 0; channel < MusicPlayer::CHANNELS; channel++)
+            out[i * MusicPlayer::CHANNELS + channel] = frame[channel];
+    }
+    gReadFrame.store(read + count, std::memory_order_release);
+
+    if (count < frames)
+    {
+        memset(out + count * MusicPlayer::CHANNELS, 0,
+               (frames - count) * MusicPlayer::CHANNELS * sizeof(float));
+        gUnderrunCount++;
+    }
+}
+
+static float fadeStep(float seconds)
+{
+    return seconds > 0.0f ? 1.0f / (seconds * MusicPlayer::SAMPLE_RATE) : 1.0f;
+}
+
+static void fadeOutDecks(float seconds)
+{
+    for (MusicDeck &deck : gDecks) deck.fadeStep = -fadeStep(seconds);
+}
+
+static MusicTrack *findTrack(const std::string &path)
+{
+    for (MusicTrack *track : gTracks)
+        if (track->path == path) return track;
+
+    return nullptr;
+}
+
+static void crossfadeTo(const MusicCommand &command, MusicTrack *track)
+{
+    track->lastUsed = ++gUseCount;
+
+    // already the one playing (or fading in): only the volume changes
+    if (!gDecks.empty() && gDecks.back().track == track && gDecks.back().fadeStep >= 0.0f)
+    {
+        gDecks.back().volume = command.volume;
+        return;
+    }
+
+    fadeOutDecks(command.fadeSeconds);
+    if (track->wave.frameCount == 0) return;
+
+    MusicDeck deck = { track, 0, command.volume, 0.0f, fadeStep(command.fadeSeconds) };
+    gDecks.push_back(deck);
+}
+
+static void startDecoding(const std::string &path)
+{
+    gDecoding = new MusicTrack { path, { 0 }, 0 };
+    gDecoded.store(false);
+
+    MusicTrack *track = gDecoding;
+    gDecoder = std::thread([track]
+    {
+        track->wave = loadWave(track->path.c_str());
+        if (track->wave.frameCount > 0)
+            WaveFormat(&track->wave, MusicPlayer::SAMPLE_RATE, 16, MusicPlayer::CHANNELS);
+        gDecoded.store(true, std::memory_order_release);
+    });
+}
+
+// Keeps the decoded track and drops the least recently played ones past the
+// limit, never one that is still being mixed
+static void finishDecoding()
+{
+    gDecoder.join();
+    gTracks.push_back(gDecoding);
+    gDecoding = nullptr;
+
+    while ((int) gTracks.size() > MAX_DECODED_TRACKS)
+    {
+        int oldest = -1;
+        for (int i = 0; i < (int) gTracks.size(); i++)
+        {
+            bool mixing = false;
+            for (const MusicDeck &deck : gDecks) mixing = mixing || deck.track == gTracks[i];
+            if (mixing || (gHasWanted && gTracks[i]->path == gWanted.path)) continue;
+
+            if (oldest < 0 || gTracks[i]->lastUsed < gTracks[oldest]->lastUsed) oldest = i;
+        }
+        if (oldest < 0) break;
+
+        UnloadWave(gTracks[oldest]->wave);
+        delete gTracks[oldest];
+        gTracks.erase(gTracks.begin() + oldest);
+    }
+
+    gDecodedTrackCount = (int) gTracks.size();
+}
+
+static void handle(const MusicCommand &command)
+{
+    gHasWanted = false;
+    if (command.path.empty())
+    {
+        fadeOutDecks(command.fadeSeconds);
+        return;
+    }
+
+    MusicTrack *track = findTrack(command.path);
+    if (track != nullptr) crossfadeTo(command, track);
+    else
+    {
+        // the old track keeps playing until this one is decoded
+        gWanted    = command;
+        gHasWanted = true;
+    }
+}
+
+static void mix(float *out, int frames)
+{
+    memset(out, 0, (size_t) frames * MusicPlayer::CHANNELS * sizeof(float));
+
+    for (MusicDeck &deck : gDecks)
+    {
+        const short *samples = (const short *) deck.track->wave.data;
+        unsigned int length  = deck.track->wave.frameCount;
+
+        for (int i = 0; i < frames; i++)
+        {
+            deck.fade = std::max(0.0f, std::min(1.0f, deck.fade + deck.fadeStep));
+            float gain = deck.volume * deck.fade / 32768.0f;
+
+            for (int channel = 0; channel < MusicPlayer::CHANNELS; channel++)
+                out[i * MusicPlayer::CHANNELS + channel] +=
+                    samples[deck.position * MusicPlayer::CHANNELS + channel] * gain;
+
+            if (++deck.position == length) deck.position = 0;
+        }
+    }
+
+    gDecks.erase(std::remove_if(gDecks.begin(), gDecks.end(), [](const MusicDeck &deck)
+    {
+        return deck.fadeStep < 0.0f && deck.fade <= 0.0f;
+    }), gDecks.end());
+}
+
+// Mixes until the ring has no room for another pass (silence if nothing is
+// playing, so the audio thread is never short)
+static void fillRing()
+{
+    static float block[MIX_FRAMES * MusicPlayer::CHANNELS];
+    unsigned int write = gWriteFrame.load(std::memory_order_relaxed);
+
+    while (MusicPlayer::RING_FRAMES - (write - gReadFrame.load(std::memory_order_acquire))
+           >= (unsigned int) MIX_FRAMES)
+    {
+        mix(block, MIX_FRAMES);
+        for (int i = 0; i < MIX_FRAMES; i++)
+        {
+            float *frame = gRing + ((write + i) & RING_MASK) * MusicPlayer::CHANNELS;
+            for (int channel = 0; channel < MusicPlayer::CHANNELS; channel++)
+                frame[channel] = block[i * MusicPlayer::CHANNELS + channel];
+        }
+
+        write += MIX_FRAMES;
+        gWriteFrame.store(write, std::memory_order_release);
+    }
+}
+
+static void streamMusic()
+{
+    for (;;)
+    {
+        fillRing();
+
+        std::deque<MusicCommand> commands;
+        {
+            std::unique_lock<std::mutex> lock(gMutex);
+            gCommandQueued.wait_for(lock, std::chrono::milliseconds(5),
+                [] { return gStopping || !gCommands.empty(); });
+            if (gStopping) return;
+            commands.swap(gCommands);
+        }
+
+        for (const MusicCommand &command : commands) handle(command);
+
+        if (gDecoding != nullptr && gDecoded.load(std::memory_order_acquire)) finishDecoding();
+
+        if (gHasWanted)
+        {
+            MusicTrack *track = findTrack(gWanted.path);
+            if (track != nullptr)
+            {
+                gHasWanted = false;
+                crossfadeTo(gWanted, track);
+            }
+            else if (gDecoding == nullptr) startDecoding(gWanted.path);
+        }
+    }
+}
+
+void MusicPlayer::start()
+{
+    if (gRunning || !IsAudioDeviceReady()) return;
+
+    gStopping = false;
+    gWriteFrame = 0;
+    gReadFrame  = 0;
+    fillRing(); // silence, so the stream never starts dry
+
+    gStream = LoadAudioStream(SAMPLE_RATE, 32, CHANNELS);
+    SetAudioStreamCallback(gStream, drainRing);
+    gMusicThread = std::thread(streamMusic);
+    PlayAudioStream(gStream);
+    gRunning = true;
+}
+
+void MusicPlayer::stop()
+{
+    if (!gRunning) return;
+
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        gStopping = true;
+    }
+    gCommandQueued.notify_all();
+    gMusicThread.join();
+
+    StopAudioStream(gStream);
+    UnloadAudioStream(gStream);
+
+    if (gDecoding != nullptr)
+    {
+        gDecoder.join();
+        gTracks.push_back(gDecoding);
+        gDecoding = nullptr;
+    }
+    for (MusicTrack *track : gTracks)
+    {
+        UnloadWave(track->wave);
+        delete track;
+    }
+
+    gTracks.clear();
+    gDecks.clear();
+    gCommands.clear();
+    gTrack.clear();
+    gHasWanted = false;
+    gDecodedTrackCount = 0;
+    gRunning = false;
+}
+
+void MusicPlayer::play(const char *filePath, float volume, float fadeSeconds)
+{
+    if (!gRunning) return;
+
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        if (gTrack == filePath && gVolume == volume) return;
+
+        gTrack  = filePath;
+        gVolume = volume;
+        gCommands.push_back({ filePath, volume, fadeSeconds });
+    }
+    gCommandQueued.notify_all();
+}
+
+void MusicPlayer::fadeOut(float fadeSeconds)
+{
+    if (!gRunning) return;
+
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        gTrack.clear();
+        gCommands.push_back({ "", 0.0f, fadeSeconds });
+    }
+    gCommandQueued.notify_all();
+}
+
+std::string MusicPlayer::getTrack()
+{
+    std::lock_guard<std::mutex> lock(gMutex);
+    return gTrack;
+}
+
+int MusicPlayer::getBufferedFrames()
+{
+    return (int) (gWriteFrame.load() - gReadFrame.load());
+}
+
+int MusicPlayer::getUnderrunCount()      { return gUnderrunCount;     }
+int MusicPlayer::getDecodedTrackCount()  { return gDecodedTrackCount; }
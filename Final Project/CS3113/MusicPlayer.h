@@ -0,0 +1,48 @@
+#include "cs3113.h"
+
+#ifndef MUSIC_PLAYER_H
+#define MUSIC_PLAYER_H
+
+/**
+ * Background music, mixed on its own thread. Scenes only send commands:
+ * `play` crossfades to a track (a no-op if it is already the one playing)
+ * and `fadeOut` fades to silence. The music thread decodes tracks, mixes the
+ * playing and fading ones (always looping) and keeps a lock-free ring of
+ * mixed frames topped up; raylib's audio thread drains the ring through the
+ * callback of one float AudioStream. Nothing on the main thread decodes or
+ * feeds audio, so a simulation hitch, a catch-up frame or a scene switch
+ * never starves the stream: it only runs dry if the music thread itself is
+ * held off for the length of the ring.
+ *
+ * raylib has no public incremental decoder, so a track is decoded whole (on
+ * a helper thread, while the old one keeps playing) and the last few stay
+ * decoded so scenes that alternate tracks do not decode them again.
+ *
+ * Without an audio device (headless runs) `start` does nothing and the
+ * commands are ignored.
+ */
+class MusicPlayer
+{
+public:
+    static constexpr int SAMPLE_RATE = 44100;
+    static constexpr int CHANNELS    = 2;
+    // Mixed frames queued for the audio thread (~190 ms); a power of two
+    static constexpr int RING_FRAMES = 8192;
+
+    // After InitAudioDevice: opens the stream and spawns the music thread
+    static void start();
+    // Before CloseAudioDevice and closeAssetPack: joins the threads and frees
+    // every decoded track
+    static void stop();
+
+    // Crossfades to the track, looping, at `volume`
+    static void play(const char *filePath, float volume, float fadeSeconds = 0.5f);
+    static void fadeOut(float fadeSeconds = 0.5f);
+
+    static std::string getTrack();     // the track last asked for, "" if none
+    static int getBufferedFrames();    // mixed and waiting in the ring
+    static int getUnderrunCount();     // audio callbacks the ring ran dry on
+    static int getDecodedTrackCount();
+};
+
+#endif // MUSIC_PLAYER_H
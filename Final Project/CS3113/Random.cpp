@@ -0,0 +1,40 @@
+#include "Random.h"
+
+void Random::reseed(uint64_t seed, uint64_t stream)
+{
+    mState     = 0;
+    mIncrement = (stream << 1u) | 1u;
+    next();
+    mState += seed;
+    next();
+}
+
+uint32_t Random::next()
+{
+    uint64_t oldState = mState;
+    mState = oldState * 6364136223846793005ULL + mIncrement;
+
+    uint32_t xorShifted = (uint32_t) (((oldState >> 18u) ^ oldState) >> 27u);
+    uint32_t rotation   = (uint32_t) (oldState >> 59u);
+    return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31u));
+}
+
+int Random::range(int min, int max)
+{
+    if (min > max)
+    {
+        int swap = min;
+        min = max;
+        max = swap;
+    }
+
+    uint32_t bound = (uint32_t) ((int64_t) max - min + 1);
+    if (bound == 0) return (int) ((int64_t) min + next()); // the full 32 bits
+
+    // Reject the few values that would bias the modulo towards low numbers
+    uint32_t threshold = (0u - bound) % bound;
+    uint32_t value;
+    do value = next(); while (value < threshold);
+
+    return (int) ((int64_t) min + value % bound);
+}
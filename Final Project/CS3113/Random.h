@@ -0,0 +1,34 @@
+#include <cstdint>
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+/**
+ * Small seeded generator (PCG32) for gameplay randomness. Unlike raylib's
+ * GetRandomValue it is not global: each scene owns its own streams, so a run
+ * replays exactly from its seed and the simulation does not depend on what
+ * else in the process drew random numbers.
+ *
+ * The stream id picks one of 2^63 independent sequences for the same seed;
+ * giving every subsystem its own stream keeps, say, an extra level-up
+ * shuffle from shifting every enemy spawn that follows it.
+ */
+class Random
+{
+private:
+    uint64_t mState     = 0;
+    uint64_t mIncrement = 1; // odd; selects the stream
+
+public:
+    Random(uint64_t seed = 0, uint64_t stream = 0) { reseed(seed, stream); }
+
+    void reseed(uint64_t seed, uint64_t stream = 0);
+
+    uint32_t next();
+    // Uniform in [min, max], both inclusive, like GetRandomValue
+    int range(int min, int max);
+    // Uniform in [0, 1)
+    float unit() { return (next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+#endif // RANDOM_H
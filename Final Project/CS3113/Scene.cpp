@@ -1,6 +1,7 @@
 #include "Scene.h"
 
 Scene::Scene() : mOrigin{{}} {
+    mEntityRegistry.bind(&mGameState.collidableEntities);
     ClearBackground(WHITE);
 }
 
@@ -8,13 +9,115 @@ int Scene::lives = 999;
 
 Scene::Scene(Vector2 origin, const char *bgHexCode) : mOrigin{origin}, mBGColourHexCode {bgHexCode}
 {
+    mEntityRegistry.bind(&mGameState.collidableEntities);
     ClearBackground(ColorFromHex(bgHexCode));
 }
 
+void Scene::setSeed(uint64_t seed)
+{
+    mSeed = seed;
+    mRandom.spawns.reseed(seed, SceneRandom::SPAWNS);
+    mRandom.enemyRolls.reseed(seed, SceneRandom::ENEMY_ROLLS);
+    mRandom.levelUp.reseed(seed, SceneRandom::LEVEL_UP);
+    mRandom.ai.reseed(seed, SceneRandom::AI);
+}
+
 void Scene::initialise() {  
-   mGameState.jumpSound = LoadSound("assets/jump.wav");
-   SetSoundVolume( mGameState.jumpSound, 0.5f);
-   mGameState.attackSound = LoadSound("assets/attack.wav");
+   mGameState.jumpSound   = VoicePool::load("assets/jump.wav",   { 1, 0.1f, PRIORITY_NORMAL, 0.5f });
+   mGameState.attackSound = VoicePool::load("assets/attack.wav", { 2, 0.05f, PRIORITY_NORMAL, 1.0f });
+}
+
+/**
+ * Loads the manifest's atlas and looks up every sheet it lists, so the first
+ * entity spawned with one mid-game finds its frames ready. Sheets the atlas
+ * does not pack are loaded (and held) as loose textures until the scene
+ * shuts down.
+ */
+void Scene::preloadManifest(const AssetManifest &manifest) {
+    SpriteAtlas::load(manifest.atlas);
+
+    for (const SpriteSheet &sheet : manifest.sheets)
+        SpriteAtlas::findSheet(sheet.path, sheet.rows, sheet.cols);
+
+    // the scene holds them now; the prefetch's hold is no longer needed
+    AssetLoader::release(manifest);
+}
+
+Entity *Scene::spawnEffect(Vector2 position, Vector2 scale, 
+    const char *textureFilepath, Vector2 spriteSheetDimensions, 
+    int walkSet) {
+    Entity *effect = mEffectPool.acquire();
+    if (effect == nullptr) return nullptr;
+
+    effect->respawn(position, scale, textureFilepath, ATLAS, 
+        spriteSheetDimensions, walkSet, EFFECT);
+    effect->setBulkIntegrated(true);
+    return effect;
+}
+
+void Scene::destroyEntity(Entity *entity) {
+    if (mEffectPool.owns(entity)) mEffectPool.release(entity);
+    else delete entity;
+}
+
+/**
+ * An effect goes inactive when its lifetime runs out or it hits something;
+ * this queues it so its slot goes back to the pool at the end of the tick
+ * instead of waiting for a cleanup sweep.
+ */
+void Scene::recycleInactiveEffects() {
+    std::vector<Entity*> &entities = mGameState.collidableEntities;
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        Entity *entity = entities[i];
+        if (entity != nullptr && !entity->isActive() && mEffectPool.owns(entity)) {
+            mEntityRegistry.remove(entity); // no-op if already queued
+        }
+    }
+}
+
+/**
+ * Swap-and-pops everything removed during the tick out of collidableEntities
+ * and frees it. Runs between ticks, so no loop is walking the list.
+ */
+void Scene::flushRemovedEntities() {
+    if (mEntityRegistry.getPendingCount() == 0) return;
+
+    mEntityRegistry.flush(mRemovedEntities);
+    for (size_t i = 0; i < mRemovedEntities.size(); ++i) {
+        destroyEntity(mRemovedEntities[i]);
+    }
+    mRemovedEntities.clear();
+    mEnemyIndex.invalidate(); // may have freed enemies
+}
+
+Entity *Scene::findClosestEnemy(Vector2 pos, float maxDistance) {
+    if (!mEnemyIndex.isBuilt()) mEnemyIndex.build(mGameState.collidableEntities);
+    return mEnemyIndex.nearest(pos, maxDistance);
+}
+
+std::vector<Entity*> Scene::findClosestEnemies(Vector2 pos, int count, 
+    float maxDistance) {
+    if (!mEnemyIndex.isBuilt()) mEnemyIndex.build(mGameState.collidableEntities);
+
+    std::vector<Entity*> result;
+    mEnemyIndex.nearest(pos, count, maxDistance, result);
+    return result;
+}
+
+void Scene::beginCulling() {
+    mVisibleArea    = getVisibleArea(&mGameState.camera);
+    mEntitiesDrawn  = 0;
+    mEntitiesCulled = 0;
+}
+
+bool Scene::isOnScreen(const Entity *entity) {
+    if (entity->isVisibleIn(mVisibleArea)) {
+        mEntitiesDrawn++;
+        return true;
+    }
+    mEntitiesCulled++;
+    return false;
 }
 
 void Scene::input(KeyboardKey key) {
@@ -29,22 +132,24 @@ void Scene::shutdown() {
     delete mGameState.map;
     mGameState.map = nullptr;
     for (size_t i = 0; i < mGameState.collidableEntities.size(); ++i) {
-        delete mGameState.collidableEntities[i];
+        destroyEntity(mGameState.collidableEntities[i]);
     }
     mGameState.collidableEntities.clear();  
+    mEntityRegistry.clear();
+    mEnemyIndex.invalidate();
+    mEffectPool.free();
 
     for (size_t i = 0; i < mGameState.hearts.size(); ++i) {
         delete mGameState.hearts[i];
     }
     mGameState.hearts.clear();
+
+    // every sheet ID handed out above is void from here
+    SpriteAtlas::clear();
     
-    if (mGameState.jumpSound.frameCount > 0) {
-        StopSound(mGameState.jumpSound);
-        UnloadSound(mGameState.jumpSound);
-    }
-    if (mGameState.attackSound.frameCount > 0) {
-        StopSound(mGameState.attackSound);
-        UnloadSound(mGameState.attackSound);
-    }
+    VoicePool::unload(mGameState.jumpSound);
+    VoicePool::unload(mGameState.attackSound);
+    mGameState.jumpSound   = VoicePool::NO_SOUND;
+    mGameState.attackSound = VoicePool::NO_SOUND;
 }
 
@@ -1,4 +1,13 @@
 #include "Entity.h"
+#include "EnemyIndex.h"
+#include "EntityPool.h"
+#include "EntityRegistry.h"
+#include "SpriteBatch.h"
+#include "Input.h"
+#include "Random.h"
+#include "AssetLoader.h"
+#include "VoicePool.h"
+#include "MusicPlayer.h"
 
 #ifndef SCENE_H
 #define SCENE_H
@@ -11,23 +20,74 @@ struct GameState
     std::vector<Entity*> hearts;
     std::vector<Entity*> projectiles;
 
-    Music bgm;
-    Sound jumpSound;
-    Sound attackSound;
-    Sound aquireSound;
+    // VoicePool IDs
+    int jumpSound   = VoicePool::NO_SOUND;
+    int attackSound = VoicePool::NO_SOUND;
+    int aquireSound = VoicePool::NO_SOUND;
 
     Camera2D camera;
     KeyboardKey key = KEY_F1;
     int nextSceneID;
 };
 
+// Gameplay randomness, one stream per subsystem (see Random)
+struct SceneRandom
+{
+    enum Stream { SPAWNS = 1, ENEMY_ROLLS, LEVEL_UP, AI };
+
+    Random spawns     { 0, SPAWNS      }; // enemy spawn positions
+    Random enemyRolls { 0, ENEMY_ROLLS }; // which enemy type spawns
+    Random levelUp    { 0, LEVEL_UP    }; // level-up option shuffles
+    Random ai         { 0, AI          }; // wanderer direction changes
+};
+
 class Scene 
 {
 protected:
     GameState mGameState;
     Vector2 mOrigin;
     const char *mBGColourHexCode = "#000000";
-    
+    EnemyIndex mEnemyIndex; // built on the first targeting query of a tick
+    EntityPool mEffectPool; // bullets, arrows and beams; sized by the level
+    EntityRegistry mEntityRegistry; // slots for collidableEntities, if used
+    std::vector<Entity*> mRemovedEntities; // scratch for flushRemovedEntities()
+    SceneRandom mRandom;
+    uint64_t mSeed = 0;
+
+    // Loads the manifest's atlas and every sheet in it into SpriteAtlas until
+    // shutdown() (its sounds are loaded by the scene's own loadSound calls)
+    void preloadManifest(const AssetManifest &manifest);
+
+    // Pooled EFFECT entity in its atlas-constructor state, or nullptr if the
+    // pool is exhausted (the caller skips the shot). It is bulk-integrated,
+    // so the level must run EntityStore::integrate once per tick
+    Entity *spawnEffect(Vector2 position, Vector2 scale, 
+        const char *textureFilepath, Vector2 spriteSheetDimensions, 
+        int walkSet);
+    // Returns pooled entities to the pool and deletes everything else
+    void destroyEntity(Entity *entity);
+    // Queues inactive pooled effects for removal at the end of the tick
+    void recycleInactiveEffects();
+
+    // Registered entities live in collidableEntities and can be referred to
+    // by handle; removal is deferred to flushRemovedEntities()
+    EntityHandle addEntity(Entity *entity) { return mEntityRegistry.add(entity); }
+    Entity *getEntity(EntityHandle handle) const { return mEntityRegistry.get(handle); }
+    void removeEntity(Entity *entity) { mEntityRegistry.remove(entity); }
+
+    // Auto-aim helpers over mEnemyIndex (live NPCs in collidableEntities)
+    Entity *findClosestEnemy(Vector2 pos, float maxDistance = 600.0f);
+    std::vector<Entity*> findClosestEnemies(Vector2 pos, int count,
+        float maxDistance = 600.0f);
+
+    // Frustum culling for render(): beginCulling() takes the camera's
+    // visible area, then isOnScreen() tests (and counts) each sprite
+    Rectangle mVisibleArea = { 0.0f, 0.0f, 0.0f, 0.0f };
+    int mEntitiesDrawn  = 0;
+    int mEntitiesCulled = 0;
+
+    void beginCulling();
+    bool isOnScreen(const Entity *entity);
 
 public:
     static int lives;
@@ -41,9 +101,19 @@ public:
     virtual void renderUI() = 0; // render elements that are fixed to screen
     virtual void shutdown() = 0;
     virtual void input(KeyboardKey key); 
+    // Called once after every update(): frees what removeEntity() queued
+    void flushRemovedEntities();
     int getLives() { return lives; }
+    // Restarts every random stream from the seed; call before initialise()
+    // to replay a run
+    void setSeed(uint64_t seed);
+    uint64_t getSeed() const { return mSeed; }
     
-    GameState   getState()           const { return mGameState; }
+    const GameState &getState()       const { return mGameState; }
+    EntityView  getCollidableEntities() const { return mGameState.collidableEntities; }
+    const EntityPool &getEffectPool() const { return mEffectPool; }
+    int getEntitiesDrawn()            const { return mEntitiesDrawn;  }
+    int getEntitiesCulled()           const { return mEntitiesCulled; }
     Vector2     getOrigin()          const { return mOrigin;    }
     const char* getBGColourHexCode() const { return mBGColourHexCode; }
 };
@@ -0,0 +1,42 @@
+#include "SimulationClock.h"
+
+SimulationClock::SimulationClock(int ticksPerSecond, int maxSubsteps)
+    : mStep {1.0f / (ticksPerSecond > 0 ? ticksPerSecond : DEFAULT_RATE)}
+{
+    setMaxSubsteps(maxSubsteps);
+}
+
+int SimulationClock::advance(float realDeltaTime)
+{
+    if (realDeltaTime > 0.0f) mAccumulator += realDeltaTime;
+
+    int steps = (int) (mAccumulator / mStep);
+    mAccumulator -= steps * mStep;
+
+    // float rounding can leave a hair over one step or a hair under zero
+    if (mAccumulator >= mStep)
+    {
+        steps++;
+        mAccumulator -= mStep;
+    }
+    if (mAccumulator < 0.0f) mAccumulator = 0.0f;
+
+    if (steps > mMaxSubsteps)
+    {
+        mDroppedTicks += steps - mMaxSubsteps;
+        steps = mMaxSubsteps;
+    }
+
+    mStepsLastAdvance = steps;
+    mTicks += steps;
+    return steps;
+}
+
+void SimulationClock::setRate(int ticksPerSecond)
+{
+    if (ticksPerSecond <= 0) return;
+
+    float blend = getBlend();
+    mStep = 1.0f / ticksPerSecond;
+    mAccumulator = blend * mStep;
+}
@@ -0,0 +1,50 @@
+#ifndef SIMULATION_CLOCK_H
+#define SIMULATION_CLOCK_H
+
+/**
+ * Fixed-step clock that decouples the simulation rate from the render rate.
+ * Each frame main hands it the real time that passed; it answers how many
+ * fixed steps to run, never more than the max-substeps budget, so one slow
+ * frame cannot snowball into ever longer catch-up frames. Whatever backlog
+ * is over budget is dropped (the game slows down briefly instead).
+ *
+ * What is left over after the steps, as a fraction of a step, is the blend
+ * the renderer uses to draw between the previous and the current snapshot.
+ */
+class SimulationClock
+{
+private:
+    float mStep;               // seconds per tick
+    int   mMaxSubsteps;        // ticks allowed per advance()
+    float mAccumulator  = 0.0f;
+    int   mStepsLastAdvance = 0;
+    int   mDroppedTicks = 0;   // over-budget ticks thrown away so far
+    unsigned long long mTicks = 0;
+
+public:
+    static constexpr int DEFAULT_RATE         = 60;
+    static constexpr int DEFAULT_MAX_SUBSTEPS = 8;
+
+    SimulationClock(int ticksPerSecond = DEFAULT_RATE,
+        int maxSubsteps = DEFAULT_MAX_SUBSTEPS);
+
+    // Adds a frame's worth of real time; returns how many fixed steps to run
+    int advance(float realDeltaTime);
+
+    // Changes the tick rate (e.g. 120 or 240 Hz); any partial step is kept
+    // as the same fraction of the new step
+    void setRate(int ticksPerSecond);
+    void setMaxSubsteps(int maxSubsteps)
+        { mMaxSubsteps = maxSubsteps < 1 ? 1 : maxSubsteps; }
+
+    float getStep()         const { return mStep;                    }
+    int   getRate()         const { return (int) (1.0f / mStep + 0.5f); }
+    int   getMaxSubsteps()  const { return mMaxSubsteps;             }
+    // 0 = draw the previous snapshot, 1 = the current one
+    float getBlend()        const { return mAccumulator / mStep;     }
+    int   getStepsLastAdvance() const { return mStepsLastAdvance;    }
+    int   getDroppedTicks() const { return mDroppedTicks;            }
+    unsigned long long getTicks() const { return mTicks;             }
+};
+
+#endif // SIMULATION_CLOCK_H
@@ -0,0 +1,198 @@
+#include "SpatialHash.h"
+#include <algorithm>
+
+/**
+ * @brief Upper bound on how far an entity can travel along either axis during
+ * one Entity::update of the given length.
+ */
+static float stepReach(const Entity *entity, float deltaTime)
+{
+    Vector2 movement     = entity->getMovement();
+    Vector2 velocity     = entity->getVelocity();
+    Vector2 acceleration = entity->getAcceleration();
+
+    float direction = fmaxf(1.0f, fmaxf(fabsf(movement.x), fabsf(movement.y)));
+    float speed     = fabsf((float) entity->getSpeed()) * direction;
+    speed = fmaxf(speed, fmaxf(fabsf(velocity.x), fabsf(velocity.y)));
+
+    return speed * deltaTime +
+        (fabsf(acceleration.x) + fabsf(acceleration.y)) * deltaTime * deltaTime;
+}
+
+SpatialHash::SpatialHash(float cellSize, float slack)
+    : mCellSize {cellSize}, mInverseCellSize {1.0f / cellSize}, mSlack {slack} { }
+
+int SpatialHash::cellOf(float coordinate) const
+{
+    return (int) floorf(coordinate * mInverseCellSize);
+}
+
+unsigned int SpatialHash::bucketOf(int cellX, int cellY) const
+{
+    return (((unsigned int) cellX * 73856093u) ^
+            ((unsigned int) cellY * 19349663u)) & mBucketMask;
+}
+
+void SpatialHash::build(EntityView entities, float deltaTime)
+{
+    mEntityCount = (int) entities.size();
+
+    // twice as many buckets as entities keeps the chains short
+    unsigned int bucketCount = 256;
+    while (bucketCount < 2u * (unsigned int) mEntityCount) bucketCount <<= 1;
+    mBucketMask = bucketCount - 1;
+
+    mBucketStarts.assign(bucketCount + 1, 0);
+    mSlotEntities.assign(entities.begin(), entities.end());
+    mBounds.resize(mEntityCount);
+    mStamps.assign(mEntityCount, 0);
+    mQueryStamp = 0;
+    mOversized.clear();
+
+    // STEP 1: pad every box and count how many entries land in each bucket
+    int total = 0;
+    for (int slot = 0; slot < mEntityCount; slot++)
+    {
+        Entity *entity = entities[slot];
+        Bounds &bounds = mBounds[slot];
+
+        if (entity == nullptr || !entity->isActive())
+        {
+            bounds = { 1.0f, 1.0f, 0.0f, 0.0f }; // empty, never overlaps
+            continue;
+        }
+
+        Vector2 position   = entity->getPosition();
+        Vector2 dimensions = entity->getColliderDimensions();
+        float pad = stepReach(entity, deltaTime) + mSlack;
+
+        bounds.minX = position.x - dimensions.x / 2.0f - pad;
+        bounds.maxX = position.x + dimensions.x / 2.0f + pad;
+        bounds.minY = position.y - dimensions.y / 2.0f - pad;
+        bounds.maxY = position.y + dimensions.y / 2.0f + pad;
+
+        int x0 = cellOf(bounds.minX), x1 = cellOf(bounds.maxX);
+        int y0 = cellOf(bounds.minY), y1 = cellOf(bounds.maxY);
+
+        if ((x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CELLS_PER_ENTITY)
+        {
+            Entry entry = { slot, entity->getEntityType() };
+            mOversized.push_back(entry);
+            continue;
+        }
+
+        for (int y = y0; y <= y1; y++)
+            for (int x = x0; x <= x1; x++)
+                mBucketStarts[bucketOf(x, y)]++;
+
+        total += (x1 - x0 + 1) * (y1 - y0 + 1);
+    }
+
+    // STEP 2: running totals, so mBucketStarts[b] is the end of bucket b...
+    for (unsigned int b = 1; b <= bucketCount; b++)
+        mBucketStarts[b] += mBucketStarts[b - 1];
+
+    // STEP 3: ...and filling backwards walks each one back to its start
+    mEntries.resize(total);
+    for (int slot = mEntityCount - 1; slot >= 0; slot--)
+    {
+        const Bounds &bounds = mBounds[slot];
+        if (bounds.minX > bounds.maxX) continue;
+
+        int x0 = cellOf(bounds.minX), x1 = cellOf(bounds.maxX);
+        int y0 = cellOf(bounds.minY), y1 = cellOf(bounds.maxY);
+        if ((x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CELLS_PER_ENTITY) continue;
+
+        Entry entry = { slot, mSlotEntities[slot]->getEntityType() };
+
+        for (int y = y0; y <= y1; y++)
+            for (int x = x0; x <= x1; x++)
+                mEntries[--mBucketStarts[bucketOf(x, y)]] = entry;
+    }
+}
+
+void SpatialHash::collect(const Bounds &area, bool filterByType,
+    EntityType type, std::vector<Entity*> &out)
+{
+    out.clear();
+    if (mBucketStarts.empty()) return; // not built yet
+
+    mFoundSlots.clear();
+    mQueryStamp++;
+
+    auto consider = [&](const Entry &entry)
+    {
+        if (mStamps[entry.slot] == mQueryStamp) return;
+        mStamps[entry.slot] = mQueryStamp;
+
+        if (filterByType && entry.type != type) return;
+
+        const Bounds &bounds = mBounds[entry.slot];
+        if (bounds.maxX < area.minX || bounds.minX > area.maxX ||
+            bounds.maxY < area.minY || bounds.minY > area.maxY) return;
+
+        mFoundSlots.push_back(entry.slot);
+    };
+
+    int x0 = cellOf(area.minX), x1 = cellOf(area.maxX);
+    int y0 = cellOf(area.minY), y1 = cellOf(area.maxY);
+    long long cells = (long long) (x1 - x0 + 1) * (y1 - y0 + 1);
+
+    if (cells > (long long) mBucketMask + 1)
+    {
+        // the area covers more cells than there are buckets; walking every
+        // entry once is cheaper than hashing each cell
+        for (const Entry &entry : mEntries) consider(entry);
+    }
+    else
+    {
+        for (int y = y0; y <= y1; y++)
+        {
+            for (int x = x0; x <= x1; x++)
+            {
+                unsigned int bucket = bucketOf(x, y);
+                for (int i = mBucketStarts[bucket]; i < mBucketStarts[bucket + 1]; i++)
+                    consider(mEntries[i]);
+            }
+        }
+    }
+
+    for (const Entry &entry : mOversized) consider(entry);
+
+    // hand results back in list order, so anything that keeps "the last
+    // thing I touched" behaves exactly as it did with a full scan
+    std::sort(mFoundSlots.begin(), mFoundSlots.end());
+    for (int slot : mFoundSlots) out.push_back(mSlotEntities[slot]);
+}
+
+void SpatialHash::query(Vector2 centre, Vector2 dimensions,
+    std::vector<Entity*> &out)
+{
+    Bounds area = {
+        centre.x - dimensions.x / 2.0f, centre.y - dimensions.y / 2.0f,
+        centre.x + dimensions.x / 2.0f, centre.y + dimensions.y / 2.0f
+    };
+    collect(area, false, NONE, out);
+}
+
+void SpatialHash::query(Vector2 centre, Vector2 dimensions, EntityType type,
+    std::vector<Entity*> &out)
+{
+    Bounds area = {
+        centre.x - dimensions.x / 2.0f, centre.y - dimensions.y / 2.0f,
+        centre.x + dimensions.x / 2.0f, centre.y + dimensions.y / 2.0f
+    };
+    collect(area, true, type, out);
+}
+
+void SpatialHash::queryMovement(const Entity *entity, float deltaTime,
+    std::vector<Entity*> &out)
+{
+    float   reach      = stepReach(entity, deltaTime);
+    Vector2 dimensions = entity->getColliderDimensions();
+
+    dimensions.x += 2.0f * reach;
+    dimensions.y += 2.0f * reach;
+
+    query(entity->getPosition(), dimensions, out);
+}
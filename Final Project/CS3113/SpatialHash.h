@@ -0,0 +1,76 @@
+#include "Entity.h"
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+/**
+ * Uniform-grid broadphase over a list of entities. Each entity is filed under
+ * every cell its (padded) collider touches; cells are hashed into a fixed
+ * power-of-two bucket table, so the world does not need to be bounded.
+ *
+ * Rebuilt from scratch once per fixed step with a counting sort, which keeps
+ * the whole grid in three flat arrays and allocates nothing once the arrays
+ * have grown to the working set.
+ *
+ * Each entity's box is padded by how far it can move in one step, so a grid
+ * built at the top of the step stays valid while that step moves things
+ * around. Queries return candidates only; callers still run the exact test.
+ */
+class SpatialHash
+{
+private:
+    struct Bounds { float minX, minY, maxX, maxY; };
+
+    struct Entry
+    {
+        int        slot; // position in the list the grid was built from
+        EntityType type; // copied so filtered queries never dereference
+    };
+
+    float mCellSize;
+    float mInverseCellSize;
+    float mSlack;
+
+    unsigned int mBucketMask = 0;
+
+    std::vector<int>    mBucketStarts; // prefix sums, mBucketMask + 2 long
+    std::vector<Entry>  mEntries;      // grouped by bucket
+    std::vector<Entry>  mOversized;    // covers too many cells, always tested
+    std::vector<Entity*> mSlotEntities; // copy of the list, which may grow
+    std::vector<Bounds> mBounds;       // padded box per slot
+    std::vector<unsigned int> mStamps; // per-slot query stamp for dedupe
+    std::vector<int>    mFoundSlots;   // scratch for query()
+
+    unsigned int mQueryStamp = 0;
+    int mEntityCount = 0;
+
+    static const int MAX_CELLS_PER_ENTITY = 64;
+
+    int cellOf(float coordinate) const;
+    unsigned int bucketOf(int cellX, int cellY) const;
+    void collect(const Bounds &area, bool filterByType, EntityType type,
+        std::vector<Entity*> &out);
+
+public:
+    // `slack` is extra padding for shoves that happen outside Entity::update
+    // (knockback and the like) between the build and the last query.
+    SpatialHash(float cellSize, float slack = 0.0f);
+
+    void build(EntityView entities, float deltaTime);
+
+    // All entities whose padded box overlaps the given box, in list order.
+    void query(Vector2 centre, Vector2 dimensions, std::vector<Entity*> &out);
+    // Same as query(), limited to one entity type.
+    void query(Vector2 centre, Vector2 dimensions, EntityType type,
+        std::vector<Entity*> &out);
+    // Everything `entity` could touch during this step's Entity::update.
+    void queryMovement(const Entity *entity, float deltaTime,
+        std::vector<Entity*> &out);
+
+    float getCellSize()    const { return mCellSize;         };
+    int   getEntityCount() const { return mEntityCount;      };
+    int   getBucketCount() const { return (int) mBucketMask + 1; };
+    int   getEntryCount()  const { return (int) mEntries.size(); };
+};
+
+#endif // SPATIAL_HASH_H
@@ -0,0 +1,321 @@
+#include "SpriteAtlas.h"
+#include "TextureCache.h"
+#include <cstring>
+#include <unordered_map>
+
+static const char     MAGIC[4] = { 'S', 'A', 'T', 'L' };
+static const uint32_t VERSION  = 1;
+
+// Little-endian like AssetPack, so records are read and written as-is
+struct TableHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t pageCount;
+    uint32_t sheetCount;
+    uint32_t frameCount;
+    uint32_t stringsBytes;
+};
+
+struct TablePage  { uint32_t pathOffset, pathBytes; };
+struct TableSheet { uint32_t pathOffset, pathBytes, rows, cols, firstFrame, frameCount; };
+struct TableFrame { uint32_t page; float x, y, width, height; };
+
+static_assert(sizeof(TableHeader) == 24 && sizeof(TablePage) == 8 &&
+              sizeof(TableSheet) == 24 && sizeof(TableFrame) == 20,
+    "frame table records must have no padding");
+
+struct LoadedSheet
+{
+    std::string path;
+    int         rows, cols;
+    int         firstFrame, frameCount;
+    Texture2D   texture; // loose sheets only; atlas pages are held in gPages
+};
+
+static std::vector<LoadedSheet> gSheets;
+static std::vector<SpriteFrame> gFrames;
+static std::vector<Texture2D>   gPages;
+static int gLooseSheets = 0;
+
+// (path, rows, cols) hash -> sheet; like TextureCache, a lookup from a
+// `const char *` never builds a std::string
+static std::unordered_map<unsigned long long, int> gSheetsByKey;
+
+static const SpriteFrame gEmptyFrame = { { 0 }, { 0.0f, 0.0f, 0.0f, 0.0f } };
+
+static unsigned long long sheetKey(const char *path, int rows, int cols)
+{
+    unsigned long long hash = AssetPack::hashPath(path, strlen(path));
+    hash = (hash ^ (unsigned int) rows) * 1099511628211ULL;
+    hash = (hash ^ (unsigned int) cols) * 1099511628211ULL;
+    return hash;
+}
+
+static bool sameCut(const LoadedSheet &sheet, const char *path, int rows, int cols)
+{
+    return sheet.rows == rows && sheet.cols == cols && sheet.path == path;
+}
+
+static int lookUp(const char *path, int rows, int cols)
+{
+    auto found = gSheetsByKey.find(sheetKey(path, rows, cols));
+    if (found != gSheetsByKey.end() && sameCut(gSheets[found->second], path, rows, cols))
+        return found->second;
+
+    // a hash collision sends the second cut here; they are never both hot
+    for (size_t sheet = 0; sheet < gSheets.size(); sheet++)
+        if (sameCut(gSheets[sheet], path, rows, cols)) return (int) sheet;
+
+    return SpriteAtlas::NO_SHEET;
+}
+
+static int addSheet(const LoadedSheet &sheet)
+{
+    int id = (int) gSheets.size();
+    gSheets.push_back(sheet);
+    gSheetsByKey.insert(std::make_pair(sheetKey(sheet.path.c_str(), sheet.rows, sheet.cols), id));
+    return id;
+}
+
+bool AtlasTable::packs(const char *path, int rows, int cols) const
+{
+    for (const Sheet &sheet : sheets)
+        if (sheet.rows == rows && sheet.cols == cols && sheet.path == path) return true;
+
+    return false;
+}
+
+void SpriteAtlas::cutGrid(float width, float height, int rows, int cols,
+    std::vector<Rectangle> *frames)
+{
+    frames->clear();
+    if (rows <= 0 || cols <= 0) return;
+
+    // fractions of the sheet, so a grid that does not divide it evenly gets
+    // fractional frames rather than dropping or widening texels
+    for (int index = 0; index < rows * cols; index++)
+    {
+        float u = (float) (index % cols) / (float) cols;
+        float v = (float) (index / cols) / (float) rows;
+        frames->push_back({ u * width, v * height, width / (float) cols, height / (float) rows });
+    }
+}
+
+bool SpriteAtlas::readTable(const char *tablePath, AtlasTable *table)
+{
+    const unsigned char *data;
+    size_t size;
+    unsigned char *loaded = nullptr;
+
+    if (!getAssetPack().find(tablePath, &data, &size))
+    {
+        if (!FileExists(tablePath)) return false;
+
+        int bytes = 0;
+        loaded = LoadFileData(tablePath, &bytes);
+        if (loaded == nullptr) return false;
+        data = loaded;
+        size = (size_t) bytes;
+    }
+
+    TableHeader header;
+    bool valid = size >= sizeof(TableHeader);
+    if (valid) memcpy(&header, data, sizeof(header));
+
+    size_t pagesOffset   = sizeof(TableHeader);
+    size_t sheetsOffset  = valid ? pagesOffset  + (size_t) header.pageCount  * sizeof(TablePage)  : 0;
+    size_t framesOffset  = valid ? sheetsOffset + (size_t) header.sheetCount * sizeof(TableSheet) : 0;
+    size_t stringsOffset = valid ? framesOffset + (size_t) header.frameCount * sizeof(TableFrame) : 0;
+
+    valid = valid && memcmp(header.magic, MAGIC, 4) == 0 && header.version == VERSION &&
+            header.pageCount > 0 && stringsOffset + header.stringsBytes == size;
+
+    const char *strings = (const char *) data + stringsOffset;
+    AtlasTable read;
+
+    for (uint32_t i = 0; valid && i < header.pageCount; i++)
+    {
+        TablePage page;
+        memcpy(&page, data + pagesOffset + i * sizeof(TablePage), sizeof(page));
+        valid = (uint64_t) page.pathOffset + page.pathBytes <= header.stringsBytes;
+        if (valid) read.pages.push_back(std::string(strings + page.pathOffset, page.pathBytes));
+    }
+
+    for (uint32_t i = 0; valid && i < header.sheetCount; i++)
+    {
+        TableSheet sheet;
+        memcpy(&sheet, data + sheetsOffset + i * sizeof(TableSheet), sizeof(sheet));
+
+        // every sheet is its whole grid, inside the frame list
+        valid = (uint64_t) sheet.pathOffset + sheet.pathBytes <= header.stringsBytes &&
+                sheet.rows > 0 && sheet.cols > 0 && sheet.rows <= 1024 && sheet.cols <= 1024 &&
+                sheet.frameCount == sheet.rows * sheet.cols &&
+                (uint64_t) sheet.firstFrame + sheet.frameCount <= header.frameCount;
+
+        if (valid)
+            read.sheets.push_back({ std::string(strings + sheet.pathOffset, sheet.pathBytes),
+                (int) sheet.rows, (int) sheet.cols, (int) sheet.firstFrame, (int) sheet.frameCount });
+    }
+
+    for (uint32_t i = 0; valid && i < header.frameCount; i++)
+    {
+        TableFrame frame;
+        memcpy(&frame, data + framesOffset + i * sizeof(TableFrame), sizeof(frame));
+        valid = frame.page < header.pageCount;
+        if (valid)
+            read.frames.push_back({ (int) frame.page,
+                { frame.x, frame.y, frame.width, frame.height } });
+    }
+
+    if (loaded != nullptr) UnloadFileData(loaded);
+    if (valid) *table = read;
+    return valid;
+}
+
+bool SpriteAtlas::writeTable(const char *tablePath, const AtlasTable &table)
+{
+    std::string strings;
+    std::vector<TablePage>  pages;
+    std::vector<TableSheet> sheets;
+    std::vector<TableFrame> frames;
+
+    for (const std::string &path : table.pages)
+    {
+        pages.push_back({ (uint32_t) strings.size(), (uint32_t) path.size() });
+        strings += path;
+    }
+    for (const AtlasTable::Sheet &sheet : table.sheets)
+    {
+        sheets.push_back({ (uint32_t) strings.size(), (uint32_t) sheet.path.size(),
+            (uint32_t) sheet.rows, (uint32_t) sheet.cols,
+            (uint32_t) sheet.firstFrame, (uint32_t) sheet.frameCount });
+        strings += sheet.path;
+    }
+    for (const AtlasTable::Frame &frame : table.frames)
+        frames.push_back({ (uint32_t) frame.page, frame.source.x, frame.source.y,
+            frame.source.width, frame.source.height });
+
+    TableHeader header;
+    memcpy(header.magic, MAGIC, 4);
+    header.version      = VERSION;
+    header.pageCount    = (uint32_t) pages.size();
+    header.sheetCount   = (uint32_t) sheets.size();
+    header.frameCount   = (uint32_t) frames.size();
+    header.stringsBytes = (uint32_t) strings.size();
+
+    FILE *file = fopen(tablePath, "wb");
+    if (file == nullptr) return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(pages.data(),  sizeof(TablePage),  pages.size(),  file) == pages.size()  &&
+              fwrite(sheets.data(), sizeof(TableSheet), sheets.size(), file) == sheets.size() &&
+              fwrite(frames.data(), sizeof(TableFrame), frames.size(), file) == frames.size() &&
+              fwrite(strings.data(), 1, strings.size(), file) == strings.size();
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) remove(tablePath);
+    return ok;
+}
+
+bool SpriteAtlas::load(const char *tablePath)
+{
+    AtlasTable table;
+    if (tablePath == nullptr || !readTable(tablePath, &table)) return false;
+
+    int firstPage = (int) gPages.size();
+    for (const std::string &page : table.pages)
+        gPages.push_back(TextureCache::acquire(page.c_str()));
+
+    int firstFrame = (int) gFrames.size();
+    for (const AtlasTable::Frame &frame : table.frames)
+        gFrames.push_back({ gPages[firstPage + frame.page], frame.source });
+
+    for (const AtlasTable::Sheet &sheet : table.sheets)
+    {
+        // a cut already in use keeps its ID (and its loose texture)
+        if (lookUp(sheet.path.c_str(), sheet.rows, sheet.cols) != NO_SHEET) continue;
+
+        addSheet({ sheet.path, sheet.rows, sheet.cols, firstFrame + sheet.firstFrame,
+                   sheet.frameCount, { 0 } });
+    }
+
+    return true;
+}
+
+void SpriteAtlas::clear()
+{
+    for (const LoadedSheet &sheet : gSheets) TextureCache::release(sheet.texture);
+    for (const Texture2D &page : gPages) TextureCache::release(page);
+
+    gSheets.clear();
+    gFrames.clear();
+    gPages.clear();
+    gSheetsByKey.clear();
+    gLooseSheets = 0;
+}
+
+int SpriteAtlas::findSheet(const char *textureFilepath, int rows, int cols)
+{
+    if (textureFilepath == nullptr) textureFilepath = "";
+    if (rows < 0) rows = 0;
+    if (cols < 0) cols = 0;
+
+    int sheet = lookUp(textureFilepath, rows, cols);
+    if (sheet != NO_SHEET) return sheet;
+
+    // not in any atlas: cut the loose texture (empty without a window, but
+    // with the full frame count, so frame numbers clamp the same way)
+    Texture2D texture = TextureCache::acquire(textureFilepath);
+    std::vector<Rectangle> rects;
+    cutGrid((float) texture.width, (float) texture.height, rows, cols, &rects);
+
+    int firstFrame = (int) gFrames.size();
+    for (const Rectangle &rect : rects) gFrames.push_back({ texture, rect });
+
+    gLooseSheets++;
+    return addSheet({ textureFilepath, rows, cols, firstFrame, (int) rects.size(), texture });
+}
+
+const SpriteFrame &SpriteAtlas::frame(int sheet, int frameNumber)
+{
+    if (sheet < 0 || sheet >= (int) gSheets.size()) return gEmptyFrame;
+
+    const LoadedSheet &loaded = gSheets[sheet];
+    if (loaded.frameCount == 0) return gEmptyFrame;
+    if (frameNumber >= loaded.frameCount) frameNumber = loaded.frameCount - 1;
+    if (frameNumber < 0) frameNumber = 0;
+
+    return gFrames[loaded.firstFrame + frameNumber];
+}
+
+int SpriteAtlas::frameCount(int sheet)
+{
+    return sheet < 0 || sheet >= (int) gSheets.size() ? 0 : gSheets[sheet].frameCount;
+}
+
+const char *SpriteAtlas::getPath(int sheet)
+{
+    return sheet < 0 || sheet >= (int) gSheets.size() ? "" : gSheets[sheet].path.c_str();
+}
+
+std::vector<std::string> SpriteAtlas::imagePaths(const char *tablePath,
+    const std::vector<SpriteSheet> &sheets)
+{
+    AtlasTable table;
+    bool packed = tablePath != nullptr && readTable(tablePath, &table);
+
+    std::vector<std::string> paths;
+    if (packed) paths = table.pages;
+
+    for (const SpriteSheet &sheet : sheets)
+        if (!packed || !table.packs(sheet.path, sheet.rows, sheet.cols))
+            paths.push_back(sheet.path);
+
+    return paths;
+}
+
+int SpriteAtlas::getPageCount()       { return (int) gPages.size();  }
+int SpriteAtlas::getSheetCount()      { return (int) gSheets.size(); }
+int SpriteAtlas::getLooseSheetCount() { return gLooseSheets;         }
+int SpriteAtlas::getFrameCount()      { return (int) gFrames.size(); }
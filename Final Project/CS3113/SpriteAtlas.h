@@ -0,0 +1,100 @@
+#include "cs3113.h"
+
+#ifndef SPRITE_ATLAS_H
+#define SPRITE_ATLAS_H
+
+// A sheet and the rows x cols grid its frames are cut on; 1 x 1 is a single
+// image drawn whole
+struct SpriteSheet
+{
+    const char *path;
+    int rows;
+    int cols;
+};
+
+// Where one frame is drawn from: a texture and the source rectangle in it
+struct SpriteFrame
+{
+    Texture2D texture;
+    Rectangle source;
+};
+
+/**
+ * Frame table as tools/AtlasPacker.cpp writes it: the page images, every
+ * sheet that was packed (file, grid, and the run of frames it was cut into)
+ * and each frame's page and source rectangle on that page.
+ *
+ * File layout (all integers little-endian, rectangles as floats):
+ *
+ *     header     "SATL", version, page, sheet and frame count,
+ *                strings bytes                             (6 x uint32)
+ *     pages      path offset, path bytes                   (2 x uint32)
+ *     sheets     path offset, path bytes, rows, cols,
+ *                first frame, frame count                  (6 x uint32)
+ *     frames     page (uint32), x, y, width, height        (4 x float)
+ *     strings    the paths, unterminated
+ */
+struct AtlasTable
+{
+    struct Sheet { std::string path; int rows, cols, firstFrame, frameCount; };
+    struct Frame { int page; Rectangle source; };
+
+    std::vector<std::string> pages;
+    std::vector<Sheet>       sheets;
+    std::vector<Frame>       frames;
+
+    bool packs(const char *path, int rows, int cols) const;
+};
+
+/**
+ * Every frame an entity or map draws, by ID. A scene loads its level's atlas
+ * (a few large pages holding the frames of every sheet the level uses, see
+ * `make atlas`) and `findSheet` hands out sheet IDs whose frames are source
+ * rectangles on those pages, so the sprite batch binds one or two textures
+ * per frame instead of one per sheet. A sheet the atlas does not pack (or
+ * every sheet, when no atlas was built) is loaded through TextureCache and
+ * cut on its grid here instead, which draws the same pixels.
+ *
+ * IDs stay valid until `clear()`, which Scene::shutdown calls once the
+ * scene's entities and map are gone.
+ */
+class SpriteAtlas
+{
+public:
+    static constexpr int NO_SHEET = -1;
+
+    // Adds the table's sheets and acquires its pages. False, with nothing
+    // added, if the table is missing or malformed
+    static bool load(const char *tablePath);
+    // Forgets every sheet and releases the textures they held
+    static void clear();
+
+    // Sheet of the file cut rows x cols: the atlas's if it packs that cut,
+    // else one cut from the loose texture. Never allocates once it exists
+    static int findSheet(const char *textureFilepath, int rows, int cols);
+    // Frame of a sheet; numbers past the end give the last frame, and
+    // NO_SHEET (or an empty sheet) an empty frame that draws nothing
+    static const SpriteFrame &frame(int sheet, int frameNumber);
+    static int frameCount(int sheet);
+    static const char *getPath(int sheet);
+
+    // The rows x cols grid over a width x height image, row by row: the one
+    // cut both the packer and the loose-sheet fallback use
+    static void cutGrid(float width, float height, int rows, int cols,
+        std::vector<Rectangle> *frames);
+    // Images the sheets are drawn from once the table is loaded: its pages,
+    // then the sheets it does not pack (all of them without a table)
+    static std::vector<std::string> imagePaths(const char *tablePath,
+        const std::vector<SpriteSheet> &sheets);
+
+    // Reads a table from the asset archive or disk
+    static bool readTable(const char *tablePath, AtlasTable *table);
+    static bool writeTable(const char *tablePath, const AtlasTable &table);
+
+    static int getPageCount();
+    static int getSheetCount();
+    static int getLooseSheetCount(); // sheets cut from their own texture
+    static int getFrameCount();
+};
+
+#endif // SPRITE_ATLAS_H
@@ -0,0 +1,194 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+struct BatchedQuad
+{
+    Texture2D texture;
+    Rectangle source;
+    Rectangle destination;
+    Vector2   origin;
+    float     rotation;
+    Color     tint;
+};
+
+// Quads per rlCheckRenderBatchLimit call, well under rlgl's buffer size
+static const int QUADS_PER_CHECK = 256;
+
+static std::vector<BatchedQuad>        gQuads;
+static std::vector<unsigned long long> gSortKeys; // layer | texture id | draw order
+static bool gOpen  = false;
+static int  gLayer = LAYER_MAP;
+
+static int gSpriteCount   = 0;
+static int gDrawCalls     = 0;
+static int gTextureBinds  = 0;
+static int gUnsortedBinds = 0;
+
+void SpriteBatch::begin()
+{
+    // both vectors keep their capacity, so a steady frame never allocates
+    gQuads.clear();
+    gSortKeys.clear();
+    gLayer = LAYER_MAP;
+    gOpen  = true;
+}
+
+bool SpriteBatch::isOpen() { return gOpen; }
+
+void SpriteBatch::setLayer(int layer)
+{
+    gLayer = layer < 0 ? 0 : (layer > 255 ? 255 : layer);
+}
+
+void SpriteBatch::draw(Texture2D texture, Rectangle source,
+    Rectangle destination, Vector2 origin, float rotation, Color tint)
+{
+    if (!gOpen)
+    {
+        DrawTexturePro(texture, source, destination, origin, rotation, tint);
+        return;
+    }
+    if (texture.id == 0) return; // DrawTexturePro skips these too
+
+    BatchedQuad quad = { texture, source, destination, origin, rotation, tint };
+    unsigned long long key =
+        ((unsigned long long) gLayer << 56) |
+        ((unsigned long long) (texture.id & 0xFFFFFF) << 32) |
+        (unsigned long long) gQuads.size();
+
+    gQuads.push_back(quad);
+    gSortKeys.push_back(key);
+}
+
+void SpriteBatch::drawRectangle(Rectangle destination, Color color, int layer)
+{
+    if (!gOpen)
+    {
+        DrawRectangleRec(destination, color);
+        return;
+    }
+
+    Texture2D white = { rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    int previousLayer = gLayer;
+    setLayer(layer);
+    draw(white, { 0.0f, 0.0f, 1.0f, 1.0f }, destination, { 0.0f, 0.0f }, 0.0f, color);
+    gLayer = previousLayer;
+}
+
+/**
+ * The four corners and texture coordinates DrawTexturePro would emit for the
+ * quad, without its rlSetTexture/rlBegin/rlEnd around them.
+ */
+static void emitQuad(const BatchedQuad &quad)
+{
+    Rectangle source = quad.source;
+    Rectangle dest   = quad.destination;
+    float width  = (float) quad.texture.width;
+    float height = (float) quad.texture.height;
+
+    bool flipX = false;
+    if (source.width < 0)  { flipX = true; source.width *= -1; }
+    if (source.height < 0) source.y -= source.height;
+    if (dest.width < 0)  dest.width  *= -1;
+    if (dest.height < 0) dest.height *= -1;
+
+    Vector2 topLeft, topRight, bottomLeft, bottomRight;
+
+    if (quad.rotation == 0.0f)
+    {
+        float x = dest.x - quad.origin.x;
+        float y = dest.y - quad.origin.y;
+        topLeft     = { x, y };
+        topRight    = { x + dest.width, y };
+        bottomLeft  = { x, y + dest.height };
+        bottomRight = { x + dest.width, y + dest.height };
+    }
+    else
+    {
+        float sinRotation = sinf(quad.rotation * DEG2RAD);
+        float cosRotation = cosf(quad.rotation * DEG2RAD);
+        float x  = dest.x;
+        float y  = dest.y;
+        float dx = -quad.origin.x;
+        float dy = -quad.origin.y;
+
+        topLeft.x     = x + dx * cosRotation - dy * sinRotation;
+        topLeft.y     = y + dx * sinRotation + dy * cosRotation;
+        topRight.x    = x + (dx + dest.width) * cosRotation - dy * sinRotation;
+        topRight.y    = y + (dx + dest.width) * sinRotation + dy * cosRotation;
+        bottomLeft.x  = x + dx * cosRotation - (dy + dest.height) * sinRotation;
+        bottomLeft.y  = y + dx * sinRotation + (dy + dest.height) * cosRotation;
+        bottomRight.x = x + (dx + dest.width) * cosRotation - (dy + dest.height) * sinRotation;
+        bottomRight.y = y + (dx + dest.width) * sinRotation + (dy + dest.height) * cosRotation;
+    }
+
+    float left   = source.x / width;
+    float right  = (source.x + source.width) / width;
+    float top    = source.y / height;
+    float bottom = (source.y + source.height) / height;
+    if (flipX) std::swap(left, right);
+
+    rlColor4ub(quad.tint.r, quad.tint.g, quad.tint.b, quad.tint.a);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+
+    rlTexCoord2f(left, top);
+    rlVertex2f(topLeft.x, topLeft.y);
+    rlTexCoord2f(left, bottom);
+    rlVertex2f(bottomLeft.x, bottomLeft.y);
+    rlTexCoord2f(right, bottom);
+    rlVertex2f(bottomRight.x, bottomRight.y);
+    rlTexCoord2f(right, top);
+    rlVertex2f(topRight.x, topRight.y);
+}
+
+void SpriteBatch::end()
+{
+    if (!gOpen) return;
+    gOpen = false;
+
+    gSpriteCount   = (int) gQuads.size();
+    gDrawCalls     = 0;
+    gTextureBinds  = 0;
+    gUnsortedBinds = 0;
+
+    for (size_t i = 0; i < gQuads.size(); i++)
+        if (i == 0 || gQuads[i].texture.id != gQuads[i - 1].texture.id) gUnsortedBinds++;
+
+    std::sort(gSortKeys.begin(), gSortKeys.end());
+
+    unsigned int boundTexture = 0;
+    size_t next = 0;
+    while (next < gSortKeys.size())
+    {
+        // one run: consecutive quads (in sorted order) sharing a texture,
+        // submitted in chunks so rlgl can flush between them if it fills up
+        const Texture2D &texture = gQuads[gSortKeys[next] & 0xFFFFFFFF].texture;
+        size_t runEnd = next;
+        while (runEnd < gSortKeys.size() &&
+               gQuads[gSortKeys[runEnd] & 0xFFFFFFFF].texture.id == texture.id)
+            runEnd++;
+
+        if (texture.id != boundTexture) gTextureBinds++;
+        boundTexture = texture.id;
+        gDrawCalls++;
+
+        while (next < runEnd)
+        {
+            size_t chunkEnd = std::min(runEnd, next + QUADS_PER_CHECK);
+            if (rlCheckRenderBatchLimit(4 * (int) (chunkEnd - next))) gDrawCalls++;
+
+            rlSetTexture(texture.id);
+            rlBegin(RL_QUADS);
+            for (; next < chunkEnd; next++)
+                emitQuad(gQuads[gSortKeys[next] & 0xFFFFFFFF]);
+            rlEnd();
+        }
+    }
+
+    rlSetTexture(0);
+}
+
+int SpriteBatch::getSpriteCount()   { return gSpriteCount;   }
+int SpriteBatch::getDrawCalls()     { return gDrawCalls;     }
+int SpriteBatch::getTextureBinds()  { return gTextureBinds;  }
+int SpriteBatch::getUnsortedBinds() { return gUnsortedBinds; }
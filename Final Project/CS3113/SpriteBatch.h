@@ -0,0 +1,49 @@
+#include "cs3113.h"
+
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+// Paint order of the world pass; sprites on a higher layer always end up on top
+enum SpriteLayer { LAYER_MAP, LAYER_GROUND, LAYER_PLAYER, LAYER_ENTITIES, LAYER_OVERLAY };
+
+/**
+ * Frame-wide sprite batch. Between `begin()` and `end()` every sprite drawn
+ * through `draw()` (Entity::render, Entity::renderWithTint, Map::render) and
+ * every rectangle drawn through `drawRectangle()` is only recorded. `end()` sorts the quads by layer, then texture, and hands
+ * each run that shares a texture to rlgl as one textured quad list, so the
+ * sheet is bound once per run instead of whenever consecutive sprites in the
+ * entity list happen to differ.
+ *
+ * Within a layer, quads with the same texture keep the order they were drawn
+ * in; quads with different textures may swap places, so anything that must
+ * stay on top of something else belongs on a higher layer.
+ *
+ * Outside a batch, `draw()` is plain DrawTexturePro.
+ */
+class SpriteBatch
+{
+public:
+    static void begin();
+    // Sorts and submits everything recorded since begin(); must run while
+    // the camera and shader the sprites were drawn under are still active
+    static void end();
+    static bool isOpen();
+
+    // Layer for the sprites drawn after this call (LAYER_MAP after begin())
+    static void setLayer(int layer);
+
+    // Same arguments and result as DrawTexturePro
+    static void draw(Texture2D texture, Rectangle source, Rectangle destination,
+        Vector2 origin, float rotation, Color tint);
+    // A solid rectangle on the given layer (the current one is kept), drawn
+    // with rlgl's 1x1 white texture; DrawRectangleRec outside a batch
+    static void drawRectangle(Rectangle destination, Color color, int layer);
+
+    // Counters for the last batch that was submitted
+    static int getSpriteCount();
+    static int getDrawCalls();      // quad lists handed to rlgl
+    static int getTextureBinds();   // texture changes between them
+    static int getUnsortedBinds();  // changes the same frame would cost unsorted
+};
+
+#endif // SPRITE_BATCH_H
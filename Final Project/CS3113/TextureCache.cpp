@@ -0,0 +1,159 @@
+#include "TextureCache.h"
+#include "AssetLoader.h"
+#include <cstring>
+#include <unordered_map>
+
+struct CachedTexture
+{
+    std::string path;
+    Texture2D   texture;
+    int         references;
+};
+
+// Keyed by a hash of the path so a lookup from a `const char *` never has to
+// build a std::string (and therefore never allocates on a cache hit).
+static std::unordered_map<unsigned long long, CachedTexture> gCachedTextures;
+static std::unordered_map<unsigned int, unsigned long long>  gKeysByTextureID;
+
+static int    gCacheHits     = 0;
+static int    gCacheMisses   = 0;
+static size_t gResidentBytes = 0;
+
+/**
+ * @brief 64-bit FNV-1a hash of a null-terminated string.
+ */
+static unsigned long long hashPath(const char *path)
+{
+    unsigned long long hash = 1469598103934665603ULL;
+
+    for (const char *c = path; *c != '\0'; c++)
+    {
+        hash ^= (unsigned char) *c;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static size_t textureBytes(const Texture2D &texture)
+{
+    return (size_t) GetPixelDataSize(texture.width, texture.height, texture.format);
+}
+
+/**
+ * @brief LoadTexture, except that a prefetched image is uploaded from memory
+ * instead of being decoded again, and anything else is decoded from the
+ * asset archive when it holds the file.
+ */
+static Texture2D loadTexture(const char *textureFilepath)
+{
+    Image image;
+    if (!AssetLoader::takeImage(textureFilepath, &image)) image = loadImage(textureFilepath);
+
+    Texture2D texture = { 0 }; // like LoadTexture, empty if the decode failed
+    if (image.data != nullptr) texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    return texture;
+}
+
+static void cacheTexture(const char *textureFilepath, unsigned long long key,
+    Texture2D texture, int references)
+{
+    CachedTexture entry = { textureFilepath, texture, references };
+    gCachedTextures[key] = entry;
+    gKeysByTextureID[texture.id] = key;
+    gResidentBytes += textureBytes(texture);
+}
+
+Texture2D TextureCache::acquire(const char *textureFilepath)
+{
+    // no window means no GL context to upload to (headless runs)
+    if (textureFilepath == nullptr || textureFilepath[0] == '\0' || !IsWindowReady())
+    {
+        Texture2D empty = { 0 }; // same as a failed load, minus the disk probe
+        return empty;
+    }
+
+    unsigned long long key = hashPath(textureFilepath);
+
+    auto found = gCachedTextures.find(key);
+    if (found != gCachedTextures.end())
+    {
+        // Two different paths landing on one hash: hand out a private copy
+        // that `release` will recognise as uncached and unload on its own.
+        if (strcmp(found->second.path.c_str(), textureFilepath) != 0)
+        {
+            gCacheMisses++;
+            return loadTexture(textureFilepath);
+        }
+
+        gCacheHits++;
+        found->second.references++;
+        return found->second.texture;
+    }
+
+    gCacheMisses++;
+    Texture2D texture = loadTexture(textureFilepath);
+    if (texture.id == 0) return texture; // nothing worth caching
+
+    cacheTexture(textureFilepath, key, texture, 1);
+    return texture;
+}
+
+void TextureCache::release(Texture2D texture)
+{
+    if (texture.id == 0) return;
+
+    auto key = gKeysByTextureID.find(texture.id);
+    if (key == gKeysByTextureID.end())
+    {
+        UnloadTexture(texture);
+        return;
+    }
+
+    CachedTexture &entry = gCachedTextures[key->second];
+    if (entry.references > 0) entry.references--;
+}
+
+void TextureCache::purge()
+{
+    for (auto it = gCachedTextures.begin(); it != gCachedTextures.end();)
+    {
+        if (it->second.references > 0)
+        {
+            ++it;
+            continue;
+        }
+
+        gResidentBytes -= textureBytes(it->second.texture);
+        gKeysByTextureID.erase(it->second.texture.id);
+        UnloadTexture(it->second.texture);
+        it = gCachedTextures.erase(it);
+    }
+}
+
+bool TextureCache::isCached(const char *textureFilepath)
+{
+    auto found = gCachedTextures.find(hashPath(textureFilepath));
+    return found != gCachedTextures.end() &&
+           strcmp(found->second.path.c_str(), textureFilepath) == 0;
+}
+
+void TextureCache::insert(const char *textureFilepath, Texture2D texture)
+{
+    if (texture.id == 0) return;
+
+    unsigned long long key = hashPath(textureFilepath);
+    if (gCachedTextures.count(key))
+    {
+        UnloadTexture(texture); // resident already, or a hash collision
+        return;
+    }
+
+    cacheTexture(textureFilepath, key, texture, 0);
+}
+
+int    TextureCache::getHits()            { return gCacheHits;                   }
+int    TextureCache::getMisses()          { return gCacheMisses;                 }
+int    TextureCache::getTextureCount()    { return (int) gCachedTextures.size(); }
+size_t TextureCache::getResidentBytes()   { return gResidentBytes;               }
@@ -0,0 +1,34 @@
+#include "cs3113.h"
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+/**
+ * Process-wide cache of GPU textures keyed by file path. Every entity that
+ * asks for the same sheet shares one upload; the texture stays resident while
+ * anything references it and until `purge()` is called after it drops to zero,
+ * so re-spawning a projectile never touches the disk or the GPU.
+ */
+class TextureCache
+{
+public:
+    // Returns the shared texture for the path, loading it on first use.
+    static Texture2D acquire(const char *textureFilepath);
+    // Drops one reference. Unknown (uncached) textures are unloaded directly.
+    static void release(Texture2D texture);
+    // Unloads every texture nobody references any more.
+    static void purge();
+
+    // Whether the path is resident (a hit for the next acquire).
+    static bool isCached(const char *textureFilepath);
+    // Caches a texture uploaded elsewhere (AssetLoader) under its path with
+    // no references, so it stays until the next purge unless acquired.
+    static void insert(const char *textureFilepath, Texture2D texture);
+
+    static int    getHits();
+    static int    getMisses();
+    static int    getTextureCount();
+    static size_t getResidentBytes();
+};
+
+#endif // TEXTURE_CACHE_H
@@ -0,0 +1,174 @@
+#include "VoicePool.h"
+
+struct PooledSound
+{
+    bool   loaded;
+    Sound  source;               // owns the samples; voice 0 plays it directly
+    std::vector<Sound>  voices;  // source, then its aliases
+    std::vector<double> started; // when each voice last started
+    double lastPlay;
+    VoiceSettings settings;
+};
+
+static std::vector<PooledSound> gSounds;
+
+static int gPlayCount    = 0;
+static int gDroppedCount = 0;
+static int gStolenCount  = 0;
+
+static bool isValid(int sound)
+{
+    return sound >= 0 && sound < (int) gSounds.size() && gSounds[sound].loaded;
+}
+
+int VoicePool::load(const char *filePath, VoiceSettings settings)
+{
+    if (settings.maxVoices < 1) settings.maxVoices = 1;
+
+    PooledSound pooled = { true, loadSound(filePath), {}, {}, -1e9, settings };
+
+    // no audio device (or no such file): an ID with no voices
+    if (pooled.source.frameCount > 0)
+    {
+        pooled.voices.push_back(pooled.source);
+        for (int i = 1; i < settings.maxVoices; i++)
+            pooled.voices.push_back(LoadSoundAlias(pooled.source));
+
+        for (const Sound &voice : pooled.voices) SetSoundVolume(voice, settings.volume);
+        pooled.started.assign(pooled.voices.size(), 0.0);
+    }
+
+    for (size_t sound = 0; sound < gSounds.size(); sound++)
+    {
+        if (gSounds[sound].loaded) continue;
+        gSounds[sound] = pooled;
+        return (int) sound;
+    }
+
+    gSounds.push_back(pooled);
+    return (int) gSounds.size() - 1;
+}
+
+void VoicePool::unload(int sound)
+{
+    if (!isValid(sound)) return;
+
+    PooledSound &pooled = gSounds[sound];
+    for (size_t voice = 0; voice < pooled.voices.size(); voice++)
+    {
+        StopSound(pooled.voices[voice]);
+        if (voice > 0) UnloadSoundAlias(pooled.voices[voice]);
+    }
+    if (pooled.source.frameCount > 0) UnloadSound(pooled.source);
+
+    pooled.loaded = false;
+    pooled.voices.clear();
+    pooled.started.clear();
+}
+
+// The playing voice to cut short for a request of `priority`: the oldest one
+// of the lowest priority below it, or none (-1 in `sound`)
+static void findVictim(int priority, int *sound, int *voice)
+{
+    *sound = -1;
+    *voice = -1;
+    int    lowest = priority;
+    double oldest = 0.0;
+
+    for (int candidate = 0; candidate < (int) gSounds.size(); candidate++)
+    {
+        const PooledSound &pooled = gSounds[candidate];
+        int candidatePriority = pooled.settings.priority;
+        if (!pooled.loaded || candidatePriority >= priority) continue;
+
+        for (int i = 0; i < (int) pooled.voices.size(); i++)
+        {
+            if (!IsSoundPlaying(pooled.voices[i])) continue;
+
+            if (*sound < 0 || candidatePriority < lowest ||
+                (candidatePriority == lowest && pooled.started[i] < oldest))
+            {
+                *sound = candidate;
+                *voice = i;
+                lowest = candidatePriority;
+                oldest = pooled.started[i];
+            }
+        }
+    }
+}
+
+bool VoicePool::play(int sound)
+{
+    if (!isValid(sound) || gSounds[sound].voices.empty()) return false;
+
+    PooledSound &pooled = gSounds[sound];
+    double now = GetTime();
+
+    if (now - pooled.lastPlay < pooled.settings.cooldown)
+    {
+        gDroppedCount++;
+        return false;
+    }
+
+    int voice = -1;
+    for (int i = 0; i < (int) pooled.voices.size() && voice < 0; i++)
+        if (!IsSoundPlaying(pooled.voices[i])) voice = i;
+
+    if (voice < 0)
+    {
+        // all busy: restart the oldest, which keeps the total the same
+        voice = 0;
+        for (int i = 1; i < (int) pooled.voices.size(); i++)
+            if (pooled.started[i] < pooled.started[voice]) voice = i;
+        gStolenCount++;
+    }
+    else if (getActiveVoices() >= MAX_ACTIVE_VOICES)
+    {
+        int victimSound, victimVoice;
+        findVictim(pooled.settings.priority, &victimSound, &victimVoice);
+        if (victimSound < 0)
+        {
+            gDroppedCount++;
+            return false;
+        }
+
+        StopSound(gSounds[victimSound].voices[victimVoice]);
+        gStolenCount++;
+    }
+
+    PlaySound(pooled.voices[voice]);
+    pooled.started[voice] = now;
+    pooled.lastPlay = now;
+    gPlayCount++;
+    return true;
+}
+
+void VoicePool::stop(int sound)
+{
+    if (!isValid(sound)) return;
+    for (const Sound &voice : gSounds[sound].voices) StopSound(voice);
+}
+
+int VoicePool::getActiveVoices(int sound)
+{
+    if (!isValid(sound)) return 0;
+
+    int active = 0;
+    for (const Sound &voice : gSounds[sound].voices)
+        if (IsSoundPlaying(voice)) active++;
+
+    return active;
+}
+
+int VoicePool::getActiveVoices()
+{
+    int active = 0;
+    for (int sound = 0; sound < (int) gSounds.size(); sound++)
+        active += getActiveVoices(sound);
+
+    return active;
+}
+
+int VoicePool::getPlayCount()    { return gPlayCount;    }
+int VoicePool::getDroppedCount() { return gDroppedCount; }
+int VoicePool::getStolenCount()  { return gStolenCount;  }
@@ -0,0 +1,56 @@
+#include "cs3113.h"
+
+#ifndef VOICE_POOL_H
+#define VOICE_POOL_H
+
+// Which voices give way when the mixer is full: a play request may take over
+// a voice of a strictly lower priority, never one of its own or a higher one
+enum SoundPriority { PRIORITY_LOW, PRIORITY_NORMAL, PRIORITY_HIGH, PRIORITY_CRITICAL };
+
+struct VoiceSettings
+{
+    int   maxVoices; // copies of the sound that may play at once
+    float cooldown;  // seconds after a play during which new plays are dropped
+    int   priority;  // SoundPriority
+    float volume;
+};
+
+/**
+ * Sound effects played through a fixed set of voices. `load` decodes the
+ * file once and makes `maxVoices` raylib sound aliases of it, which share the
+ * samples but play independently, so overlapping shots are heard as separate
+ * shots instead of one buffer being rewound each time.
+ *
+ * `play` is cheap to call as often as gameplay likes (once per overlapping
+ * enemy per tick, say): a request inside the sound's cooldown is dropped, a
+ * sound with every voice busy restarts its oldest one, and once
+ * MAX_ACTIVE_VOICES are playing in total a request either takes over the
+ * oldest voice of the lowest priority below its own or is dropped.
+ *
+ * Without an audio device (headless runs) `load` still hands out an ID, and
+ * playing it does nothing.
+ */
+class VoicePool
+{
+public:
+    static constexpr int NO_SOUND          = -1;
+    static constexpr int MAX_ACTIVE_VOICES = 16;
+
+    // Loads the file through loadSound (so prefetched waves and the asset
+    // archive are used) with its voices at the given volume
+    static int  load(const char *filePath, VoiceSettings settings);
+    // Stops and frees the sound's voices; the ID may be handed out again
+    static void unload(int sound);
+
+    // True if a voice started (or restarted) playing the sound
+    static bool play(int sound);
+    static void stop(int sound);
+
+    static int getActiveVoices();          // playing across every sound
+    static int getActiveVoices(int sound);
+    static int getPlayCount();             // plays that got a voice
+    static int getDroppedCount();          // cooldown or no voice free
+    static int getStolenCount();           // voices cut short by another play
+};
+
+#endif // VOICE_POOL_H
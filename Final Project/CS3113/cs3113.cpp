@@ -1,4 +1,5 @@
 #include "cs3113.h"
+#include "AssetLoader.h"
 
 Color ColorFromHex(const char *hex)
 {
@@ -60,47 +61,6 @@ void Normalise(Vector2 *vector)
     vector->y /= magnitude;
 }
 
-/**
- * @brief Calculates and returns the UV coordinates and dimensions of a 
- * rectangle slice from a texture based on the given index, number of rows, and
- * number of columns.
- * 
- * @param texture a pointer to a `Texture2D` struct, contains information about
- * a 2D texture such as its width and height.
- * @param index represents the index of the specific slice within a texture 
- * atlas. Each slice is a sub-image within the texture atlas that contains 
- * multiple images arranged in rows and columns.
- * @param rows represents the number of rows in which the texture is divided.
- * This parameter is used to calculate the vertical position of the texture 
- * slice based on the index provided.
- * @param cols represents the number of columns in a grid layout. It is used in
- * the `getUVRectangle` function to calculate the UV coordinates for a specific
- * index within the grid.
- * 
- * @return a `Rectangle` struct that represents a portion of a texture based on
- * the provided parameters. The `Rectangle` struct contains the top-left 
- * x-coordinate, top-left y-coordinate, width, and height of the specified
- * portion of the texture.
- */
-Rectangle getUVRectangle(const Texture2D *texture, int index, int rows, int cols)
-{
-    float uCoord = (float) (index % cols) / (float) cols;
-    uCoord *= texture->width;
-
-    float vCoord = (float) (index / cols) / (float) rows;
-    vCoord *= texture->height;
-
-    float sliceWidth  = texture->width  / (float) cols;
-    float sliceHeight = texture->height / (float) rows;
-
-    return { 
-        uCoord,     // top-left x-coord
-        vCoord,     // top-left y-coord
-        sliceWidth, // width of slice
-        sliceHeight // height of slice
-    };
-}
-
 /**
  * The function `panCamera` smoothly adjusts the camera's target position towards a specified target
  * position.
@@ -121,4 +81,167 @@ void panCamera(Camera2D *camera, const Vector2 *targetPosition)
         camera->target, 
         Vector2Scale(positionDifference, 0.1f)
     ); // 0.1 = smoothing factor
+}
+
+/**
+ * The function `getVisibleArea` returns the part of the world the camera
+ * currently shows on screen.
+ * 
+ * @param camera The `camera` parameter is a pointer to the `Camera2D` the
+ * world is drawn with; its offset, target, zoom and rotation are all taken
+ * into account.
+ * @return The world-space bounding rectangle of the four screen corners.
+ */
+Rectangle getVisibleArea(const Camera2D *camera)
+{
+    float screenWidth  = (float) GetScreenWidth();
+    float screenHeight = (float) GetScreenHeight();
+
+    Vector2 corners[4] = {
+        GetScreenToWorld2D({ 0.0f,        0.0f         }, *camera),
+        GetScreenToWorld2D({ screenWidth, 0.0f         }, *camera),
+        GetScreenToWorld2D({ 0.0f,        screenHeight }, *camera),
+        GetScreenToWorld2D({ screenWidth, screenHeight }, *camera)
+    };
+
+    Vector2 minimum = corners[0];
+    Vector2 maximum = corners[0];
+    for (int i = 1; i < 4; i++)
+    {
+        minimum = { fminf(minimum.x, corners[i].x), fminf(minimum.y, corners[i].y) };
+        maximum = { fmaxf(maximum.x, corners[i].x), fmaxf(maximum.y, corners[i].y) };
+    }
+
+    return { minimum.x, minimum.y, maximum.x - minimum.x, maximum.y - minimum.y };
+}
+
+/**
+ * The function `rectanglesOverlap` checks whether two axis-aligned rectangles
+ * share any area.
+ */
+bool rectanglesOverlap(Rectangle a, Rectangle b)
+{
+    return a.x < b.x + b.width  && b.x < a.x + a.width &&
+           a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+/**
+ * The function `intersectSegmentBox` clips the segment from `from` to
+ * `from + delta` against an axis-aligned box, one axis (slab) at a time.
+ * Moving a box of half-size h along the segment hits whatever the segment
+ * hits once that is grown by h on every side, which is how the swept
+ * collision queries use it.
+ * 
+ * @param entry The `entry` parameter receives the fraction of `delta` at
+ * which the segment enters the box (negative if `from` is already inside).
+ * @param exit The `exit` parameter receives the fraction at which it leaves.
+ * @return Whether the segment passes through the box's interior; merely
+ * sliding along an edge does not count.
+ */
+bool intersectSegmentBox(Vector2 from, Vector2 delta, Rectangle box,
+    float *entry, float *exit)
+{
+    float start[2] = { from.x, from.y };
+    float step[2]  = { delta.x, delta.y };
+    float low[2]   = { box.x, box.y };
+    float high[2]  = { box.x + box.width, box.y + box.height };
+
+    float first = -INFINITY;
+    float last  = INFINITY;
+
+    for (int axis = 0; axis < 2; axis++)
+    {
+        if (step[axis] == 0.0f)
+        {
+            // parallel to this slab: inside it for the whole segment or never
+            if (start[axis] <= low[axis] || start[axis] >= high[axis]) return false;
+            continue;
+        }
+
+        float near = (low[axis]  - start[axis]) / step[axis];
+        float far  = (high[axis] - start[axis]) / step[axis];
+        if (near > far) std::swap(near, far);
+
+        first = fmaxf(first, near);
+        last  = fminf(last, far);
+    }
+
+    *entry = first;
+    *exit  = last;
+    return first < last && last > 0.0f && first <= 1.0f;
+}
+
+static AssetPack gAssetPack;
+
+/**
+ * The functions `openAssetPack` and `closeAssetPack` map and unmap the asset
+ * archive that `loadImage`, `loadWave` and `loadSound` read from. Any path
+ * the archive does not hold (or every path, with no archive open) is loaded
+ * from the loose file instead. Close it only after MusicPlayer has stopped:
+ * its decoder thread may still be reading a track from the mapping.
+ * 
+ * @param filePath The `filePath` parameter is the path of the archive.
+ */
+bool openAssetPack(const char *filePath)
+{
+    return gAssetPack.open(filePath);
+}
+
+void closeAssetPack()
+{
+    gAssetPack.close();
+}
+
+const AssetPack &getAssetPack()
+{
+    return gAssetPack;
+}
+
+/**
+ * The functions `loadImage` and `loadWave` are `LoadImage` and `LoadWave`,
+ * except that a file in the asset archive is decoded straight from the
+ * mapping. Both are safe to call from worker threads.
+ * 
+ * @param filePath The `filePath` parameter is the path of the file.
+ */
+Image loadImage(const char *filePath)
+{
+    const unsigned char *data;
+    size_t size;
+    if (!gAssetPack.find(filePath, &data, &size)) return LoadImage(filePath);
+
+    return LoadImageFromMemory(GetFileExtension(filePath), data, (int) size);
+}
+
+Wave loadWave(const char *filePath)
+{
+    const unsigned char *data;
+    size_t size;
+    if (!gAssetPack.find(filePath, &data, &size)) return LoadWave(filePath);
+
+    return LoadWaveFromMemory(GetFileExtension(filePath), data, (int) size);
+}
+
+/**
+ * The function `loadSound` is `LoadSound` for scenes, except that without an
+ * audio device (a headless run) it returns an empty sound instead of
+ * loading. raylib's play and unload calls all accept the empty value, so a
+ * scene can use it exactly as if it had loaded. A sound the AssetLoader
+ * prefetched is built from its already decoded wave; anything else comes
+ * from the asset archive when it holds the file.
+ * 
+ * @param filePath The `filePath` parameter is the path of the audio file.
+ */
+Sound loadSound(const char *filePath)
+{
+    Sound sound = { 0 };
+    if (!IsAudioDeviceReady()) return sound;
+
+    Wave wave;
+    if (AssetLoader::findWave(filePath, &wave)) return LoadSoundFromWave(wave);
+
+    wave = loadWave(filePath);
+    sound = LoadSoundFromWave(wave);
+    UnloadWave(wave);
+    return sound;
 }
\ No newline at end of file
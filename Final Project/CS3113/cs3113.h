@@ -5,6 +5,7 @@
 #include "raylib.h"
 #include "rlgl.h"
 #include "raymath.h"
+#include "AssetPack.h"
 #include <math.h>
 #include <time.h>
 #include <stdio.h>
@@ -19,8 +20,17 @@ enum TextureType { SINGLE, ATLAS       };
 Color ColorFromHex(const char *hex);
 void Normalise(Vector2 *vector);
 float GetLength(const Vector2 vector);
-Rectangle getUVRectangle(const Texture2D *texture, int index, int rows, int cols);
 void panCamera(Camera2D *camera, const Vector2 *targetPosition);
+Rectangle getVisibleArea(const Camera2D *camera);
+bool rectanglesOverlap(Rectangle a, Rectangle b);
+bool intersectSegmentBox(Vector2 from, Vector2 delta, Rectangle box,
+    float *entry, float *exit);
+bool openAssetPack(const char *filePath);
+void closeAssetPack();
+const AssetPack &getAssetPack();
+Image loadImage(const char *filePath);
+Wave loadWave(const char *filePath);
+Sound loadSound(const char *filePath);
 
 
 #endif // CS3113_H
\ No newline at end of file
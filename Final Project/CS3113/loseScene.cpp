@@ -17,7 +17,7 @@ void LoseScene::initialise()
 void LoseScene::update(float deltaTime)
 {
    // Press R to restart game (jump to scene -2, handled by main.cpp)
-   if (IsKeyPressed(KEY_R))
+   if (Input::isKeyPressed(KEY_R))
    {
       // Use special value -2 to restart game
       mGameState.nextSceneID = -2;
@@ -16,7 +16,7 @@ void WonScene::initialise()
 
 void WonScene::update(float deltaTime)
 {
-   if (IsKeyPressed(KEY_R)) mGameState.nextSceneID = 3;
+   if (Input::isKeyPressed(KEY_R)) mGameState.nextSceneID = 3;
 }
 
 void WonScene::render()
@@ -0,0 +1,165 @@
+/**
+* Micro-benchmark for the per-tick kill-EXP and arrow-pierce bookkeeping.
+*
+* "side sets" reproduces the old scheme: a std::set of enemies that already
+* paid out EXP and a std::map of arrow -> pierce left, each swept every tick by
+* looking every element up in the collidable list (O(n*m)). "flags" keeps the
+* same state on the entities themselves (Entity::isExpAwarded and
+* Entity::getPierceRemaining), so there is no per-tick pass at all.
+*
+* Both paths then score the same fixed number of hits per tick (kills checked
+* for EXP, arrows spending a pierce), so with flags the tick should cost the
+* same however many enemies and arrows are alive. A tenth of the enemies are
+* dead and waiting for the cleanup sweep, as they are in a busy level.
+*
+* Build and run with `make bench`.
+**/
+
+#include "../CS3113/Entity.h"
+#include <chrono>
+#include <cstdio>
+#include <set>
+
+static const int TICKS = 200;
+static const int HITS_PER_TICK = 64; // of each kind
+
+struct World
+{
+    std::vector<Entity*> collidables; // enemies followed by arrows
+    std::vector<Entity*> deadEnemies;
+    std::vector<Entity*> arrows;
+};
+
+static World makeWorld(int enemyCount, int arrowCount)
+{
+    World world;
+
+    for (int i = 0; i < enemyCount; i++)
+    {
+        Entity *enemy = new Entity();
+        enemy->setEntityType(NPC);
+        if (i % 10 == 0)
+        {
+            enemy->setCurrentHP(0);
+            world.deadEnemies.push_back(enemy);
+        }
+        world.collidables.push_back(enemy);
+    }
+
+    for (int i = 0; i < arrowCount; i++)
+    {
+        Entity *arrow = new Entity();
+        arrow->setEntityType(EFFECT);
+        world.arrows.push_back(arrow);
+        world.collidables.push_back(arrow);
+    }
+
+    return world;
+}
+
+static bool inList(const std::vector<Entity*> &list, Entity *entity)
+{
+    for (Entity *e : list) if (e == entity) return true;
+    return false;
+}
+
+static double tickSideSets(World &world, int tick, std::set<Entity*> &expGiven,
+    std::map<Entity*, int> &pierce, int &expTotal)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // the two cleanup passes LevelA/B/C used to run every update
+    for (auto it = expGiven.begin(); it != expGiven.end();)
+    {
+        if (!inList(world.collidables, *it)) it = expGiven.erase(it);
+        else ++it;
+    }
+    for (auto it = pierce.begin(); it != pierce.end();)
+    {
+        if (!inList(world.collidables, it->first)) it = pierce.erase(it);
+        else ++it;
+    }
+
+    for (int hit = 0; hit < HITS_PER_TICK; hit++)
+    {
+        Entity *enemy = world.deadEnemies[(tick * HITS_PER_TICK + hit) % world.deadEnemies.size()];
+        if (expGiven.find(enemy) == expGiven.end())
+        {
+            expGiven.insert(enemy);
+            expTotal++;
+        }
+
+        Entity *arrow = world.arrows[(tick * HITS_PER_TICK + hit) % world.arrows.size()];
+        auto found = pierce.find(arrow);
+        if (found != pierce.end() && --found->second <= 0) found->second = 1000000;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+static double tickFlags(World &world, int tick, int &expTotal)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (int hit = 0; hit < HITS_PER_TICK; hit++)
+    {
+        Entity *enemy = world.deadEnemies[(tick * HITS_PER_TICK + hit) % world.deadEnemies.size()];
+        if (!enemy->isExpAwarded())
+        {
+            enemy->markExpAwarded();
+            expTotal++;
+        }
+
+        Entity *arrow = world.arrows[(tick * HITS_PER_TICK + hit) % world.arrows.size()];
+        arrow->setPierceRemaining(arrow->getPierceRemaining() - 1);
+        if (arrow->getPierceRemaining() <= 0) arrow->setPierceRemaining(1000000);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+int main()
+{
+    const int enemyCounts[] = { 100, 1000, 2000, 3000 };
+    const int arrowCounts[] = { 10, 100, 200, 300 };
+
+    printf("%8s %7s %15s %12s %9s\n", "enemies", "arrows", "side sets us",
+        "flags us", "speedup");
+
+    for (int row = 0; row < 4; row++)
+    {
+        World world = makeWorld(enemyCounts[row], arrowCounts[row]);
+
+        std::set<Entity*> expGiven;
+        std::map<Entity*, int> pierce;
+        for (Entity *arrow : world.arrows)
+        {
+            pierce[arrow] = 1000000;
+            arrow->setPierceRemaining(1000000);
+        }
+
+        int expSideSets = 0, expFlags = 0;
+        double sideSets = 0.0, flags = 0.0;
+
+        for (int t = 0; t < TICKS; t++)
+        {
+            sideSets += tickSideSets(world, t, expGiven, pierce, expSideSets);
+            flags    += tickFlags(world, t, expFlags);
+        }
+
+        sideSets /= TICKS;
+        flags    /= TICKS;
+
+        // both schemes must pay out each kill exactly once
+        if (expSideSets != expFlags) printf("EXP mismatch: %d vs %d\n", expSideSets, expFlags);
+
+        printf("%8d %7d %15.2f %12.2f %8.1fx\n", enemyCounts[row], arrowCounts[row],
+            sideSets, flags, flags > 0.0 ? sideSets / flags : 0.0);
+
+        for (Entity *entity : world.collidables) delete entity;
+    }
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+* Micro-benchmark for one simulation tick of Entity::update over N enemies.
+*
+* "by value" reproduces the old signatures, where update() and both
+* checkCollision passes took the collidable vector by value (three O(n) copies
+* per entity, O(n^2) allocations and copies per tick). "by view" passes the
+* whole list as an EntityView. "grid" builds the SpatialHash broadphase once
+* and hands each entity only its neighbours, as LevelC does.
+*
+* No window is opened; textures are never loaded.
+*
+* Build and run with `make bench`.
+**/
+
+#include "../CS3113/SpatialHash.h"
+#include <chrono>
+#include <cstdio>
+
+static const float TICK = 1.0f / 60.0f;
+static const float TILE_DIMENSION = 25.0f;
+
+// put everyone back on the lattice so every path measures the same spread-out
+// crowd instead of the pile the followers form around the player
+static void resetPositions(std::vector<Entity*> &enemies)
+{
+    int side = 1;
+    while (side * side < (int) enemies.size()) side++;
+
+    for (size_t i = 0; i < enemies.size(); i++)
+        enemies[i]->setPosition({ (i % side) * 35.0f, (i / side) * 35.0f });
+}
+
+static std::vector<Entity*> makeEnemies(int count)
+{
+    std::vector<Entity*> enemies;
+    enemies.reserve(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        Entity *enemy = new Entity();
+        enemy->setEntityType(NPC);
+        enemy->setAIType(FOLLOWER);
+        enemy->setSpeed(40);
+        enemy->setSpawnInvincible(0.0f);
+        enemy->setScale({ 30.0f, 30.0f });
+        enemy->setColliderDimensions({ 20.0f, 20.0f });
+        enemies.push_back(enemy);
+    }
+
+    // spread over a square arena so the per-pair test mostly misses, the
+    // same as a crowded level
+    resetPositions(enemies);
+
+    return enemies;
+}
+
+static double tickByValue(std::vector<Entity*> &enemies, Entity *player)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (Entity *enemy : enemies)
+    {
+        std::vector<Entity*> updateArgument = enemies;        // update(..., vector)
+        std::vector<Entity*> collisionYArgument = updateArgument; // checkCollisionY(vector)
+        std::vector<Entity*> collisionXArgument = updateArgument; // checkCollisionX(vector)
+        enemy->update(TICK, player, nullptr, collisionXArgument);
+        (void) collisionYArgument;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+static double tickByView(std::vector<Entity*> &enemies, Entity *player)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (Entity *enemy : enemies) 
+        enemy->update(TICK, player, nullptr, enemies);
+
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+static double tickByGrid(std::vector<Entity*> &enemies, Entity *player,
+    SpatialHash &grid, std::vector<Entity*> &candidates)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    grid.build(enemies, TICK);
+    for (Entity *enemy : enemies)
+    {
+        grid.queryMovement(enemy, TICK, candidates);
+        enemy->update(TICK, player, nullptr, candidates);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+int main()
+{
+    const int counts[] = { 100, 1000, 10000 };
+
+    Entity player;
+    player.setEntityType(PLAYER);
+    player.setPosition({ 0.0f, 0.0f });
+
+    SpatialHash grid(TILE_DIMENSION);
+    std::vector<Entity*> candidates;
+
+    printf("%8s %6s %12s %12s %12s %9s\n", "entities", "ticks", "by value us",
+        "by view us", "grid us", "speedup");
+
+    for (int count : counts)
+    {
+        // keep the total work per row roughly constant (the full scans are O(n^2))
+        int ticks = count >= 10000 ? 1 : count >= 1000 ? 40 : 2000;
+
+        std::vector<Entity*> enemies = makeEnemies(count);
+        double byValue = 0.0, byView = 0.0, byGrid = 0.0;
+
+        // interleave so every path sees the same entity layout and cache state
+        for (int t = 0; t < ticks; t++)
+        {
+            resetPositions(enemies);
+            byValue += tickByValue(enemies, &player);
+            resetPositions(enemies);
+            byView  += tickByView(enemies, &player);
+            resetPositions(enemies);
+            byGrid  += tickByGrid(enemies, &player, grid, candidates);
+        }
+
+        byValue /= ticks;
+        byView  /= ticks;
+        byGrid  /= ticks;
+
+        // speedup of the grid over the original by-value path
+        printf("%8d %6d %12.1f %12.1f %12.1f %8.1fx\n", count, ticks, byValue,
+            byView, byGrid, byGrid > 0.0 ? byValue / byGrid : 0.0);
+
+        for (Entity *enemy : enemies) delete enemy;
+    }
+
+    return 0;
+}
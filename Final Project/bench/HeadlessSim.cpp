@@ -0,0 +1,223 @@
+/**
+* Headless simulation harness.
+*
+* Runs Level A, B or C with no window and no audio device: textures and
+* sounds come back empty (TextureCache and loadSound skip the load, and
+* MusicPlayer never starts), input comes from a script through Input, and
+* every level gets the same seed through Scene::setSeed, so the same
+* arguments replay the same run (the final checksum must match). The level
+* is stepped at a fixed rate as fast as the CPU allows for the requested
+* number of simulated minutes, restarting it whenever it ends (win, loss or
+* skip), and the run is summarised as ticks per second, tick-time
+* percentiles and entity counts.
+*
+* The script walks the player in a slow square and picks level-up options in
+* turn. The player is kept alive unless --mortal is given, so long runs keep
+* scaling up the horde instead of stopping at the first death.
+*
+* Usage: headless_sim [--level A|B|C] [--minutes N] [--seed N] [--rate HZ]
+*                     [--mortal]
+* Build and run with `make sim` (Level C, 2 minutes).
+**/
+
+#include "../CS3113/LevelA.h"
+#include "../CS3113/LevelB.h"
+#include "../CS3113/LevelC.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const Vector2 ORIGIN = { 800.0f, 400.0f };
+
+struct Options
+{
+    char         level   = 'C';
+    float        minutes = 2.0f;
+    uint64_t     seed    = 42;
+    int          rate    = 60;
+    bool         mortal  = false;
+};
+
+static bool parseOptions(int argc, char **argv, Options *options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (strcmp(argv[i], "--mortal") == 0) { options->mortal = true; continue; }
+        if (value == nullptr) return false;
+
+        if      (strcmp(argv[i], "--level")   == 0) options->level   = value[0];
+        else if (strcmp(argv[i], "--minutes") == 0) options->minutes = (float) atof(value);
+        else if (strcmp(argv[i], "--seed")    == 0) options->seed    = strtoull(value, nullptr, 10);
+        else if (strcmp(argv[i], "--rate")    == 0) options->rate    = atoi(value);
+        else return false;
+        i++;
+    }
+
+    return (options->level == 'A' || options->level == 'B' || options->level == 'C') &&
+           options->minutes > 0.0f && options->rate > 0;
+}
+
+static Scene *makeLevel(char level, uint64_t seed)
+{
+    Scene *scene;
+    switch (level)
+    {
+        case 'A': scene = new LevelA(ORIGIN, "#000000"); break;
+        case 'B': scene = new LevelB(ORIGIN, "#000000"); break;
+        default:  scene = new LevelC(ORIGIN, "#000000"); break;
+    }
+
+    scene->setSeed(seed);
+    scene->initialise();
+    return scene;
+}
+
+// One second on each side of a square, then a level-up choice every quarter
+// second (the number keys do nothing while no menu is open)
+static void scriptInput(long long tick, int rate)
+{
+    static const int SIDES[4][2] = { { KEY_D, KEY_S }, { KEY_S, KEY_A },
+                                     { KEY_A, KEY_W }, { KEY_W, KEY_D } };
+    const int side = (int) (tick / rate) % 4;
+
+    for (int key : { KEY_W, KEY_A, KEY_S, KEY_D }) Input::holdKey(key, false);
+    Input::holdKey(SIDES[side][0], true);
+    if ((tick / (rate / 2)) % 2) Input::holdKey(SIDES[side][1], true);
+
+    if (tick % (rate / 4 > 0 ? rate / 4 : 1) == 0)
+        Input::pressKey(KEY_ONE + (int) (tick / rate) % 3);
+}
+
+// What main's processInput does with the movement keys
+static void applyMovementKeys(Entity *player)
+{
+    player->resetMovement();
+
+    if (Input::isKeyDown(KEY_A)) player->moveLeft();
+    if (Input::isKeyDown(KEY_D)) player->moveRight();
+    if (Input::isKeyDown(KEY_W)) player->moveUp();
+    if (Input::isKeyDown(KEY_S)) player->moveDown();
+
+    if (GetLength(player->getMovement()) > 1.0f) player->normaliseMovement();
+}
+
+// FNV-1a over every live position, to compare two runs of the same seed
+static unsigned long long stateChecksum()
+{
+    unsigned long long hash = 1469598103934665603ULL;
+
+    for (int slot = 0; slot < EntityStore::getCapacity(); slot++)
+    {
+        if (!(EntityStore::flags[slot] & EntityStore::IN_USE)) continue;
+
+        const unsigned char *bytes = (const unsigned char *) &EntityStore::positions[slot];
+        for (size_t i = 0; i < sizeof(Vector2); i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+static double percentile(std::vector<float> &values, double fraction)
+{
+    size_t index = (size_t) (fraction * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, &options))
+    {
+        printf("usage: %s [--level A|B|C] [--minutes N] [--seed N] [--rate HZ] [--mortal]\n",
+            argv[0]);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    Input::startScript();
+
+    const float deltaTime = 1.0f / options.rate;
+    const long long ticks = (long long) (options.minutes * 60.0f * options.rate);
+
+    std::vector<float> tickMicros;
+    tickMicros.reserve((size_t) ticks);
+    long long entitySum = 0;
+    int entityPeak = 0, storePeak = 0, poolPeak = 0, restarts = 0, deaths = 0;
+
+    Scene *level = makeLevel(options.level, options.seed);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (long long tick = 0; tick < ticks; tick++)
+    {
+        Entity *player = level->getState().xochitl;
+        scriptInput(tick, options.rate);
+        if (player != nullptr)
+        {
+            applyMovementKeys(player);
+            if (!options.mortal) player->setCurrentHP(player->getMaxHP());
+        }
+
+        auto tickStart = std::chrono::steady_clock::now();
+        level->update(deltaTime);
+        level->flushRemovedEntities();
+        tickMicros.push_back(std::chrono::duration<float, std::micro>(
+            std::chrono::steady_clock::now() - tickStart).count());
+        Input::endScriptedTick();
+
+        int entities = (int) level->getState().collidableEntities.size();
+        entitySum += entities;
+        entityPeak = std::max(entityPeak, entities);
+        storePeak  = std::max(storePeak, EntityStore::getLiveCount());
+        poolPeak   = std::max(poolPeak, level->getEffectPool().getPeakInUse());
+
+        // the level is over (won, lost or skipped): start it again
+        if (level->getState().nextSceneID >= 0)
+        {
+            if (level->getState().nextSceneID == 7) deaths++;
+            restarts++;
+            level->shutdown();
+            delete level;
+            level = makeLevel(options.level, options.seed);
+        }
+    }
+
+    double wallSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    unsigned long long checksum = stateChecksum();
+
+    level->shutdown();
+    delete level;
+
+    double meanMicros = 0.0;
+    float worstMicros = 0.0f;
+    for (float micros : tickMicros)
+    {
+        meanMicros += micros;
+        worstMicros = std::max(worstMicros, micros);
+    }
+    meanMicros /= tickMicros.size();
+
+    printf("level %c at %d Hz, seed %llu: %.1f simulated minutes, %lld ticks, "
+           "%d restarts (%d deaths)\n", options.level, options.rate,
+           (unsigned long long) options.seed, options.minutes, ticks, restarts, deaths);
+    printf("wall %.2f s: %.0f ticks/s (%.0fx real time)\n", wallSeconds,
+           ticks / wallSeconds, ticks / (wallSeconds * options.rate));
+    printf("tick time: mean %.1f us, p50 %.1f us, p99 %.1f us, max %.1f us\n",
+           meanMicros, percentile(tickMicros, 0.50), percentile(tickMicros, 0.99),
+           worstMicros);
+    printf("entities: mean %.0f, peak %d collidable; peak %d store slots, "
+           "%d pooled effects\n", (double) entitySum / ticks, entityPeak, storePeak,
+           poolPeak);
+    printf("state checksum %016llx\n", checksum);
+    return 0;
+}
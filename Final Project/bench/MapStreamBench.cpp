@@ -0,0 +1,163 @@
+/**
+* Streaming benchmark for chunked map files.
+*
+* Writes a 4096 x 4096 tile world to a temporary .cmap, opens it as a streamed
+* Map and sweeps a 1600 x 800 view across it, calling Map::stream once per
+* frame the way main does. Reports the time spent paging, how many chunks
+* went in and out, and what stayed resident (the Map's own count and, on
+* Linux, the process RSS) against the 64 MB the same world costs as a level
+* array.
+*
+* Every frame also probes isSolidTileAt on screen, and a second pass probes
+* random tiles anywhere in the world, comparing each answer with the
+* generator: tiles read from resident chunks and straight from the file must
+* agree. The second pass runs after the RSS figure is taken, since the file
+* pages it touches are clean page cache rather than anything the Map keeps.
+* No window is opened, so nothing is baked; the resident figures are tile
+* copies only.
+*
+* Build and run with `make bench`.
+**/
+
+#include "../CS3113/Map.h"
+#include <chrono>
+#include <cstdio>
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+static const int   WORLD_TILES    = 4096;
+static const float TILE_DIMENSION = 25.0f;
+static const int   FRAMES         = 3000;
+static const char *MAP_PATH       = "map_stream_bench.cmap";
+
+static unsigned int hashTile(int column, int row)
+{
+    unsigned int h = (unsigned int) column * 73856093u ^ (unsigned int) row * 19349663u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    return h ^ (h >> 15);
+}
+
+// rolling ground across the lower half, sparse platforms in the sky; tile 30
+// is the decoration Map treats as passable
+static unsigned int generatedTile(int column, int row)
+{
+    int ground = WORLD_TILES / 2 + (int) (60.0f * sinf(column * 0.01f));
+    unsigned int h = hashTile(column, row);
+
+    if (row >= ground) return h % 50 == 0 ? 30 : 1 + h % 3;
+    if (row % 48 == 0 && (column / 8) % 5 == 0) return 5;
+    return 0;
+}
+
+static size_t residentSetBytes()
+{
+#if defined(__linux__)
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    unsigned long size = 0, resident = 0;
+    int read = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+    return read == 2 ? resident * (size_t) sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+static bool probeMatches(Map &map, Vector2 position)
+{
+    float xOverlap, yOverlap;
+    int column = (int) floorf((position.x - map.getLeftBoundary()) / TILE_DIMENSION);
+    int row    = (int) floorf((position.y - map.getTopBoundary())  / TILE_DIMENSION);
+    unsigned int tile = generatedTile(column, row);
+
+    return map.isSolidTileAt(position, &xOverlap, &yOverlap) == (tile != 0 && tile != 30);
+}
+
+int main()
+{
+    auto start = std::chrono::steady_clock::now();
+    if (!MapFile::write(MAP_PATH, WORLD_TILES, WORLD_TILES, generatedTile))
+    {
+        printf("could not write %s\n", MAP_PATH);
+        return 1;
+    }
+    double writeMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    size_t rssBefore = residentSetBytes();
+    Map *map = new Map(MAP_PATH, "", TILE_DIMENSION, 16, 4, { 0.0f, 0.0f });
+    // no tileset means no .tiles table; tile 30 is the floor probeMatches
+    // expects to be walkable
+    map->setTileFlags(30, 0);
+
+    FILE *file = fopen(MAP_PATH, "rb");
+    fseek(file, 0, SEEK_END);
+    long fileBytes = ftell(file);
+    fclose(file);
+
+    printf("world: %d x %d tiles, %d chunks, file %.1f MB (written in %.0f ms)\n",
+        map->getMapColumns(), map->getMapRows(), map->getChunkCount(),
+        fileBytes / (1024.0 * 1024.0), writeMs);
+    printf("as a level array: %.1f MB\n\n",
+        (double) WORLD_TILES * WORLD_TILES * sizeof(unsigned int) / (1024.0 * 1024.0));
+
+    // serpentine sweep, fast enough to cross the world several times
+    Rectangle view = { map->getLeftBoundary(), map->getTopBoundary(), 1600.0f, 800.0f };
+    float stepX = 360.0f;
+    int mismatches = 0, peakResident = 0;
+    size_t peakRss = 0;
+    double totalUs = 0.0, worstUs = 0.0;
+
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        view.x += stepX;
+        if (view.x < map->getLeftBoundary() || view.x + view.width > map->getRightBoundary())
+        {
+            stepX = -stepX;
+            view.x += 2.0f * stepX;
+            view.y += 2000.0f;
+            if (view.y + view.height > map->getBottomBoundary()) view.y = map->getTopBoundary();
+        }
+
+        auto tick = std::chrono::steady_clock::now();
+        map->stream(view);
+        double us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - tick).count();
+        totalUs += us;
+        if (us > worstUs) worstUs = us;
+
+        unsigned int h = hashTile(frame, 7);
+        Vector2 probe = { view.x + h % 1600, view.y + (h >> 12) % 800 };
+        if (!probeMatches(*map, probe)) mismatches++;
+
+        if (map->getResidentChunks() > peakResident) peakResident = map->getResidentChunks();
+        size_t rss = residentSetBytes();
+        if (rss > peakRss) peakRss = rss;
+    }
+
+    printf("%d frames: stream avg %.1f us, worst %.1f us\n", FRAMES, totalUs / FRAMES, worstUs);
+    printf("paged in %d / out %d, peak resident %d chunks (%.1f KB of tiles)\n",
+        map->getPageIns(), map->getPageOuts(), peakResident,
+        map->getResidentBytes() / 1024.0);
+    if (peakRss > 0)
+        printf("process RSS growth after open: %.1f MB\n",
+            (peakRss - (rssBefore < peakRss ? rssBefore : peakRss)) / (1024.0 * 1024.0));
+
+    // mostly chunks that are not resident, so these read the file directly
+    for (int probe = 0; probe < FRAMES; probe++)
+    {
+        unsigned int h = hashTile(probe, 11);
+        Vector2 position = {
+            map->getLeftBoundary() + h % (int) (WORLD_TILES * TILE_DIMENSION),
+            map->getTopBoundary() + hashTile(h, probe) % (int) (WORLD_TILES * TILE_DIMENSION)
+        };
+        if (!probeMatches(*map, position)) mismatches++;
+    }
+    printf("solidity probes: %d mismatches\n", mismatches);
+
+    delete map;
+    remove(MAP_PATH);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+/**
+* Micro-benchmark for the projectile integration kernels.
+*
+* "per-object" is the scalar path every projectile took before it was bulk
+* integrated: one Entity::update call each. The other columns run
+* EntityStore::integrate over the same projectiles with each kernel this CPU
+* supports (scalar, SSE2, AVX2). Lifetimes are staggered so projectiles keep
+* expiring through the run, which exercises the expiry mask.
+*
+* Every kernel's final positions, frames and active flags are compared with
+* the per-object run, and the expiries it reported with the number of
+* projectiles that went inactive. No window is opened; textures are never
+* loaded.
+*
+* Build and run with `make bench`.
+**/
+
+#include "../CS3113/Entity.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+static const float TICK  = 1.0f / 60.0f;
+static const int   TICKS = 120;
+
+static const std::map<Direction, std::vector<int>> ATLAS_FRAMES = {
+    { LEFT,  { 0, 1, 2, 3, 4, 5 } },
+    { UP,    { 0, 1, 2, 3, 4, 5 } },
+    { RIGHT, { 0, 1, 2, 3, 4, 5 } },
+    { DOWN,  { 0, 1, 2, 3, 4, 5 } },
+};
+
+// set up like LevelC's blood bullets, with lifetimes between 0.5s and 2.4s
+static void fire(std::vector<Entity*> &projectiles, bool bulk)
+{
+    int walkSet = AnimationClips::internWalkSet(ATLAS_FRAMES);
+
+    for (size_t i = 0; i < projectiles.size(); i++)
+    {
+        Entity *projectile = projectiles[i];
+        float angle = i * 0.61803f;
+
+        projectile->respawn({ 0.0f, 0.0f }, { 15.0f, 15.0f }, "", ATLAS,
+            { 6, 10 }, walkSet, EFFECT);
+        projectile->setIsEffect(true);
+        projectile->setMovement({ cosf(angle), sinf(angle) });
+        projectile->setSpeed(250);
+        projectile->setFrameSpeed(0.03f);
+        projectile->setLifetime(0.5f + (i % 97) * 0.02f);
+        projectile->setBulkIntegrated(bulk);
+    }
+}
+
+static std::vector<Entity*> makeProjectiles(int count)
+{
+    std::vector<Entity*> projectiles;
+    projectiles.reserve(count);
+    for (int i = 0; i < count; i++) projectiles.push_back(new Entity());
+    return projectiles;
+}
+
+static double elapsedMicros(std::chrono::steady_clock::time_point start)
+{
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+static int countMismatches(const std::vector<Entity*> &a, const std::vector<Entity*> &b)
+{
+    int mismatches = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        Vector2 pa = a[i]->getPosition();
+        Vector2 pb = b[i]->getPosition();
+        if (pa.x != pb.x || pa.y != pb.y ||
+            a[i]->getCurrentFrameIndex() != b[i]->getCurrentFrameIndex() ||
+            a[i]->isActive() != b[i]->isActive())
+            mismatches++;
+    }
+    return mismatches;
+}
+
+int main()
+{
+    const int counts[] = { 1000, 10000, 50000, 100000 };
+    const EntityStore::Kernel kernels[] = {
+        EntityStore::SCALAR, EntityStore::SSE2, EntityStore::AVX2
+    };
+    const EntityStore::Kernel detected = EntityStore::getKernel();
+
+    printf("runtime kernel: %s\n\n", EntityStore::getKernelName(detected));
+    printf("%11s %14s", "projectiles", "per-object us");
+    for (EntityStore::Kernel kernel : kernels)
+        printf(" %10s us", EntityStore::getKernelName(kernel));
+    printf("\n");
+
+    for (int count : counts)
+    {
+        std::vector<Entity*> reference = makeProjectiles(count);
+        std::vector<Entity*> bulk      = makeProjectiles(count);
+
+        fire(reference, false);
+        int referenceExpired = 0;
+        double perObject = 0.0;
+        for (int t = 0; t < TICKS; t++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (Entity *projectile : reference)
+            {
+                if (!projectile->isActive()) continue; // flushed in the game
+                projectile->update(TICK, nullptr, nullptr, EntityView());
+            }
+            perObject += elapsedMicros(start);
+        }
+        for (Entity *projectile : reference)
+            if (!projectile->isActive()) referenceExpired++;
+
+        printf("%11d %14.1f", count, perObject / TICKS);
+
+        for (EntityStore::Kernel kernel : kernels)
+        {
+            if (!EntityStore::setKernel(kernel))
+            {
+                printf(" %13s", "n/a");
+                continue;
+            }
+
+            fire(bulk, true);
+            int expired = 0;
+            double integrate = 0.0;
+            for (int t = 0; t < TICKS; t++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                EntityStore::integrate(TICK);
+                integrate += elapsedMicros(start);
+                expired += EntityStore::getExpiredCount();
+            }
+            printf(" %13.1f", integrate / TICKS);
+
+            int mismatches = countMismatches(reference, bulk);
+            if (mismatches > 0 || expired != referenceExpired)
+                printf(" (%s: %d differ, %d vs %d expired)",
+                    EntityStore::getKernelName(kernel), mismatches, expired,
+                    referenceExpired);
+        }
+        printf("\n");
+
+        EntityStore::setKernel(detected);
+        for (Entity *projectile : reference) delete projectile;
+        for (Entity *projectile : bulk)      delete projectile;
+    }
+
+    return 0;
+}
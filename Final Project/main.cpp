@@ -18,6 +18,13 @@
 #include "CS3113/wonScene.h"
 #include "CS3113/MenuScene.h"
 #include "CS3113/ShaderProgram.h"
+#include "CS3113/TextureCache.h"
+#include "CS3113/SpriteBatch.h"
+#include "CS3113/AllocationCounter.h"
+#include "CS3113/SimulationClock.h"
+#include "CS3113/AssetLoader.h"
+#include "CS3113/MusicPlayer.h"
+#include <ctime>
 
 // Global Constants
 constexpr int SCREEN_WIDTH     = 1600,
@@ -26,12 +33,26 @@ constexpr int SCREEN_WIDTH     = 1600,
               NUMBER_OF_LEVELS = 9;
 
 constexpr Vector2 ORIGIN = { SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 };
-constexpr float FIXED_TIMESTEP = 1.0f / 60.0f;
+
+// Simulation rates F5 cycles through, independent of the render FPS
+constexpr int SIMULATION_RATES[] = { 60, 120, 240 };
+constexpr int SIMULATION_RATE_COUNT = 3;
+
+// Main-thread time per frame for uploading prefetched textures to the GPU
+constexpr double ASSET_UPLOAD_BUDGET = 0.002;
 
 // Global Variables
 AppStatus gAppStatus   = RUNNING;
-float gPreviousTicks   = 0.0f,
-      gTimeAccumulator = 0.0f;
+double gPreviousTicks  = 0.0;
+
+SimulationClock gSimulationClock(SIMULATION_RATES[0]);
+int gSimulationRateIndex = 0;
+// Camera target before the latest tick, and the scene it belongs to, so
+// render() can blend the camera along with the entities
+Vector2 gPreviousCameraTarget = { 0.0f, 0.0f };
+Scene *gSnapshotScene = nullptr;
+// Every scene is seeded with this, so a run can be replayed from it
+uint64_t gRunSeed = 0;
 
 Scene *gCurrentScene = nullptr;
 std::vector<Scene*> gLevels = {};
@@ -46,10 +67,11 @@ LoseScene *gLoseScene = nullptr;
 WonScene *gWonScene = nullptr;
 MenuScene *gMenuScene = nullptr;
 
-Music bgm;
 ShaderProgram gShader;
 Vector2 gLightPosition = { 0.0f, 0.0f };
-Sound gNextLevelSound = {0};
+int  gNextLevelSound = VoicePool::NO_SOUND;
+bool gShowDebugStats = false;
+int  gAllocationsLastTick = 0;
 
 // Function Declarations
 void switchToScene(Scene *scene);
@@ -57,6 +79,7 @@ void initialise();
 void processInput();
 void update();
 void render();
+void renderDebugStats();
 void shutdown();
 
 void switchToScene(Scene *scene)
@@ -64,13 +87,23 @@ void switchToScene(Scene *scene)
     if (gCurrentScene != nullptr) gCurrentScene->shutdown();
     
     bool isGoingToLoseScene = (scene == gLoseScene);
-    if (gCurrentScene != nullptr && gNextLevelSound.frameCount > 0 && !isGoingToLoseScene)
+    if (gCurrentScene != nullptr && !isGoingToLoseScene)
     {
-        PlaySound(gNextLevelSound);
+        VoicePool::play(gNextLevelSound);
     }
-    
+
+    // Levels crossfade to their own track; every other scene shares this one
+    bool isLevelABC = (scene == gLevelA || scene == gLevelB || scene == gLevelC);
+    if (!isLevelABC) MusicPlayer::play("assets/bgm.wav", 0.33f);
+
     gCurrentScene = scene;
+    gCurrentScene->setSeed(gRunSeed);
     gCurrentScene->initialise();
+    gSnapshotScene = nullptr; // nothing to blend the new camera from
+
+    // Only now drop what the old scene used, so sheets shared by both scenes
+    // stay resident across the switch instead of being reloaded
+    TextureCache::purge();
 }
 
 void initialiseScene() {
@@ -103,17 +136,26 @@ void initialise()
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Vampire Survivors Clone - Survive 2 Minutes!");
     InitAudioDevice();
     SetTraceLogLevel(LOG_WARNING);
+    gRunSeed = (uint64_t) time(nullptr);
+
+    // One mapped archive instead of the loose files, if `make pack` made one
+    openAssetPack("assets.pak");
+
+    // Level A is the first one played; decode it while the menu is up
+    AssetLoader::start();
+    AssetLoader::prefetch(LevelA::getAssetManifest());
     
     gShader.load("assets/lighting.vs", "assets/lighting.fs");
-    gNextLevelSound = LoadSound("assets/nextLevel.wav");
-    SetSoundVolume(gNextLevelSound, 0.5f);
+    gNextLevelSound = VoicePool::load("assets/nextLevel.wav",
+        { 1, 0.0f, PRIORITY_CRITICAL, 0.5f });
     
+    MusicPlayer::start();
     initialiseScene();
     
-    bgm = LoadMusicStream("assets/bgm.wav");
-    SetMusicVolume(bgm, 0.33f);
-    PlayMusicStream(bgm);
     SetTargetFPS(FPS);
+
+    // loading is not simulation time
+    gPreviousTicks = GetTime();
 }
 
 void processInput() 
@@ -122,18 +164,25 @@ void processInput()
     {
         gCurrentScene->getState().xochitl->resetMovement();
 
-        if (IsKeyDown(KEY_A)) gCurrentScene->getState().xochitl->moveLeft();
-        if (IsKeyDown(KEY_D)) gCurrentScene->getState().xochitl->moveRight();
-        if (IsKeyDown(KEY_W)) gCurrentScene->getState().xochitl->moveUp();
-        if (IsKeyDown(KEY_S)) gCurrentScene->getState().xochitl->moveDown();
+        if (Input::isKeyDown(KEY_A)) gCurrentScene->getState().xochitl->moveLeft();
+        if (Input::isKeyDown(KEY_D)) gCurrentScene->getState().xochitl->moveRight();
+        if (Input::isKeyDown(KEY_W)) gCurrentScene->getState().xochitl->moveUp();
+        if (Input::isKeyDown(KEY_S)) gCurrentScene->getState().xochitl->moveDown();
 
         if (GetLength(gCurrentScene->getState().xochitl->getMovement()) > 1.0f) 
             gCurrentScene->getState().xochitl->normaliseMovement();
     }
 
-    if (IsKeyPressed(KEY_Q) || WindowShouldClose()) gAppStatus = TERMINATED;
+    if (Input::isKeyPressed(KEY_Q) || WindowShouldClose()) gAppStatus = TERMINATED;
+    if (Input::isKeyPressed(KEY_F3)) gShowDebugStats = !gShowDebugStats;
+    if (Input::isKeyPressed(KEY_F4)) Map::setLiveRendering(!Map::isLiveRendering());
+    if (Input::isKeyPressed(KEY_F5))
+    {
+        gSimulationRateIndex = (gSimulationRateIndex + 1) % SIMULATION_RATE_COUNT;
+        gSimulationClock.setRate(SIMULATION_RATES[gSimulationRateIndex]);
+    }
     
-    if (IsKeyPressed(KEY_R)) {
+    if (Input::isKeyPressed(KEY_R)) {
         bool isLoseOrWinScene = (gCurrentScene == gLoseScene || gCurrentScene == gWonScene);
         if (!isLoseOrWinScene) {
             if (gCurrentScene != nullptr) {
@@ -163,38 +212,34 @@ void processInput()
 
 void update() 
 {
-    float ticks = (float) GetTime();
-    float deltaTime = ticks - gPreviousTicks;
+    double ticks = GetTime();
+    float deltaTime = (float) (ticks - gPreviousTicks);
     gPreviousTicks  = ticks;
 
-    deltaTime += gTimeAccumulator; 
+    // at most the clock's substep budget; a longer hitch just slows the game
+    int steps = gSimulationClock.advance(deltaTime);
 
-    if (deltaTime < FIXED_TIMESTEP)
+    for (int step = 0; step < steps; step++)
     {
-        gTimeAccumulator = deltaTime;
-        return;
-    }
+        // the state render() blends from if this turns out to be the last step
+        EntityStore::snapshot();
+        gPreviousCameraTarget = gCurrentScene->getState().camera.target;
+        gSnapshotScene = gCurrentScene;
 
-    while (deltaTime >= FIXED_TIMESTEP)
-    {
-        bool isLevelABC = (gCurrentScene == gLevelA || gCurrentScene == gLevelB || gCurrentScene == gLevelC);
-        if (!isLevelABC)
-        {
-            UpdateMusicStream(bgm);
-            if (IsMusicStreamPlaying(bgm) == false)
-            {
-                PlayMusicStream(bgm);
-            }
-        }
-        gCurrentScene->update(FIXED_TIMESTEP);
+        unsigned long long allocationsBefore = getAllocationCount();
+        gCurrentScene->update(gSimulationClock.getStep());
+        gCurrentScene->flushRemovedEntities();
+        gAllocationsLastTick = (int) (getAllocationCount() - allocationsBefore);
         
         if (gCurrentScene->getState().xochitl != nullptr)
         {
             gLightPosition = gCurrentScene->getState().xochitl->getPosition();
         }
-        
-        deltaTime -= FIXED_TIMESTEP;
     }
+    EntityStore::blend = gSimulationClock.getBlend();
+
+    // once per frame rather than per tick: uploads are not simulation
+    AssetLoader::upload(ASSET_UPLOAD_BUDGET);
 
     int nextID = gCurrentScene->getState().nextSceneID;
     
@@ -237,10 +282,23 @@ void update()
 
 void render()
 {
+    // entities draw between the last two ticks, so the camera does too
+    Camera2D camera = gCurrentScene->getState().camera;
+    if (gSnapshotScene == gCurrentScene)
+        camera.target = Vector2Lerp(gPreviousCameraTarget, camera.target, EntityStore::blend);
+
+    // before any 2D/texture mode: baking switches render targets
+    Map *map = gCurrentScene->getState().map;
+    if (map != nullptr)
+    {
+        map->stream(getVisibleArea(&camera));
+        map->bakeDirtyChunks();
+    }
+
     BeginDrawing();
     
     if (gCurrentScene->getState().xochitl != nullptr) {
-        BeginMode2D(gCurrentScene->getState().camera);
+        BeginMode2D(camera);
     }
     
     gShader.begin();
@@ -248,7 +306,9 @@ void render()
     {
         gShader.setVector2("lightPosition", gLightPosition);
     }
+    SpriteBatch::begin();
     gCurrentScene->render();  
+    SpriteBatch::end();
     gShader.end();
     
     if (gCurrentScene->getState().xochitl != nullptr) {
@@ -256,22 +316,119 @@ void render()
     }
     
     gCurrentScene->renderUI(); 
+    if (gShowDebugStats) renderDebugStats();
     DrawText("Press R to restart | Press Q to quit", GetScreenWidth() - 350, GetScreenHeight() - 25, 14, GRAY);
     
     EndDrawing();
 }
 
+// F3 overlay with engine-side counters (top right, below the timer)
+void renderDebugStats()
+{
+    int x = GetScreenWidth() - 260;
+    int y = 100;
+    const int fontSize = 14;
+    const int lineHeight = 18;
+
+    DrawText("-- DEBUG --", x, y, fontSize, WHITE);
+    y += lineHeight;
+    DrawText(TextFormat("Textures: %d (%.1f MB)", TextureCache::getTextureCount(),
+             TextureCache::getResidentBytes() / (1024.0f * 1024.0f)), x, y, fontSize, LIGHTGRAY);
+    y += lineHeight;
+    DrawText(TextFormat("Atlas: %d pages, %d sheets (%d loose), %d frames",
+             SpriteAtlas::getPageCount(), SpriteAtlas::getSheetCount(),
+             SpriteAtlas::getLooseSheetCount(), SpriteAtlas::getFrameCount()),
+             x, y, fontSize, SpriteAtlas::getLooseSheetCount() == 0 ? LIGHTGRAY : YELLOW);
+    y += lineHeight;
+    DrawText(TextFormat("Texture cache hit/miss: %d / %d", TextureCache::getHits(),
+             TextureCache::getMisses()), x, y, fontSize, LIGHTGRAY);
+    y += lineHeight;
+    DrawText(TextFormat("Heap allocs last tick: %d", gAllocationsLastTick), 
+             x, y, fontSize, gAllocationsLastTick == 0 ? LIGHTGRAY : YELLOW);
+    y += lineHeight;
+    DrawText(TextFormat("Sim: %d Hz (F5), %d steps/frame, %d dropped", 
+             gSimulationClock.getRate(), gSimulationClock.getStepsLastAdvance(),
+             gSimulationClock.getDroppedTicks()), x, y, fontSize, 
+             gSimulationClock.getStepsLastAdvance() < gSimulationClock.getMaxSubsteps() 
+                 ? LIGHTGRAY : YELLOW);
+    y += lineHeight;
+    DrawText(TextFormat("Seed: %llu", (unsigned long long) gRunSeed), x, y, fontSize,
+             LIGHTGRAY);
+    y += lineHeight;
+    DrawText(getAssetPack().isOpen()
+             ? TextFormat("Archive: %d files (%.1f MB) mapped", getAssetPack().getEntryCount(),
+               getAssetPack().getFileBytes() / (1024.0f * 1024.0f))
+             : "Archive: none, loose files", x, y, fontSize, LIGHTGRAY);
+    y += lineHeight;
+    DrawText(TextFormat("Assets: %d decoding, %d to upload, %d uploaded, %.1f MB waves",
+             AssetLoader::getPendingCount(), AssetLoader::getReadyCount(),
+             AssetLoader::getUploadedCount(), AssetLoader::getWaveBytes() / (1024.0f * 1024.0f)),
+             x, y, fontSize, LIGHTGRAY);
+    y += lineHeight;
+    DrawText(TextFormat("Voices: %d / %d, played %d, dropped %d, stolen %d",
+             VoicePool::getActiveVoices(), VoicePool::MAX_ACTIVE_VOICES,
+             VoicePool::getPlayCount(), VoicePool::getDroppedCount(),
+             VoicePool::getStolenCount()), x, y, fontSize,
+             VoicePool::getActiveVoices() < VoicePool::MAX_ACTIVE_VOICES ? LIGHTGRAY : YELLOW);
+    y += lineHeight;
+    DrawText(TextFormat("Music: %s, %d ms buffered, %d decoded, %d underruns",
+             MusicPlayer::getTrack().empty() ? "none" : MusicPlayer::getTrack().c_str(),
+             MusicPlayer::getBufferedFrames() * 1000 / MusicPlayer::SAMPLE_RATE,
+             MusicPlayer::getDecodedTrackCount(), MusicPlayer::getUnderrunCount()),
+             x, y, fontSize, MusicPlayer::getUnderrunCount() == 0 ? LIGHTGRAY : YELLOW);
+
+    y += lineHeight;
+    DrawText(TextFormat("Sprites: %d, draw calls: %d", SpriteBatch::getSpriteCount(),
+             SpriteBatch::getDrawCalls()), x, y, fontSize, LIGHTGRAY);
+    y += lineHeight;
+    DrawText(TextFormat("Texture binds: %d (unsorted %d)", SpriteBatch::getTextureBinds(),
+             SpriteBatch::getUnsortedBinds()), x, y, fontSize, LIGHTGRAY);
+
+    const Map *map = gCurrentScene->getState().map;
+    if (map != nullptr)
+    {
+        y += lineHeight;
+        DrawText(Map::isLiveRendering() ? "Map: live tiles (F4)" 
+                 : TextFormat("Map: %d chunks baked (%.1f MB) (F4)", map->getChunkCount(),
+                   map->getBakedBytes() / (1024.0f * 1024.0f)), x, y, fontSize, LIGHTGRAY);
+        y += lineHeight;
+        DrawText(TextFormat("Map %s drawn/culled: %d / %d", 
+                 Map::isLiveRendering() ? "tiles" : "chunks", map->getDrawnCount(),
+                 map->getCulledCount()), x, y, fontSize, LIGHTGRAY);
+        if (map->isStreamed())
+        {
+            y += lineHeight;
+            DrawText(TextFormat("Map resident: %d chunks (%.1f MB), paged %d in / %d out",
+                     map->getResidentChunks(), map->getResidentBytes() / (1024.0f * 1024.0f),
+                     map->getPageIns(), map->getPageOuts()), x, y, fontSize, LIGHTGRAY);
+        }
+    }
+
+    y += lineHeight;
+    DrawText(TextFormat("Entities drawn/culled: %d / %d", gCurrentScene->getEntitiesDrawn(),
+             gCurrentScene->getEntitiesCulled()), x, y, fontSize, LIGHTGRAY);
+
+    const EntityPool &pool = gCurrentScene->getEffectPool();
+    if (pool.getCapacity() > 0)
+    {
+        y += lineHeight;
+        DrawText(TextFormat("Effect pool: %d / %d (peak %d, full %d)", pool.getInUse(),
+                 pool.getCapacity(), pool.getPeakInUse(), pool.getExhaustedCount()),
+                 x, y, fontSize, LIGHTGRAY);
+    }
+}
+
 void shutdown() 
 {
     for (size_t i = 0; i < gLevels.size(); ++i) delete gLevels[i];
     gLevels.clear();
-    UnloadMusicStream(bgm);
-    if (gNextLevelSound.frameCount > 0)
-    {
-        UnloadSound(gNextLevelSound);
-    }
+    AssetLoader::stop(); // drops its holds, so the purge frees everything
+    TextureCache::purge();
+    MusicPlayer::stop();
+    VoicePool::unload(gNextLevelSound);
     gShader.unload();
     CloseAudioDevice();
+    closeAssetPack(); // only now nothing streams from it any more
     CloseWindow();
 }
 
@@ -0,0 +1,131 @@
+/**
+* Asset packer.
+*
+* Packs every file under an assets directory into one archive (see
+* AssetPack.h) that main maps at startup instead of opening the loose files.
+* Paths are stored as the game asks for them, "assets/..." relative to the
+* game's working directory, so run it from there.
+*
+* Then it reports what was packed (file count, bytes, archive size, the
+* largest files) and each level's working set: the bytes of every sheet,
+* sound and music track its manifest lists, which is what a scene switch
+* into the level reads, and any manifest path the archive does not hold.
+*
+* Usage: asset_packer [assets directory] [archive]
+* Build and run with `make pack` (assets -> assets.pak). Re-run it whenever
+* anything under assets/ changes: a stale archive wins over the loose files.
+**/
+
+#include "../CS3113/LevelA.h"
+#include "../CS3113/LevelB.h"
+#include "../CS3113/LevelC.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static double megabytes(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+// Bytes of the listed files in the archive; missing ones are printed
+static size_t listBytes(const AssetPack &pack, const std::vector<const char*> &paths,
+    int *missing)
+{
+    size_t total = 0;
+
+    for (const char *path : paths)
+    {
+        const unsigned char *data;
+        size_t size;
+        if (pack.find(path, &data, &size)) total += size;
+        else
+        {
+            printf("    missing: %s\n", path);
+            (*missing)++;
+        }
+    }
+
+    return total;
+}
+
+static void reportWorkingSet(const AssetPack &pack, const char *name,
+    const AssetManifest &manifest)
+{
+    std::vector<const char*> sheets;
+    for (const SpriteSheet &sheet : manifest.sheets) sheets.push_back(sheet.path);
+
+    int missing = 0;
+    printf("  %s\n", name);
+    size_t textures = listBytes(pack, sheets, &missing);
+    size_t sounds   = listBytes(pack, manifest.sounds,   &missing);
+    size_t music    = listBytes(pack, manifest.music,    &missing);
+
+    printf("    %zu sheets %.2f MB, %zu sounds %.2f MB, %zu music %.2f MB: "
+           "%.2f MB in %zu files (%d missing)\n",
+           sheets.size(), megabytes(textures), manifest.sounds.size(),
+           megabytes(sounds), manifest.music.size(), megabytes(music),
+           megabytes(textures + sounds + music),
+           sheets.size() + manifest.sounds.size() + manifest.music.size(),
+           missing);
+}
+
+int main(int argc, char **argv)
+{
+    const char *directory = argc > 1 ? argv[1] : "assets";
+    const char *archive   = argc > 2 ? argv[2] : "assets.pak";
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    FilePathList files = LoadDirectoryFilesEx(directory, nullptr, true);
+    std::vector<std::string> paths;
+    for (unsigned int i = 0; i < files.count; i++)
+    {
+        // .DS_Store and friends, and an archive written inside the directory
+        if (GetFileName(files.paths[i])[0] == '.') continue;
+        if (strcmp(files.paths[i], archive) == 0) continue;
+        paths.push_back(files.paths[i]);
+    }
+    UnloadDirectoryFiles(files);
+
+    // sorted, so the same assets always give the same archive
+    std::sort(paths.begin(), paths.end());
+
+    if (paths.empty() || !AssetPack::write(archive, paths))
+    {
+        printf("could not pack %s into %s\n", directory, archive);
+        return 1;
+    }
+
+    AssetPack pack;
+    if (!pack.open(archive))
+    {
+        printf("%s was written but does not open\n", archive);
+        return 1;
+    }
+
+    std::vector<std::pair<size_t, const char*>> sizes;
+    size_t total = 0;
+    for (const std::string &path : paths)
+    {
+        const unsigned char *data;
+        size_t size = 0;
+        pack.find(path.c_str(), &data, &size);
+        sizes.push_back(std::make_pair(size, path.c_str()));
+        total += size;
+    }
+    std::sort(sizes.rbegin(), sizes.rend());
+
+    printf("packed %d files from %s/ into %s: %.2f MB of files, %.2f MB archive\n",
+           pack.getEntryCount(), directory, archive, megabytes(total),
+           megabytes(pack.getFileBytes()));
+    printf("startup maps 1 file instead of opening up to %d loose ones\n",
+           pack.getEntryCount());
+
+    printf("largest:\n");
+    for (size_t i = 0; i < sizes.size() && i < 5; i++)
+        printf("  %8.2f MB  %s\n", megabytes(sizes[i].first), sizes[i].second);
+
+    printf("working sets:\n");
+    reportWorkingSet(pack, "Level A", LevelA::getAssetManifest());
+    reportWorkingSet(pack, "Level B", LevelB::getAssetManifest());
+    reportWorkingSet(pack, "Level C", LevelC::getAssetManifest());
+    return 0;
+}
@@ -0,0 +1,258 @@
+/**
+* Sprite atlas packer.
+*
+* Packs every frame a level draws into one or two large page images and
+* writes the frame table (see SpriteAtlas.h) its manifest names. Each sheet
+* in the manifest is cut on its grid, identical frames are stored once, and
+* the frames are shelf-packed, tallest first, onto pages no larger than the
+* page size. A level that loads the table draws all of its sprites and tiles
+* from those pages, so the sprite batch binds one or two textures a frame
+* instead of one per sheet.
+*
+* Frames keep their exact source rectangles: a grid that does not divide its
+* sheet evenly has fractional frames, which are copied with the texels
+* around them and keep the same sub-texel offset on the page.
+*
+* Usage: atlas_packer [page size]
+* Build and run with `make atlas` (writes assets/atlas/), before `make pack`.
+* Re-run it whenever a sheet or a manifest changes: a stale atlas wins over
+* the loose sheets.
+**/
+
+#include "../CS3113/LevelA.h"
+#include "../CS3113/LevelB.h"
+#include "../CS3113/LevelC.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Transparent texels around every frame, so sampling at a frame's edge never
+// picks up its neighbour
+static const int PADDING = 2;
+
+// Texels copied from one sheet onto a page; frames with the same texels
+// share one region
+struct Region
+{
+    int image;
+    int x, y, width, height;
+    unsigned long long hash;
+    int page, pageX, pageY;
+};
+
+static unsigned long long hashRegion(const Image &image, const Region &region)
+{
+    unsigned long long hash = 1469598103934665603ULL;
+    hash = (hash ^ (unsigned int) region.width)  * 1099511628211ULL;
+    hash = (hash ^ (unsigned int) region.height) * 1099511628211ULL;
+
+    for (int row = 0; row < region.height; row++)
+    {
+        const unsigned char *texel = (const unsigned char *) image.data +
+            ((size_t) (region.y + row) * image.width + region.x) * 4;
+
+        for (int i = 0; i < region.width * 4; i++)
+        {
+            hash ^= texel[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+static bool sameTexels(const std::vector<Image> &images, const Region &a, const Region &b)
+{
+    if (a.hash != b.hash || a.width != b.width || a.height != b.height) return false;
+
+    for (int row = 0; row < a.height; row++)
+    {
+        const unsigned char *rowA = (const unsigned char *) images[a.image].data +
+            ((size_t) (a.y + row) * images[a.image].width + a.x) * 4;
+        const unsigned char *rowB = (const unsigned char *) images[b.image].data +
+            ((size_t) (b.y + row) * images[b.image].width + b.x) * 4;
+        if (memcmp(rowA, rowB, (size_t) a.width * 4) != 0) return false;
+    }
+
+    return true;
+}
+
+static bool packLevel(const char *name, const AssetManifest &manifest, int pageSize)
+{
+    if (manifest.atlas == nullptr)
+    {
+        printf("%s: its manifest names no atlas\n", name);
+        return false;
+    }
+
+    std::vector<Image>  images;
+    std::vector<Region> regions;
+    std::vector<int>    regionOfFrame;
+    std::vector<Rectangle> rects;
+    AtlasTable table;
+
+    for (const SpriteSheet &sheet : manifest.sheets)
+    {
+        // the loose file, never an archived copy that may be stale
+        Image image = LoadImage(sheet.path);
+        if (image.data == nullptr)
+        {
+            printf("%s: cannot read %s, left loose\n", name, sheet.path);
+            continue;
+        }
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        images.push_back(image);
+
+        SpriteAtlas::cutGrid((float) image.width, (float) image.height,
+            sheet.rows, sheet.cols, &rects);
+        table.sheets.push_back({ sheet.path, sheet.rows, sheet.cols,
+            (int) table.frames.size(), (int) rects.size() });
+
+        for (const Rectangle &rect : rects)
+        {
+            // every texel the (possibly fractional) rectangle touches
+            Region region = { (int) images.size() - 1, 0, 0, 0, 0, 0, 0, 0, 0 };
+            region.x      = (int) floorf(rect.x);
+            region.y      = (int) floorf(rect.y);
+            region.width  = std::min((int) ceilf(rect.x + rect.width),  image.width)  - region.x;
+            region.height = std::min((int) ceilf(rect.y + rect.height), image.height) - region.y;
+            region.hash   = hashRegion(image, region);
+
+            int index = 0;
+            while (index < (int) regions.size() && !sameTexels(images, regions[index], region))
+                index++;
+            if (index == (int) regions.size()) regions.push_back(region);
+
+            regionOfFrame.push_back(index);
+            table.frames.push_back({ 0, { rect.x - region.x, rect.y - region.y,
+                                          rect.width, rect.height } });
+        }
+    }
+
+    // shelves of similar height waste the least when filled tallest first
+    std::vector<int> order;
+    for (int i = 0; i < (int) regions.size(); i++) order.push_back(i);
+    std::sort(order.begin(), order.end(), [&regions](int a, int b)
+    {
+        if (regions[a].height != regions[b].height) return regions[a].height > regions[b].height;
+        if (regions[a].width  != regions[b].width)  return regions[a].width  > regions[b].width;
+        return a < b;
+    });
+
+    std::vector<int> pageWidths(1, 0), pageHeights(1, 0);
+    int x = PADDING, y = PADDING, shelfHeight = 0;
+    size_t packedTexels = 0;
+
+    for (int index : order)
+    {
+        Region &region = regions[index];
+        if (region.width + 2 * PADDING > pageSize || region.height + 2 * PADDING > pageSize)
+        {
+            printf("%s: a %dx%d frame does not fit a %d page\n", name, region.width,
+                   region.height, pageSize);
+            for (Image &image : images) UnloadImage(image);
+            return false;
+        }
+
+        if (x + region.width + PADDING > pageSize)
+        {
+            x = PADDING;
+            y += shelfHeight + PADDING;
+            shelfHeight = 0;
+        }
+        if (y + region.height + PADDING > pageSize)
+        {
+            pageWidths.push_back(0);
+            pageHeights.push_back(0);
+            x = y = PADDING;
+            shelfHeight = 0;
+        }
+
+        region.page  = (int) pageWidths.size() - 1;
+        region.pageX = x;
+        region.pageY = y;
+        x += region.width + PADDING;
+        shelfHeight = std::max(shelfHeight, region.height);
+        pageWidths[region.page]  = std::max(pageWidths[region.page],  x);
+        pageHeights[region.page] = std::max(pageHeights[region.page], y + region.height + PADDING);
+        packedTexels += (size_t) region.width * region.height;
+    }
+
+    std::string stem = manifest.atlas;
+    stem = stem.substr(0, stem.rfind('.'));
+    bool ok = true;
+    size_t pageTexels = 0;
+
+    for (int page = 0; page < (int) pageWidths.size() && ok; page++)
+    {
+        Image image = GenImageColor(pageWidths[page], pageHeights[page], BLANK);
+
+        for (const Region &region : regions)
+        {
+            if (region.page != page) continue;
+
+            const Image &sheet = images[region.image];
+            for (int row = 0; row < region.height; row++)
+                memcpy((unsigned char *) image.data +
+                           ((size_t) (region.pageY + row) * image.width + region.pageX) * 4,
+                       (const unsigned char *) sheet.data +
+                           ((size_t) (region.y + row) * sheet.width + region.x) * 4,
+                       (size_t) region.width * 4);
+        }
+
+        std::string path = stem + "_" + std::to_string(page) + ".png";
+        ok = ExportImage(image, path.c_str());
+        if (!ok) printf("%s: could not write %s\n", name, path.c_str());
+        table.pages.push_back(path);
+        pageTexels += (size_t) image.width * image.height;
+        UnloadImage(image);
+    }
+
+    for (size_t frame = 0; frame < table.frames.size(); frame++)
+    {
+        const Region &region = regions[regionOfFrame[frame]];
+        table.frames[frame].page = region.page;
+        table.frames[frame].source.x += region.pageX;
+        table.frames[frame].source.y += region.pageY;
+    }
+
+    for (Image &image : images) UnloadImage(image);
+
+    AtlasTable check;
+    ok = ok && SpriteAtlas::writeTable(manifest.atlas, table) &&
+         SpriteAtlas::readTable(manifest.atlas, &check) &&
+         check.frames.size() == table.frames.size();
+    if (!ok)
+    {
+        printf("%s: could not write %s\n", name, manifest.atlas);
+        return false;
+    }
+
+    printf("%s: %zu of %zu sheets, %zu frames (%zu unique) -> %zu pages, %.0f%% filled\n",
+           name, table.sheets.size(), manifest.sheets.size(), table.frames.size(),
+           regions.size(), table.pages.size(), 100.0 * packedTexels / pageTexels);
+    for (size_t page = 0; page < table.pages.size(); page++)
+        printf("    %s  %dx%d\n", table.pages[page].c_str(), pageWidths[page], pageHeights[page]);
+    printf("    texture binds with every sheet on screen: %zu -> %zu\n",
+           manifest.sheets.size(), table.pages.size() + manifest.sheets.size() -
+           table.sheets.size());
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int pageSize = argc > 1 ? atoi(argv[1]) : 2048;
+    if (pageSize < 64)
+    {
+        printf("usage: atlas_packer [page size, at least 64]\n");
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    bool ok = packLevel("Level A", LevelA::getAssetManifest(), pageSize);
+    ok = packLevel("Level B", LevelB::getAssetManifest(), pageSize) && ok;
+    ok = packLevel("Level C", LevelC::getAssetManifest(), pageSize) && ok;
+    return ok ? 0 : 1;
+}